@@ -1,26 +1,37 @@
 from fontTools.ttLib import TTFont
 import sys
 
+# usage: extract.py entypo.ttf > ../quickgui/Icons.h
+
 icons = {}
-icons_raw = {}
 with TTFont(sys.argv[1], 0, ignoreDecompileErrors=True) as font:
     for x in font["cmap"].tables:
         for (code, name) in x.cmap.items():
-            icons[name] = hex(code)[2:].upper()
-            icons_raw[name] = code
+            # ascii codes are plain text, not icons
+            if code < 0x80:
+                continue
+            if name not in icons or code < icons[name]:
+                icons[name] = code
+
+# Icons.cpp binary searches the codepoint table, so it has to be sorted
+icons = sorted(icons.items(), key=lambda icon: icon[1])
+
+fp = sys.stdout
+fp.write('#pragma once\n\n')
+fp.write('#include <cstdint>\n')
+fp.write('#include <string_view>\n\n')
+fp.write('// UTF-8 encoding of an icon codepoint, empty if the codepoint isn\'t one of the icons below.\n')
+fp.write('// the strings are static, built at compile time in Icons.cpp.\n')
+fp.write('std::string_view iconUTF8(uint32_t cp);\n\n')
+
+for (name, code) in icons:
+    fp.write('#define IC_%s 0x%X\n' % (name.upper(), code))
+fp.write('\n')
 
-with open('Icons.h', 'w') as fp:
-    fp.write('#ifndef ICONS_H\n')
-    fp.write('#define ICONS_H\n\n')
-    for name in icons:
-        fp.write('#define IC_%s 0x%s\n' % (name.upper(), icons[name]))
-    fp.write('\n')
-    fp.write('#endif\n')
+fp.write('// every icon codepoint, sorted\n')
+fp.write('constexpr uint32_t iconCodepoints[] = {\n')
+for (name, code) in icons:
+    fp.write('\tIC_%s,\n' % name.upper())
+fp.write('};\n\n')
 
-    # write glyphs in a list
-    fp.write('\n')
-    fp.write('const uint16_t icons[] = {\n')
-    for name in icons:
-        fp.write('    IC_%s,\n' % name.upper())
-    fp.write('};\n')
-    
+fp.write('#define ICON(x) iconUTF8(x)\n')
@@ -30,6 +30,21 @@
 #include "stb_image.h"
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NVG_SIMD_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// msvc compiles any intrinsic, gcc and clang only inside functions built for the instruction set
+#if defined(__GNUC__) || defined(__clang__)
+#define NVG_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define NVG_TARGET_AVX2
+#endif
+
 #ifdef _MSC_VER
 #pragma warning(disable: 4100)  // unreferenced formal parameter
 #pragma warning(disable: 4127)  // conditional expression is constant
@@ -299,6 +314,7 @@ NVGcontext* nvgCreateInternal(NVGparams* params)
 	memset(ctx, 0, sizeof(NVGcontext));
 
 	ctx->params = *params;
+	nvgSimdLevel(); // picks the kernels while only this thread uses nanovg
 	for (i = 0; i < NVG_MAX_FONTIMAGES; i++)
 		ctx->fontImages[i] = 0;
 
@@ -425,6 +441,35 @@ void nvgEndFrame(NVGcontext* ctx)
 	}
 }
 
+size_t nvgMemoryUsage(NVGcontext* ctx)
+{
+	FONScontext* fs = ctx->fs;
+	NVGpathCache* cache = ctx->cache;
+	size_t bytes = 0;
+	int i;
+
+	bytes += sizeof(NVGcontext);
+	bytes += (size_t)ctx->ccommands * sizeof(float);
+	bytes += sizeof(NVGpathCache);
+	bytes += (size_t)cache->cpoints * sizeof(NVGpoint);
+	bytes += (size_t)cache->cpaths * sizeof(NVGpath);
+	bytes += (size_t)cache->cverts * sizeof(NVGvertex);
+
+	bytes += sizeof(FONScontext);
+	bytes += (size_t)fs->params.width * fs->params.height; // atlas copy on the cpu
+	bytes += FONS_SCRATCH_BUF_SIZE;
+	bytes += (size_t)fs->atlas->cnodes * sizeof(FONSatlasNode);
+	bytes += (size_t)fs->cfonts * sizeof(FONSfont*);
+	for (i = 0; i < fs->nfonts; i++) {
+		FONSfont* font = fs->fonts[i];
+		bytes += sizeof(FONSfont);
+		bytes += (size_t)font->cglyphs * sizeof(FONSglyph);
+		if (font->freeData) bytes += (size_t)font->dataSize;
+	}
+
+	return bytes;
+}
+
 NVGcolor nvgRGB(unsigned char r, unsigned char g, unsigned char b)
 {
 	return nvgRGBA(r,g,b,255);
@@ -1335,6 +1380,343 @@ static void nvg__tesselateBezier(NVGcontext* ctx,
 	nvg__tesselateBezier(ctx, x1234,y1234, x234,y234, x34,y34, x4,y4, level+1, type);
 }
 
+// Kernels for the hot loops of the tesselator: curve flattening, segment directions and plain
+// (unbeveled) vertex expansion. The vector versions do the same float operations in the same
+// order as the scalar ones, so every level produces identical vertices.
+
+// segments from `from` on, the last one closes back to the first point
+static void nvg__segmentsFrom(NVGpoint* pts, int from, int count, float* bounds)
+{
+	int i;
+	for (i = from; i < count; i++) {
+		NVGpoint* p0 = &pts[i];
+		NVGpoint* p1 = &pts[i+1 < count ? i+1 : 0];
+		p0->dx = p1->x - p0->x;
+		p0->dy = p1->y - p0->y;
+		p0->len = nvg__normalize(&p0->dx, &p0->dy);
+		bounds[0] = nvg__minf(bounds[0], p0->x);
+		bounds[1] = nvg__minf(bounds[1], p0->y);
+		bounds[2] = nvg__maxf(bounds[2], p0->x);
+		bounds[3] = nvg__maxf(bounds[3], p0->y);
+	}
+}
+
+static void nvg__segmentsScalar(NVGpoint* pts, int count, float* bounds)
+{
+	nvg__segmentsFrom(pts, 0, count, bounds);
+}
+
+static NVGvertex* nvg__extrudeScalar(NVGvertex* dst, const NVGpoint* pts, int count, float w, float u)
+{
+	int i;
+	for (i = 0; i < count; i++) {
+		nvg__vset(dst, pts[i].x + (pts[i].dmx * w), pts[i].y + (pts[i].dmy * w), u, 1, 0, 0); dst++;
+	}
+	return dst;
+}
+
+static NVGvertex* nvg__extrudePairsScalar(NVGvertex* dst, const NVGpoint* pts, int count,
+										  float lw, float rw, float lu, float ru, float ls, float rs, float t)
+{
+	int i;
+	for (i = 0; i < count; i++) {
+		const NVGpoint* p = &pts[i];
+		nvg__vset(dst, p->x + (p->dmx * lw), p->y + (p->dmy * lw), lu, 1, ls, t); dst++;
+		nvg__vset(dst, p->x - (p->dmx * rw), p->y - (p->dmy * rw), ru, 1, rs, t); dst++;
+	}
+	return dst;
+}
+
+#ifdef NVG_SIMD_X86
+
+static __m128 nvg__loadXY2(const NVGpoint* a, const NVGpoint* b)
+{
+	__m128 v = _mm_loadl_pi(_mm_setzero_ps(), (const __m64*)&a->x);
+	return _mm_loadh_pi(v, (const __m64*)&b->x);
+}
+
+static void nvg__storeSegments4(NVGpoint* pts, __m128 dx, __m128 dy, __m128 len)
+{
+	__m128 lo = _mm_unpacklo_ps(dx, dy);
+	__m128 hi = _mm_unpackhi_ps(dx, dy);
+	float l[4];
+	_mm_storeu_ps(l, len);
+	_mm_storel_pi((__m64*)&pts[0].dx, lo);
+	_mm_storeh_pi((__m64*)&pts[1].dx, lo);
+	_mm_storel_pi((__m64*)&pts[2].dx, hi);
+	_mm_storeh_pi((__m64*)&pts[3].dx, hi);
+	pts[0].len = l[0];
+	pts[1].len = l[1];
+	pts[2].len = l[2];
+	pts[3].len = l[3];
+}
+
+// nvg__normalize on four lanes, lengths below the threshold leave the direction as it is
+static __m128 nvg__normalize4(__m128* dx, __m128* dy)
+{
+	__m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(*dx, *dx), _mm_mul_ps(*dy, *dy)));
+	__m128 mask = _mm_cmpgt_ps(len, _mm_set1_ps(1e-6f));
+	__m128 scale = _mm_or_ps(_mm_and_ps(mask, _mm_div_ps(_mm_set1_ps(1.0f), len)), _mm_andnot_ps(mask, _mm_set1_ps(1.0f)));
+	*dx = _mm_mul_ps(*dx, scale);
+	*dy = _mm_mul_ps(*dy, scale);
+	return len;
+}
+
+static void nvg__boundsFinish(float* bounds, __m128 bmin, __m128 bmax)
+{
+	// lanes hold x,y,x,y
+	bmin = _mm_min_ps(bmin, _mm_movehl_ps(bmin, bmin));
+	bmax = _mm_max_ps(bmax, _mm_movehl_ps(bmax, bmax));
+	bounds[0] = nvg__minf(bounds[0], _mm_cvtss_f32(bmin));
+	bounds[1] = nvg__minf(bounds[1], _mm_cvtss_f32(_mm_shuffle_ps(bmin, bmin, _MM_SHUFFLE(1,1,1,1))));
+	bounds[2] = nvg__maxf(bounds[2], _mm_cvtss_f32(bmax));
+	bounds[3] = nvg__maxf(bounds[3], _mm_cvtss_f32(_mm_shuffle_ps(bmax, bmax, _MM_SHUFFLE(1,1,1,1))));
+}
+
+static void nvg__segmentsSSE2(NVGpoint* pts, int count, float* bounds)
+{
+	__m128 bmin = _mm_set1_ps(1e6f), bmax = _mm_set1_ps(-1e6f);
+	int i = 0;
+
+	// four segments at a time, the last one wraps around to the first point and is left to the tail
+	for (; i + 4 < count; i += 4) {
+		__m128 a01 = nvg__loadXY2(&pts[i], &pts[i+1]);
+		__m128 a23 = nvg__loadXY2(&pts[i+2], &pts[i+3]);
+		__m128 d01 = _mm_sub_ps(nvg__loadXY2(&pts[i+1], &pts[i+2]), a01);
+		__m128 d23 = _mm_sub_ps(nvg__loadXY2(&pts[i+3], &pts[i+4]), a23);
+		__m128 dx = _mm_shuffle_ps(d01, d23, _MM_SHUFFLE(2,0,2,0));
+		__m128 dy = _mm_shuffle_ps(d01, d23, _MM_SHUFFLE(3,1,3,1));
+		__m128 len = nvg__normalize4(&dx, &dy);
+		nvg__storeSegments4(&pts[i], dx, dy, len);
+
+		bmin = _mm_min_ps(bmin, _mm_min_ps(a01, a23));
+		bmax = _mm_max_ps(bmax, _mm_max_ps(a01, a23));
+	}
+	nvg__boundsFinish(bounds, bmin, bmax);
+	nvg__segmentsFrom(pts, i, count, bounds);
+}
+
+static NVGvertex* nvg__extrudeSSE2(NVGvertex* dst, const NVGpoint* pts, int count, float w, float u)
+{
+	__m128 vw = _mm_set1_ps(w);
+	__m128 uv = _mm_setr_ps(u, 1.0f, 0.0f, 0.0f);
+	__m128 zero = _mm_setzero_ps();
+	int i;
+	for (i = 0; i < count; i++) {
+		__m128 p = _mm_loadl_pi(zero, (const __m64*)&pts[i].x);
+		__m128 dm = _mm_loadl_pi(zero, (const __m64*)&pts[i].dmx);
+		_mm_storeu_ps(&dst->x, _mm_movelh_ps(_mm_add_ps(p, _mm_mul_ps(dm, vw)), uv));
+		_mm_storel_pi((__m64*)&dst->s, zero);
+		dst++;
+	}
+	return dst;
+}
+
+static NVGvertex* nvg__extrudePairsSSE2(NVGvertex* dst, const NVGpoint* pts, int count,
+										float lw, float rw, float lu, float ru, float ls, float rs, float t)
+{
+	// x - dmx*rw is computed as x + dmx*-rw, which rounds the same
+	__m128 vw = _mm_setr_ps(lw, lw, -rw, -rw);
+	__m128 luv = _mm_setr_ps(lu, 1.0f, 0.0f, 0.0f);
+	__m128 ruv = _mm_setr_ps(ru, 1.0f, 0.0f, 0.0f);
+	__m128 lst = _mm_setr_ps(ls, t, 0.0f, 0.0f);
+	__m128 rst = _mm_setr_ps(rs, t, 0.0f, 0.0f);
+	__m128 zero = _mm_setzero_ps();
+	int i;
+	for (i = 0; i < count; i++) {
+		__m128 p = _mm_loadl_pi(zero, (const __m64*)&pts[i].x);
+		__m128 dm = _mm_loadl_pi(zero, (const __m64*)&pts[i].dmx);
+		__m128 v = _mm_add_ps(_mm_movelh_ps(p, p), _mm_mul_ps(_mm_movelh_ps(dm, dm), vw));
+		_mm_storeu_ps(&dst[0].x, _mm_movelh_ps(v, luv));
+		_mm_storel_pi((__m64*)&dst[0].s, lst);
+		_mm_storeu_ps(&dst[1].x, _mm_shuffle_ps(v, ruv, _MM_SHUFFLE(1,0,3,2)));
+		_mm_storel_pi((__m64*)&dst[1].s, rst);
+		dst += 2;
+	}
+	return dst;
+}
+
+// nvg__tesselateBezier with x,y pairs in lanes and an explicit stack instead of recursion
+static void nvg__tesselateBezierSSE2(NVGcontext* ctx,
+									 float x1, float y1, float x2, float y2,
+									 float x3, float y3, float x4, float y4,
+									 int level, int type)
+{
+	struct { __m128 a, b; int level, type; } stack[16];
+	__m128 half = _mm_set1_ps(0.5f);
+	__m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+	__m128 tol = _mm_set_ss(ctx->tessTol);
+	int top = 1;
+
+	stack[0].a = _mm_setr_ps(x1, y1, x2, y2);
+	stack[0].b = _mm_setr_ps(x3, y3, x4, y4);
+	stack[0].level = level;
+	stack[0].type = type;
+
+	while (top > 0) {
+		__m128 a = stack[top-1].a;	// x1 y1 x2 y2
+		__m128 b = stack[top-1].b;	// x3 y3 x4 y4
+		__m128 p4, m12, m34, m123, m234, m1234, d, e, cross, dist, len2;
+		level = stack[top-1].level;
+		type = stack[top-1].type;
+		top--;
+
+		if (level > 10) continue;
+
+		p4 = _mm_movehl_ps(b, b);
+		m12 = _mm_mul_ps(_mm_add_ps(a, _mm_shuffle_ps(a, b, _MM_SHUFFLE(1,0,3,2))), half);	// x12 y12 x23 y23
+		m34 = _mm_mul_ps(_mm_add_ps(b, p4), half);
+		m123 = _mm_mul_ps(_mm_add_ps(m12, _mm_movehl_ps(m12, m12)), half);
+
+		// d2 = |(x2 - x4) * dy - (y2 - y4) * dx|, d3 likewise, in lanes 0 and 1
+		d = _mm_sub_ps(p4, a);
+		e = _mm_movelh_ps(_mm_sub_ps(_mm_movehl_ps(a, a), p4), _mm_sub_ps(b, p4));
+		cross = _mm_mul_ps(e, _mm_shuffle_ps(d, d, _MM_SHUFFLE(0,1,0,1)));
+		dist = _mm_and_ps(_mm_sub_ps(_mm_shuffle_ps(cross, cross, _MM_SHUFFLE(2,0,2,0)),
+									 _mm_shuffle_ps(cross, cross, _MM_SHUFFLE(3,1,3,1))), absMask);
+		dist = _mm_add_ss(dist, _mm_shuffle_ps(dist, dist, _MM_SHUFFLE(1,1,1,1)));
+		len2 = _mm_mul_ps(d, d);
+		len2 = _mm_add_ss(len2, _mm_shuffle_ps(len2, len2, _MM_SHUFFLE(1,1,1,1)));
+
+		if (_mm_comilt_ss(_mm_mul_ss(dist, dist), _mm_mul_ss(tol, len2))) {
+			nvg__addPoint(ctx, _mm_cvtss_f32(p4), _mm_cvtss_f32(_mm_shuffle_ps(p4, p4, _MM_SHUFFLE(1,1,1,1))), type);
+			continue;
+		}
+
+		m234 = _mm_mul_ps(_mm_add_ps(_mm_movehl_ps(m12, m12), m34), half);
+		m1234 = _mm_mul_ps(_mm_add_ps(m123, m234), half);
+
+		// second half below the first, so the first is flattened first
+		stack[top].a = _mm_movelh_ps(m1234, m234);
+		stack[top].b = _mm_movelh_ps(m34, p4);
+		stack[top].level = level+1;
+		stack[top].type = type;
+		top++;
+		stack[top].a = _mm_movelh_ps(a, m12);
+		stack[top].b = _mm_movelh_ps(m123, m1234);
+		stack[top].level = level+1;
+		stack[top].type = 0;
+		top++;
+	}
+}
+
+// nvg__segmentsSSE2 with eight segments at a time
+NVG_TARGET_AVX2 static void nvg__segmentsAVX2(NVGpoint* pts, int count, float* bounds)
+{
+	__m256 bmin = _mm256_set1_ps(1e6f), bmax = _mm256_set1_ps(-1e6f);
+	__m256 one = _mm256_set1_ps(1.0f);
+	int i = 0;
+
+	for (; i + 8 < count; i += 8) {
+		// lanes x0 y0 x1 y1 | x4 y4 x5 y5 and x2 y2 x3 y3 | x6 y6 x7 y7
+		__m256 a = _mm256_insertf128_ps(_mm256_castps128_ps256(nvg__loadXY2(&pts[i], &pts[i+1])), nvg__loadXY2(&pts[i+4], &pts[i+5]), 1);
+		__m256 c = _mm256_insertf128_ps(_mm256_castps128_ps256(nvg__loadXY2(&pts[i+2], &pts[i+3])), nvg__loadXY2(&pts[i+6], &pts[i+7]), 1);
+		__m256 b = _mm256_insertf128_ps(_mm256_castps128_ps256(nvg__loadXY2(&pts[i+1], &pts[i+2])), nvg__loadXY2(&pts[i+5], &pts[i+6]), 1);
+		__m256 d = _mm256_insertf128_ps(_mm256_castps128_ps256(nvg__loadXY2(&pts[i+3], &pts[i+4])), nvg__loadXY2(&pts[i+7], &pts[i+8]), 1);
+		__m256 dab = _mm256_sub_ps(b, a);
+		__m256 dcd = _mm256_sub_ps(d, c);
+		__m256 dx = _mm256_shuffle_ps(dab, dcd, _MM_SHUFFLE(2,0,2,0));
+		__m256 dy = _mm256_shuffle_ps(dab, dcd, _MM_SHUFFLE(3,1,3,1));
+		__m256 len = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+		__m256 mask = _mm256_cmp_ps(len, _mm256_set1_ps(1e-6f), _CMP_GT_OQ);
+		__m256 scale = _mm256_blendv_ps(one, _mm256_div_ps(one, len), mask);
+		dx = _mm256_mul_ps(dx, scale);
+		dy = _mm256_mul_ps(dy, scale);
+		nvg__storeSegments4(&pts[i], _mm256_castps256_ps128(dx), _mm256_castps256_ps128(dy), _mm256_castps256_ps128(len));
+		nvg__storeSegments4(&pts[i+4], _mm256_extractf128_ps(dx, 1), _mm256_extractf128_ps(dy, 1), _mm256_extractf128_ps(len, 1));
+
+		bmin = _mm256_min_ps(bmin, _mm256_min_ps(a, c));
+		bmax = _mm256_max_ps(bmax, _mm256_max_ps(a, c));
+	}
+	nvg__boundsFinish(bounds,
+					  _mm_min_ps(_mm256_castps256_ps128(bmin), _mm256_extractf128_ps(bmin, 1)),
+					  _mm_max_ps(_mm256_castps256_ps128(bmax), _mm256_extractf128_ps(bmax, 1)));
+	nvg__segmentsFrom(pts, i, count, bounds);
+}
+
+#endif
+
+struct NVGsimdKernels {
+	void (*segments)(NVGpoint* pts, int count, float* bounds);
+	NVGvertex* (*extrude)(NVGvertex* dst, const NVGpoint* pts, int count, float w, float u);
+	NVGvertex* (*extrudePairs)(NVGvertex* dst, const NVGpoint* pts, int count,
+							   float lw, float rw, float lu, float ru, float ls, float rs, float t);
+	void (*tesselateBezier)(NVGcontext* ctx, float x1, float y1, float x2, float y2,
+							float x3, float y3, float x4, float y4, int level, int type);
+};
+typedef struct NVGsimdKernels NVGsimdKernels;
+
+static NVGsimdKernels nvg__simd = {
+	nvg__segmentsScalar, nvg__extrudeScalar, nvg__extrudePairsScalar, nvg__tesselateBezier
+};
+static int nvg__simdLevel = -1;
+
+static int nvg__detectSimd(void)
+{
+#if defined(NVG_SIMD_X86) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] >= 7) {
+		// avx2 needs the os to save the ymm registers as well
+		__cpuid(info, 1);
+		if ((info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6) {
+			__cpuidex(info, 7, 0);
+			if (info[1] & (1 << 5)) return NVG_SIMD_AVX2;
+		}
+	}
+	return NVG_SIMD_SSE2;
+#elif defined(NVG_SIMD_X86)
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") ? NVG_SIMD_AVX2 : NVG_SIMD_SSE2;
+#else
+	return NVG_SIMD_SCALAR;
+#endif
+}
+
+int nvgSimdSupported(void)
+{
+	static int supported = -1;
+	if (supported < 0) supported = nvg__detectSimd();
+	return supported;
+}
+
+int nvgSimdLevel(void)
+{
+	if (nvg__simdLevel < 0) nvgSetSimdLevel(NVG_SIMD_AVX2);
+	return nvg__simdLevel;
+}
+
+int nvgSetSimdLevel(int level)
+{
+	NVGsimdKernels kernels = { nvg__segmentsScalar, nvg__extrudeScalar, nvg__extrudePairsScalar, nvg__tesselateBezier };
+
+	level = nvg__clampi(level, NVG_SIMD_SCALAR, nvgSimdSupported());
+#ifdef NVG_SIMD_X86
+	if (level >= NVG_SIMD_SSE2) {
+		kernels.segments = nvg__segmentsSSE2;
+		kernels.extrude = nvg__extrudeSSE2;
+		kernels.extrudePairs = nvg__extrudePairsSSE2;
+		kernels.tesselateBezier = nvg__tesselateBezierSSE2;
+	}
+	// flattening and expansion work on one point at a time, four lanes already cover them
+	if (level >= NVG_SIMD_AVX2)
+		kernels.segments = nvg__segmentsAVX2;
+#endif
+
+	nvg__simd = kernels;
+	nvg__simdLevel = level;
+	return level;
+}
+
+// Returns how many points from pts on need no bevel, they can go through the kernels in one run.
+static int nvg__plainRun(const NVGpoint* pts, int count, int bevelFlags)
+{
+	int n = 0;
+	while (n < count && (pts[n].flags & bevelFlags) == 0)
+		n++;
+	return n;
+}
+
 static void nvg__flattenPaths(NVGcontext* ctx)
 {
 	NVGpathCache* cache = ctx->cache;
@@ -1375,7 +1757,7 @@ static void nvg__flattenPaths(NVGcontext* ctx)
 				cp1 = &ctx->commands[i+1];
 				cp2 = &ctx->commands[i+3];
 				p = &ctx->commands[i+5];
-				nvg__tesselateBezier(ctx, last->x,last->y, cp1[0],cp1[1], cp2[0],cp2[1], p[0],p[1], 0, NVG_PT_CORNER);
+				nvg__simd.tesselateBezier(ctx, last->x,last->y, cp1[0],cp1[1], cp2[0],cp2[1], p[0],p[1], 0, NVG_PT_CORNER);
 			}
 			i += 7;
 			break;
@@ -1418,19 +1800,8 @@ static void nvg__flattenPaths(NVGcontext* ctx)
 				nvg__polyReverse(pts, path->count);
 		}
 
-		for(i = 0; i < path->count; i++) {
-			// Calculate segment direction and length
-			p0->dx = p1->x - p0->x;
-			p0->dy = p1->y - p0->y;
-			p0->len = nvg__normalize(&p0->dx, &p0->dy);
-			// Update bounds
-			cache->bounds[0] = nvg__minf(cache->bounds[0], p0->x);
-			cache->bounds[1] = nvg__minf(cache->bounds[1], p0->y);
-			cache->bounds[2] = nvg__maxf(cache->bounds[2], p0->x);
-			cache->bounds[3] = nvg__maxf(cache->bounds[3], p0->y);
-			// Advance
-			p0 = p1++;
-		}
+		// Calculate segment direction and length, update bounds
+		nvg__simd.segments(pts, path->count, cache->bounds);
 	}
 }
 
@@ -1840,6 +2211,15 @@ static int nvg__expandStroke(NVGcontext* ctx, float w, float fringe, int lineCap
 		}
 
 		for (j = s; j < e; ++j) {
+			// Joins without bevel in one go, spacers are inserted per segment.
+			int n = lineStyle > 1 ? 0 : nvg__plainRun(p1, e - j, NVG_PT_BEVEL | NVG_PR_INNERBEVEL);
+			if (n > 0) {
+				dst = nvg__simd.extrudePairs(dst, p1, n, w, w, u0, u1, -1, 1, t);
+				p1 += n;
+				p0 = p1 - 1;
+				j += n - 1;
+				continue;
+			}
 			if (lineStyle > 1) {
 				dx = p1->x - p0->x;
 				dy = p1->y - p0->y;
@@ -1936,7 +2316,16 @@ static int nvg__expandFill(NVGcontext* ctx, float w, int lineJoin, float miterLi
 			p0 = &pts[path->count-1];
 			p1 = &pts[0];
 			for (j = 0; j < path->count; ++j) {
-				if (p1->flags & NVG_PT_BEVEL) {
+				// Points without bevel in one go.
+				int n = nvg__plainRun(p1, path->count - j, NVG_PT_BEVEL);
+				if (n > 0) {
+					dst = nvg__simd.extrude(dst, p1, n, woff, 0.5f);
+					p1 += n;
+					p0 = p1 - 1;
+					j += n - 1;
+					continue;
+				}
+				{
 					float dlx0 = p0->dy;
 					float dly0 = -p0->dx;
 					float dlx1 = p1->dy;
@@ -1953,8 +2342,6 @@ static int nvg__expandFill(NVGcontext* ctx, float w, int lineJoin, float miterLi
 						nvg__vset(dst, lx0, ly0, 0.5f, 1, 0, 0); dst++;
 						nvg__vset(dst, lx1, ly1, 0.5f, 1, 0, 0); dst++;
 					}
-				} else {
-					nvg__vset(dst, p1->x + (p1->dmx * woff), p1->y + (p1->dmy * woff), 0.5f, 1, 0, 0); dst++;
 				}
 				p0 = p1++;
 			}
@@ -1989,12 +2376,16 @@ static int nvg__expandFill(NVGcontext* ctx, float w, int lineJoin, float miterLi
 			p1 = &pts[0];
 
 			for (j = 0; j < path->count; ++j) {
-				if ((p1->flags & (NVG_PT_BEVEL | NVG_PR_INNERBEVEL)) != 0) {
-					dst = nvg__bevelJoin(dst, p0, p1, lw, rw, lu, ru, ctx->fringeWidth, 0);
-				} else {
-					nvg__vset(dst, p1->x + (p1->dmx * lw), p1->y + (p1->dmy * lw), lu,1, 0, 0); dst++;
-					nvg__vset(dst, p1->x - (p1->dmx * rw), p1->y - (p1->dmy * rw), ru,1, 0, 0); dst++;
+				// Joins without bevel in one go.
+				int n = nvg__plainRun(p1, path->count - j, NVG_PT_BEVEL | NVG_PR_INNERBEVEL);
+				if (n > 0) {
+					dst = nvg__simd.extrudePairs(dst, p1, n, lw, rw, lu, ru, 0, 0, 0);
+					p1 += n;
+					p0 = p1 - 1;
+					j += n - 1;
+					continue;
 				}
+				dst = nvg__bevelJoin(dst, p0, p1, lw, rw, lu, ru, ctx->fringeWidth, 0);
 				p0 = p1++;
 			}
 
@@ -2430,6 +2821,14 @@ void nvgFontFace(NVGcontext* ctx, const char* font)
 	state->fontId = fonsGetFontByName(ctx->fs, font);
 }
 
+void nvgCurrentTextStyle(NVGcontext* ctx, int* font, float* size, float* letterSpacing)
+{
+	NVGstate* state = nvg__getState(ctx);
+	if (font != NULL) *font = state->fontId;
+	if (size != NULL) *size = state->fontSize;
+	if (letterSpacing != NULL) *letterSpacing = state->letterSpacing;
+}
+
 static float nvg__quantize(float a, float d)
 {
 	return ((int)(a / d + 0.5f)) * d;
@@ -19,6 +19,8 @@
 #ifndef NANOVG_H
 #define NANOVG_H
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -167,6 +169,29 @@ void nvgCancelFrame(NVGcontext* ctx);
 // Ends drawing flushing remaining render state.
 void nvgEndFrame(NVGcontext* ctx);
 
+// Returns the bytes held by the context's command and path buffers and by fontstash (atlas, glyphs, font data).
+// Textures belong to the render backend and aren't included.
+size_t nvgMemoryUsage(NVGcontext* ctx);
+
+// Instruction sets used for curve flattening, segment normalization and vertex expansion.
+// Every level produces the same vertices, the best one the CPU supports is picked when the
+// first context is created.
+enum NVGsimdLevel {
+	NVG_SIMD_SCALAR = 0,
+	NVG_SIMD_SSE2,
+	NVG_SIMD_AVX2,
+};
+
+// Returns the highest level supported by the CPU and the build.
+int nvgSimdSupported(void);
+
+// Returns the level in use.
+int nvgSimdLevel(void);
+
+// Selects a level, clamped to the supported one, and returns the level now in use.
+// Applies to all contexts, don't call it while another thread is tessellating.
+int nvgSetSimdLevel(int level);
+
 //
 // Composite operation
 //
@@ -603,6 +628,9 @@ void nvgFontFaceId(NVGcontext* ctx, int font);
 // Sets the font face based on specified name of current text style.
 void nvgFontFace(NVGcontext* ctx, const char* font);
 
+// Returns the font id, size and letter spacing of current text style, everything the size of single-line text depends on.
+void nvgCurrentTextStyle(NVGcontext* ctx, int* font, float* size, float* letterSpacing);
+
 // Draws text string at specified location. If end is specified only the sub-string up to the end is drawn.
 float nvgText(NVGcontext* ctx, float x, float y, const char* string, const char* end);
 
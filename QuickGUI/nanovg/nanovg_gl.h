@@ -51,6 +51,19 @@ enum NVGcreateFlags {
 
 #define NANOVG_GL_USE_STATE_FILTER (1)
 
+// Adjacent fills, strokes and triangle calls that share blend state and texture are merged into
+// a single indexed draw, every vertex picks its paint from an array in the uniform buffer.
+#if NANOVG_GL_USE_UNIFORMBUFFER
+#  define NANOVG_GL_USE_BATCHING 1
+// paints per merged draw, 64 * 192 bytes stays below the guaranteed 16KB uniform block size
+#  define NANOVG_GL_BATCH_SIZE 64
+#  define NANOVG_GL_BATCH_SIZE_STR "64"
+// Vertices, uniforms and batch indices go through persistently mapped rings instead of being
+// respecified with every flush, when the context is GL 4.4 or newer.
+#  define NANOVG_GL_USE_PERSISTENT_BUFFERS 1
+#  define NANOVG_GL_RING_SEGMENTS 3
+#endif
+
 // Creates NanoVG contexts for different OpenGL (ES) versions.
 // Flags should be combination of the create flags above.
 
@@ -62,6 +75,12 @@ void nvgDeleteGL2(NVGcontext* ctx);
 int nvglCreateImageFromHandleGL2(NVGcontext* ctx, GLuint textureId, int w, int h, int flags);
 GLuint nvglImageHandleGL2(NVGcontext* ctx, int image);
 
+// Draw calls and vertices of the last nvgEndFrame.
+void nvglFlushStatsGL2(NVGcontext* ctx, int* drawCalls, int* vertices);
+
+// Bytes held by the backend: call and vertex buffers on the cpu, textures (except NVG_IMAGE_NODELETE ones) and the vertex buffer on the gpu.
+void nvglMemoryUsageGL2(NVGcontext* ctx, size_t* cpuBytes, size_t* gpuBytes);
+
 #endif
 
 #if defined NANOVG_GL3
@@ -72,6 +91,12 @@ void nvgDeleteGL3(NVGcontext* ctx);
 int nvglCreateImageFromHandleGL3(NVGcontext* ctx, GLuint textureId, int w, int h, int flags);
 GLuint nvglImageHandleGL3(NVGcontext* ctx, int image);
 
+// Draw calls and vertices of the last nvgEndFrame.
+void nvglFlushStatsGL3(NVGcontext* ctx, int* drawCalls, int* vertices);
+
+// Bytes held by the backend: call and vertex buffers on the cpu, textures (except NVG_IMAGE_NODELETE ones) and the vertex buffer on the gpu.
+void nvglMemoryUsageGL3(NVGcontext* ctx, size_t* cpuBytes, size_t* gpuBytes);
+
 #endif
 
 #if defined NANOVG_GLES2
@@ -82,6 +107,12 @@ void nvgDeleteGLES2(NVGcontext* ctx);
 int nvglCreateImageFromHandleGLES2(NVGcontext* ctx, GLuint textureId, int w, int h, int flags);
 GLuint nvglImageHandleGLES2(NVGcontext* ctx, int image);
 
+// Draw calls and vertices of the last nvgEndFrame.
+void nvglFlushStatsGLES2(NVGcontext* ctx, int* drawCalls, int* vertices);
+
+// Bytes held by the backend: call and vertex buffers on the cpu, textures (except NVG_IMAGE_NODELETE ones) and the vertex buffer on the gpu.
+void nvglMemoryUsageGLES2(NVGcontext* ctx, size_t* cpuBytes, size_t* gpuBytes);
+
 #endif
 
 #if defined NANOVG_GLES3
@@ -92,6 +123,12 @@ void nvgDeleteGLES3(NVGcontext* ctx);
 int nvglCreateImageFromHandleGLES3(NVGcontext* ctx, GLuint textureId, int w, int h, int flags);
 GLuint nvglImageHandleGLES3(NVGcontext* ctx, int image);
 
+// Draw calls and vertices of the last nvgEndFrame.
+void nvglFlushStatsGLES3(NVGcontext* ctx, int* drawCalls, int* vertices);
+
+// Bytes held by the backend: call and vertex buffers on the cpu, textures (except NVG_IMAGE_NODELETE ones) and the vertex buffer on the gpu.
+void nvglMemoryUsageGLES3(NVGcontext* ctx, size_t* cpuBytes, size_t* gpuBytes);
+
 #endif
 
 // These are additional flags on top of NVGimageFlags.
@@ -233,6 +270,35 @@ struct GLNVGfragUniforms {
 };
 typedef struct GLNVGfragUniforms GLNVGfragUniforms;
 
+#if NANOVG_GL_USE_BATCHING
+// std140 rounds the size of each array element up to a vec4
+#define NANOVG_GL_BATCH_STRIDE ((int)((sizeof(GLNVGfragUniforms) + 15) & ~(size_t)15))
+
+// calls [firstCall, firstCall + callCount) drawn as one GL_TRIANGLES draw
+struct GLNVGbatch {
+	int firstCall;
+	int callCount;
+	int image;
+	int indexOffset;
+	int indexCount;
+	int uniformOffset;
+};
+typedef struct GLNVGbatch GLNVGbatch;
+#endif
+
+#if NANOVG_GL_USE_PERSISTENT_BUFFERS
+// A persistently mapped buffer split into NANOVG_GL_RING_SEGMENTS parts. Every flush fills one
+// part and fences it, a part is written again once the gpu has passed its fence.
+struct GLNVGring {
+	GLuint buf;
+	unsigned char* data;
+	GLsizeiptr segmentSize;
+	int segment;
+	GLsync fences[NANOVG_GL_RING_SEGMENTS];
+};
+typedef struct GLNVGring GLNVGring;
+#endif
+
 struct GLNVGcontext {
 	GLNVGshader shader;
 	GLNVGtexture* textures;
@@ -249,6 +315,22 @@ struct GLNVGcontext {
 #endif
 	int fragSize;
 	int flags;
+#if NANOVG_GL_USE_BATCHING
+	GLNVGshader batchShader;
+	int batching; // 0 if the batch shader didn't compile
+	GLuint indexBuf;
+	GLuint paintBuf;
+#endif
+#if NANOVG_GL_USE_PERSISTENT_BUFFERS
+	GLNVGring vertRing; // vertices, written straight from the render callbacks
+	GLNVGring uploadRing; // uniforms and batch indices, copied in at the flush
+	NVGvertex* mappedVerts; // this frame's part of vertRing, NULL while vertices go to verts
+	int vertOverflow; // a frame didn't fit, vertRing grows at the flush
+	// where the current flush reads uniforms and element indices from
+	GLuint drawFragBuf;
+	GLintptr fragBase;
+	GLintptr indexBase;
+#endif
 
 	// Per frame buffers
 	GLNVGcall* calls;
@@ -263,6 +345,20 @@ struct GLNVGcontext {
 	unsigned char* uniforms;
 	int cuniforms;
 	int nuniforms;
+#if NANOVG_GL_USE_BATCHING
+	GLNVGbatch* batches;
+	int cbatches;
+	int nbatches;
+	GLuint* indices;
+	int cindices;
+	int nindices;
+	unsigned char* paintIndices; // slot in the batch's paint array, per vertex
+	int cpaintIndices;
+#endif
+
+	// stats of the last flush
+	int flushDrawCalls;
+	int flushVerts;
 
 	// cached state
 	#if NANOVG_GL_USE_STATE_FILTER
@@ -280,6 +376,93 @@ typedef struct GLNVGcontext GLNVGcontext;
 
 static int glnvg__maxi(int a, int b) { return a > b ? a : b; }
 
+static void glnvg__drawArrays(GLNVGcontext* gl, GLenum mode, GLint first, GLsizei count)
+{
+	glDrawArrays(mode, first, count);
+	gl->flushDrawCalls++;
+}
+
+#if NANOVG_GL_USE_BATCHING
+static void glnvg__drawElements(GLNVGcontext* gl, GLint first, GLsizei count)
+{
+	size_t offset = (size_t)first * sizeof(GLuint);
+#if NANOVG_GL_USE_PERSISTENT_BUFFERS
+	offset += (size_t)gl->indexBase;
+#endif
+	glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, (const GLvoid*)offset);
+	gl->flushDrawCalls++;
+}
+#endif
+
+#if NANOVG_GL_USE_PERSISTENT_BUFFERS
+static int glnvg__ringCreate(GLNVGring* ring, GLsizeiptr segmentSize)
+{
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	memset(ring, 0, sizeof(*ring));
+	glGenBuffers(1, &ring->buf);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, ring->buf);
+	glBufferStorage(GL_COPY_WRITE_BUFFER, segmentSize * NANOVG_GL_RING_SEGMENTS, NULL, flags);
+	ring->data = (unsigned char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, segmentSize * NANOVG_GL_RING_SEGMENTS, flags);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	if (ring->data == NULL) {
+		glDeleteBuffers(1, &ring->buf);
+		ring->buf = 0;
+		return 0;
+	}
+	ring->segmentSize = segmentSize;
+	return 1;
+}
+
+static void glnvg__ringDelete(GLNVGring* ring)
+{
+	int i;
+	for (i = 0; i < NANOVG_GL_RING_SEGMENTS; i++) {
+		if (ring->fences[i] != NULL)
+			glDeleteSync(ring->fences[i]);
+	}
+	// deleting unmaps it, the storage lives on until draws still reading from it are done
+	if (ring->buf != 0)
+		glDeleteBuffers(1, &ring->buf);
+	memset(ring, 0, sizeof(*ring));
+}
+
+// makes room for `size` bytes per segment, a new buffer replaces the old one if needed
+static int glnvg__ringReserve(GLNVGcontext* gl, GLNVGring* ring, GLsizeiptr size)
+{
+	if (size <= ring->segmentSize) return 1;
+	size += size / 2;
+	size = (size + gl->fragSize - 1) / gl->fragSize * gl->fragSize; // keeps segments aligned for uniform ranges
+	glnvg__ringDelete(ring);
+	return glnvg__ringCreate(ring, size);
+}
+
+static GLintptr glnvg__ringOffset(GLNVGring* ring)
+{
+	return (GLintptr)ring->segment * ring->segmentSize;
+}
+
+// the current segment, once the gpu is done with what was last written there
+static unsigned char* glnvg__ringAcquire(GLNVGring* ring)
+{
+	GLsync fence = ring->fences[ring->segment];
+	if (fence != NULL) {
+		while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED);
+		glDeleteSync(fence);
+		ring->fences[ring->segment] = NULL;
+	}
+	return ring->data + glnvg__ringOffset(ring);
+}
+
+// after the draws reading the current segment have been issued
+static void glnvg__ringRelease(GLNVGring* ring)
+{
+	ring->fences[ring->segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	ring->segment = (ring->segment + 1) % NANOVG_GL_RING_SEGMENTS;
+}
+#endif
+
 #ifdef NANOVG_GLES2
 static unsigned int glnvg__nearestPow2(unsigned int num)
 {
@@ -470,6 +653,7 @@ static int glnvg__createShader(GLNVGshader* shader, const char* name, const char
 
 	glBindAttribLocation(prog, 0, "vertex");
 	glBindAttribLocation(prog, 1, "tcoord");
+	glBindAttribLocation(prog, 2, "paint");
 
 	glLinkProgram(prog);
 	glGetProgramiv(prog, GL_LINK_STATUS, &status);
@@ -513,6 +697,9 @@ static int glnvg__renderCreate(void* uptr)
 {
 	GLNVGcontext* gl = (GLNVGcontext*)uptr;
 	int align = 4;
+#if NANOVG_GL_USE_PERSISTENT_BUFFERS
+	GLint major = 0, minor = 0;
+#endif
 
 	// TODO: mediump float may not be enough for GLES2 in iOS.
 	// see the following discussion: https://github.com/memononen/nanovg/issues/46
@@ -545,6 +732,10 @@ static int glnvg__renderCreate(void* uptr)
 		"	out vec2 ftcoord;\n"
 		"	out vec2 fpos;\n"
 		"	smooth out vec2 uv;\n"
+		"#ifdef PAINT_BATCH\n"
+		"	in float paint;\n"
+		"	flat out int fpaint;\n"
+		"#endif\n"
 		"#else\n"
 		"	uniform vec2 viewSize;\n"
 		"	attribute vec2 vertex;\n"
@@ -557,6 +748,9 @@ static int glnvg__renderCreate(void* uptr)
 		"	ftcoord = tcoord.xy;\n"
 		"	uv = 0.5 * tcoord.zw;\n"
 		"	fpos = vertex;\n"
+		"#ifdef PAINT_BATCH\n"
+		"	fpaint = int(paint);\n"
+		"#endif\n"
 		"	gl_Position = vec4(2.0*vertex.x/viewSize.x - 1.0, 1.0 - 2.0*vertex.y/viewSize.y, 0, 1);\n"
 		"}\n";
 
@@ -569,7 +763,42 @@ static int glnvg__renderCreate(void* uptr)
 		"#endif\n"
 		"#endif\n"
 		"#ifdef NANOVG_GL3\n"
-		"#ifdef USE_UNIFORMBUFFER\n"
+		"#if defined(USE_UNIFORMBUFFER) && defined(PAINT_BATCH)\n"
+		"	struct Paint {\n"
+		"		mat3 scissorMat;\n"
+		"		mat3 paintMat;\n"
+		"		vec4 innerCol;\n"
+		"		vec4 outerCol;\n"
+		"		vec2 scissorExt;\n"
+		"		vec2 scissorScale;\n"
+		"		vec2 extent;\n"
+		"		float radius;\n"
+		"		float feather;\n"
+		"		float strokeMult;\n"
+		"		float strokeThr;\n"
+		"		int lineStyle;\n"
+		"		int texType;\n"
+		"		int type;\n"
+		"	};\n"
+		"	layout(std140) uniform frag {\n"
+		"		Paint paints[PAINT_BATCH];\n"
+		"	};\n"
+		"	flat in int fpaint;\n"
+		"	#define scissorMat paints[fpaint].scissorMat\n"
+		"	#define paintMat paints[fpaint].paintMat\n"
+		"	#define innerCol paints[fpaint].innerCol\n"
+		"	#define outerCol paints[fpaint].outerCol\n"
+		"	#define scissorExt paints[fpaint].scissorExt\n"
+		"	#define scissorScale paints[fpaint].scissorScale\n"
+		"	#define extent paints[fpaint].extent\n"
+		"	#define radius paints[fpaint].radius\n"
+		"	#define feather paints[fpaint].feather\n"
+		"	#define strokeMult paints[fpaint].strokeMult\n"
+		"	#define strokeThr paints[fpaint].strokeThr\n"
+		"	#define lineStyle paints[fpaint].lineStyle\n"
+		"	#define texType paints[fpaint].texType\n"
+		"	#define type paints[fpaint].type\n"
+		"#elif defined(USE_UNIFORMBUFFER)\n"
 		"	layout(std140) uniform frag {\n"
 		"		mat3 scissorMat;\n"
 		"		mat3 paintMat;\n"
@@ -730,6 +959,15 @@ static int glnvg__renderCreate(void* uptr)
 	glnvg__checkError(gl, "uniform locations");
 	glnvg__getUniforms(&gl->shader);
 
+#if NANOVG_GL_USE_BATCHING
+	// without the batch shader every call is drawn on its own, as before
+	if (gl->flags & NVG_ANTIALIAS)
+		gl->batching = glnvg__createShader(&gl->batchShader, "batch shader", shaderHeader, "#define EDGE_AA 1\n#define PAINT_BATCH " NANOVG_GL_BATCH_SIZE_STR "\n", fillVertShader, fillFragShader);
+	else
+		gl->batching = glnvg__createShader(&gl->batchShader, "batch shader", shaderHeader, "#define PAINT_BATCH " NANOVG_GL_BATCH_SIZE_STR "\n", fillVertShader, fillFragShader);
+	if (gl->batching) glnvg__getUniforms(&gl->batchShader);
+#endif
+
 	// Create dynamic vertex array
 #if defined NANOVG_GL3
 	glGenVertexArrays(1, &gl->vertArr);
@@ -744,6 +982,24 @@ static int glnvg__renderCreate(void* uptr)
 #endif
 	gl->fragSize = sizeof(GLNVGfragUniforms) + align - sizeof(GLNVGfragUniforms) % align;
 
+#if NANOVG_GL_USE_BATCHING
+	if (gl->batching) {
+		glUniformBlockBinding(gl->batchShader.prog, gl->batchShader.loc[GLNVG_LOC_FRAG], GLNVG_FRAG_BINDING);
+		glGenBuffers(1, &gl->indexBuf);
+		glGenBuffers(1, &gl->paintBuf);
+	}
+#endif
+
+#if NANOVG_GL_USE_PERSISTENT_BUFFERS
+	// buffer storage is core since 4.4, a ring that fails to map leaves its data on glBufferData
+	glGetIntegerv(GL_MAJOR_VERSION, &major);
+	glGetIntegerv(GL_MINOR_VERSION, &minor);
+	if (major > 4 || (major == 4 && minor >= 4)) {
+		glnvg__ringCreate(&gl->vertRing, 16384 * sizeof(NVGvertex));
+		glnvg__ringCreate(&gl->uploadRing, 256 * gl->fragSize);
+	}
+#endif
+
 	// Some platforms does not allow to have samples to unset textures.
 	// Create empty one which is bound when there's no texture specified.
 	gl->dummyTex = glnvg__renderCreateTexture(gl, NVG_TEXTURE_ALPHA, 1, 1, 0, NULL);
@@ -1023,7 +1279,9 @@ static GLNVGfragUniforms* nvg__fragUniformPtr(GLNVGcontext* gl, int i);
 static void glnvg__setUniforms(GLNVGcontext* gl, int uniformOffset, int image)
 {
 	GLNVGtexture* tex = NULL;
-#if NANOVG_GL_USE_UNIFORMBUFFER
+#if NANOVG_GL_USE_PERSISTENT_BUFFERS
+	glBindBufferRange(GL_UNIFORM_BUFFER, GLNVG_FRAG_BINDING, gl->drawFragBuf, gl->fragBase + uniformOffset, sizeof(GLNVGfragUniforms));
+#elif NANOVG_GL_USE_UNIFORMBUFFER
 	glBindBufferRange(GL_UNIFORM_BUFFER, GLNVG_FRAG_BINDING, gl->fragBuf, uniformOffset, sizeof(GLNVGfragUniforms));
 #else
 	GLNVGfragUniforms* frag = nvg__fragUniformPtr(gl, uniformOffset);
@@ -1068,7 +1326,7 @@ static void glnvg__fill(GLNVGcontext* gl, GLNVGcall* call)
 	glStencilOpSeparate(GL_BACK, GL_KEEP, GL_KEEP, GL_DECR_WRAP);
 	glDisable(GL_CULL_FACE);
 	for (i = 0; i < npaths; i++)
-		glDrawArrays(GL_TRIANGLE_FAN, paths[i].fillOffset, paths[i].fillCount);
+		glnvg__drawArrays(gl, GL_TRIANGLE_FAN, paths[i].fillOffset, paths[i].fillCount);
 	glEnable(GL_CULL_FACE);
 
 	// Draw anti-aliased pixels
@@ -1082,13 +1340,13 @@ static void glnvg__fill(GLNVGcontext* gl, GLNVGcall* call)
 		glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 		// Draw fringes
 		for (i = 0; i < npaths; i++)
-			glDrawArrays(GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
+			glnvg__drawArrays(gl, GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
 	}
 
 	// Draw fill
 	glnvg__stencilFunc(gl, GL_NOTEQUAL, 0x0, 0xff);
 	glStencilOp(GL_ZERO, GL_ZERO, GL_ZERO);
-	glDrawArrays(GL_TRIANGLE_STRIP, call->triangleOffset, call->triangleCount);
+	glnvg__drawArrays(gl, GL_TRIANGLE_STRIP, call->triangleOffset, call->triangleCount);
 
 	glDisable(GL_STENCIL_TEST);
 }
@@ -1102,10 +1360,10 @@ static void glnvg__convexFill(GLNVGcontext* gl, GLNVGcall* call)
 	glnvg__checkError(gl, "convex fill");
 
 	for (i = 0; i < npaths; i++) {
-		glDrawArrays(GL_TRIANGLE_FAN, paths[i].fillOffset, paths[i].fillCount);
+		glnvg__drawArrays(gl, GL_TRIANGLE_FAN, paths[i].fillOffset, paths[i].fillCount);
 		// Draw fringes
 		if (paths[i].strokeCount > 0) {
-			glDrawArrays(GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
+			glnvg__drawArrays(gl, GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
 		}
 	}
 }
@@ -1126,14 +1384,14 @@ static void glnvg__stroke(GLNVGcontext* gl, GLNVGcall* call)
 		glnvg__setUniforms(gl, call->uniformOffset + gl->fragSize, call->image);
 		glnvg__checkError(gl, "stroke fill 0");
 		for (i = 0; i < npaths; i++)
-			glDrawArrays(GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
+			glnvg__drawArrays(gl, GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
 
 		// Draw anti-aliased pixels.
 		glnvg__setUniforms(gl, call->uniformOffset, call->image);
 		glnvg__stencilFunc(gl, GL_EQUAL, 0x00, 0xff);
 		glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 		for (i = 0; i < npaths; i++)
-			glDrawArrays(GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
+			glnvg__drawArrays(gl, GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
 
 		// Clear stencil buffer.
 		glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
@@ -1141,7 +1399,7 @@ static void glnvg__stroke(GLNVGcontext* gl, GLNVGcall* call)
 		glStencilOp(GL_ZERO, GL_ZERO, GL_ZERO);
 		glnvg__checkError(gl, "stroke fill 1");
 		for (i = 0; i < npaths; i++)
-			glDrawArrays(GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
+			glnvg__drawArrays(gl, GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
 		glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 
 		glDisable(GL_STENCIL_TEST);
@@ -1153,7 +1411,7 @@ static void glnvg__stroke(GLNVGcontext* gl, GLNVGcall* call)
 		glnvg__checkError(gl, "stroke fill");
 		// Draw Strokes
 		for (i = 0; i < npaths; i++)
-			glDrawArrays(GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
+			glnvg__drawArrays(gl, GL_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
 	}
 }
 
@@ -1162,7 +1420,7 @@ static void glnvg__triangles(GLNVGcontext* gl, GLNVGcall* call)
 	glnvg__setUniforms(gl, call->uniformOffset, call->image);
 	glnvg__checkError(gl, "triangles fill");
 
-	glDrawArrays(GL_TRIANGLES, call->triangleOffset, call->triangleCount);
+	glnvg__drawArrays(gl, GL_TRIANGLES, call->triangleOffset, call->triangleCount);
 }
 
 static void glnvg__renderCancel(void* uptr) {
@@ -1217,13 +1475,249 @@ static GLNVGblend glnvg__blendCompositeOperation(NVGcompositeOperationState op)
 	return blend;
 }
 
+#if NANOVG_GL_USE_BATCHING
+static int glnvg__allocFragUniforms(GLNVGcontext* gl, int n);
+
+// the texture a call samples, 0 for colour and gradient fills which don't read one
+static int glnvg__callTexture(GLNVGcontext* gl, GLNVGcall* call)
+{
+	if (call->type == GLNVG_TRIANGLES)
+		return call->image != 0 ? call->image : gl->dummyTex;
+	return call->image;
+}
+
+static int glnvg__batchable(GLNVGcontext* gl, GLNVGcall* call)
+{
+	if (call->type == GLNVG_CONVEXFILL || call->type == GLNVG_TRIANGLES)
+		return 1;
+	// concave fills and stencil strokes need several passes with their own stencil state
+	return call->type == GLNVG_STROKE && (gl->flags & NVG_STENCIL_STROKES) == 0;
+}
+
+static int glnvg__callIndexCount(GLNVGcontext* gl, GLNVGcall* call)
+{
+	int i, count = 0;
+	if (call->type == GLNVG_TRIANGLES)
+		return call->triangleCount;
+	for (i = 0; i < call->pathCount; i++) {
+		GLNVGpath* path = &gl->paths[call->pathOffset + i];
+		count += 3 * glnvg__maxi(path->fillCount - 2, 0);
+		count += 3 * glnvg__maxi(path->strokeCount - 2, 0);
+	}
+	return count;
+}
+
+static void glnvg__fanIndices(GLNVGcontext* gl, int offset, int count)
+{
+	GLuint* idx = &gl->indices[gl->nindices];
+	int i;
+	for (i = 2; i < count; i++) {
+		*idx++ = offset;
+		*idx++ = offset + i - 1;
+		*idx++ = offset + i;
+	}
+	gl->nindices = (int)(idx - gl->indices);
+}
+
+static void glnvg__stripIndices(GLNVGcontext* gl, int offset, int count)
+{
+	GLuint* idx = &gl->indices[gl->nindices];
+	int i, odd;
+	for (i = 2; i < count; i++) {
+		// every other triangle of a strip is flipped to keep its winding for face culling
+		odd = i & 1;
+		*idx++ = offset + i - 2 + odd;
+		*idx++ = offset + i - 1 - odd;
+		*idx++ = offset + i;
+	}
+	gl->nindices = (int)(idx - gl->indices);
+}
+
+static void glnvg__callIndices(GLNVGcontext* gl, GLNVGcall* call, unsigned char slot)
+{
+	int i;
+	if (call->type == GLNVG_TRIANGLES) {
+		for (i = 0; i < call->triangleCount; i++)
+			gl->indices[gl->nindices++] = call->triangleOffset + i;
+		memset(&gl->paintIndices[call->triangleOffset], slot, call->triangleCount);
+		return;
+	}
+
+	// same order as the separate draws: fill, then fringe, path by path
+	for (i = 0; i < call->pathCount; i++) {
+		GLNVGpath* path = &gl->paths[call->pathOffset + i];
+		glnvg__fanIndices(gl, path->fillOffset, path->fillCount);
+		glnvg__stripIndices(gl, path->strokeOffset, path->strokeCount);
+		memset(&gl->paintIndices[path->fillOffset], slot, path->fillCount);
+		memset(&gl->paintIndices[path->strokeOffset], slot, path->strokeCount);
+	}
+}
+
+static int glnvg__addBatch(GLNVGcontext* gl, int firstCall, int callCount, int image, int indexCount)
+{
+	GLNVGbatch* batch;
+	int i, uniformOffset;
+
+	if (gl->nbatches+1 > gl->cbatches) {
+		GLNVGbatch* batches;
+		int cbatches = glnvg__maxi(gl->nbatches+1, 64) + gl->cbatches/2; // 1.5x Overallocate
+		batches = (GLNVGbatch*)realloc(gl->batches, sizeof(GLNVGbatch) * cbatches);
+		if (batches == NULL) return 0;
+		gl->batches = batches;
+		gl->cbatches = cbatches;
+	}
+	if (gl->nindices+indexCount > gl->cindices) {
+		GLuint* indices;
+		int cindices = glnvg__maxi(gl->nindices + indexCount, 4096) + gl->cindices/2; // 1.5x Overallocate
+		indices = (GLuint*)realloc(gl->indices, sizeof(GLuint) * cindices);
+		if (indices == NULL) return 0;
+		gl->indices = indices;
+		gl->cindices = cindices;
+	}
+
+	// paints are packed at the std140 array stride behind the uniforms of the single calls
+	uniformOffset = glnvg__allocFragUniforms(gl, (callCount * NANOVG_GL_BATCH_STRIDE + gl->fragSize - 1) / gl->fragSize);
+	if (uniformOffset == -1) return 0;
+
+	batch = &gl->batches[gl->nbatches++];
+	batch->firstCall = firstCall;
+	batch->callCount = callCount;
+	batch->image = image;
+	batch->indexOffset = gl->nindices;
+	batch->uniformOffset = uniformOffset;
+
+	for (i = 0; i < callCount; i++) {
+		GLNVGcall* call = &gl->calls[firstCall + i];
+		memcpy(&gl->uniforms[uniformOffset + i * NANOVG_GL_BATCH_STRIDE], nvg__fragUniformPtr(gl, call->uniformOffset), sizeof(GLNVGfragUniforms));
+		glnvg__callIndices(gl, call, (unsigned char)i);
+	}
+	batch->indexCount = gl->nindices - batch->indexOffset;
+
+	return 1;
+}
+
+// Merges runs of adjacent calls with the same blend state and texture. Calls that don't sample
+// a texture fit into any run, so the rectangles behind text don't split it up. Anything left
+// out of a batch is drawn on its own.
+static void glnvg__buildBatches(GLNVGcontext* gl)
+{
+	int i = 0, n, image, count, tex;
+
+	gl->nbatches = 0;
+	gl->nindices = 0;
+	if (!gl->batching || gl->ncalls < 2) return;
+
+	if (gl->nverts > gl->cpaintIndices) {
+		int cpaintIndices = gl->nverts + gl->nverts/2; // 1.5x Overallocate
+		unsigned char* paintIndices = (unsigned char*)realloc(gl->paintIndices, cpaintIndices);
+		if (paintIndices == NULL) return;
+		gl->paintIndices = paintIndices;
+		gl->cpaintIndices = cpaintIndices;
+	}
+
+	while (i < gl->ncalls) {
+		GLNVGcall* first = &gl->calls[i];
+		n = 1;
+		if (glnvg__batchable(gl, first)) {
+			image = glnvg__callTexture(gl, first);
+			count = glnvg__callIndexCount(gl, first);
+			while (i+n < gl->ncalls && n < NANOVG_GL_BATCH_SIZE) {
+				GLNVGcall* call = &gl->calls[i+n];
+				if (!glnvg__batchable(gl, call)) break;
+				if (memcmp(&call->blendFunc, &first->blendFunc, sizeof(GLNVGblend)) != 0) break;
+				tex = glnvg__callTexture(gl, call);
+				if (tex != 0 && image != 0 && tex != image) break;
+				if (image == 0) image = tex;
+				count += glnvg__callIndexCount(gl, call);
+				n++;
+			}
+			if (n > 1 && !glnvg__addBatch(gl, i, n, image, count)) break;
+		}
+		i += n;
+	}
+
+	// every batch binds the range of a full paint array, the last one mustn't run past the buffer
+	if (gl->nbatches > 0 && glnvg__allocFragUniforms(gl, (NANOVG_GL_BATCH_SIZE * NANOVG_GL_BATCH_STRIDE + gl->fragSize - 1) / gl->fragSize) == -1)
+		gl->nbatches = 0;
+}
+
+static void glnvg__drawBatch(GLNVGcontext* gl, GLNVGbatch* batch)
+{
+	GLNVGtexture* tex = glnvg__findTexture(gl, batch->image != 0 ? batch->image : gl->dummyTex);
+
+#if NANOVG_GL_USE_PERSISTENT_BUFFERS
+	glBindBufferRange(GL_UNIFORM_BUFFER, GLNVG_FRAG_BINDING, gl->drawFragBuf, gl->fragBase + batch->uniformOffset, NANOVG_GL_BATCH_SIZE * NANOVG_GL_BATCH_STRIDE);
+#else
+	glBindBufferRange(GL_UNIFORM_BUFFER, GLNVG_FRAG_BINDING, gl->fragBuf, batch->uniformOffset, NANOVG_GL_BATCH_SIZE * NANOVG_GL_BATCH_STRIDE);
+#endif
+	glnvg__bindTexture(gl, tex != NULL ? tex->tex : 0);
+	glnvg__checkError(gl, "batch");
+
+	glnvg__drawElements(gl, batch->indexOffset, batch->indexCount);
+}
+#endif
+
+#if NANOVG_GL_USE_PERSISTENT_BUFFERS
+// copies this flush's uniforms and batch indices into the upload ring, 0 leaves them to glBufferData
+static int glnvg__ringUpload(GLNVGcontext* gl, size_t* paintBase)
+{
+	GLsizeiptr fragBytes = (GLsizeiptr)gl->nuniforms * gl->fragSize;
+	GLsizeiptr indexBytes = 0, paintBytes = 0;
+	unsigned char* dst;
+
+	gl->drawFragBuf = gl->fragBuf;
+	gl->fragBase = 0;
+	gl->indexBase = 0;
+	*paintBase = 0;
+
+	if (gl->uploadRing.buf == 0) return 0;
+	if (gl->nbatches > 0) {
+		indexBytes = (GLsizeiptr)gl->nindices * sizeof(GLuint);
+		paintBytes = gl->nverts;
+	}
+	if (!glnvg__ringReserve(gl, &gl->uploadRing, fragBytes + indexBytes + paintBytes)) return 0;
+
+	// uniforms first, segments start at the uniform buffer offset alignment
+	dst = glnvg__ringAcquire(&gl->uploadRing);
+	memcpy(dst, gl->uniforms, fragBytes);
+	if (gl->nbatches > 0) {
+		memcpy(dst + fragBytes, gl->indices, indexBytes);
+		memcpy(dst + fragBytes + indexBytes, gl->paintIndices, paintBytes);
+	}
+
+	gl->drawFragBuf = gl->uploadRing.buf;
+	gl->fragBase = glnvg__ringOffset(&gl->uploadRing);
+	gl->indexBase = gl->fragBase + fragBytes;
+	*paintBase = (size_t)(gl->indexBase + indexBytes);
+	return 1;
+}
+#endif
+
 static void glnvg__renderFlush(void* uptr)
 {
 	GLNVGcontext* gl = (GLNVGcontext*)uptr;
 	int i;
+	size_t vertBase = 0;
+#if NANOVG_GL_USE_BATCHING
+	int batch = 0;
+	GLuint program;
+#endif
+#if NANOVG_GL_USE_PERSISTENT_BUFFERS
+	int ringUpload;
+	size_t paintBase;
+#endif
+
+	gl->flushDrawCalls = 0;
+	gl->flushVerts = gl->nverts;
 
 	if (gl->ncalls > 0) {
 
+#if NANOVG_GL_USE_BATCHING
+		// adds the batch paints to the uniforms, so before the upload
+		glnvg__buildBatches(gl);
+		program = gl->shader.prog;
+#endif
+
 		// Setup require GL state.
 		glUseProgram(gl->shader.prog);
 
@@ -1251,22 +1745,64 @@ static void glnvg__renderFlush(void* uptr)
 		gl->blendFunc.dstAlpha = GL_INVALID_ENUM;
 		#endif
 
+#if NANOVG_GL_USE_PERSISTENT_BUFFERS
+		ringUpload = glnvg__ringUpload(gl, &paintBase);
+		if (!ringUpload)
+#endif
 #if NANOVG_GL_USE_UNIFORMBUFFER
-		// Upload ubo for frag shaders
-		glBindBuffer(GL_UNIFORM_BUFFER, gl->fragBuf);
-		glBufferData(GL_UNIFORM_BUFFER, gl->nuniforms * gl->fragSize, gl->uniforms, GL_STREAM_DRAW);
+		{
+			// Upload ubo for frag shaders
+			glBindBuffer(GL_UNIFORM_BUFFER, gl->fragBuf);
+			glBufferData(GL_UNIFORM_BUFFER, gl->nuniforms * gl->fragSize, gl->uniforms, GL_STREAM_DRAW);
+		}
 #endif
 
 		// Upload vertex data
 #if defined NANOVG_GL3
 		glBindVertexArray(gl->vertArr);
 #endif
-		glBindBuffer(GL_ARRAY_BUFFER, gl->vertBuf);
-		glBufferData(GL_ARRAY_BUFFER, gl->nverts * sizeof(NVGvertex), gl->verts, GL_STREAM_DRAW);
+#if NANOVG_GL_USE_PERSISTENT_BUFFERS
+		if (gl->mappedVerts != NULL) {
+			// written in place by the render callbacks
+			glBindBuffer(GL_ARRAY_BUFFER, gl->vertRing.buf);
+			vertBase = (size_t)glnvg__ringOffset(&gl->vertRing);
+		} else
+#endif
+		{
+			glBindBuffer(GL_ARRAY_BUFFER, gl->vertBuf);
+			glBufferData(GL_ARRAY_BUFFER, gl->nverts * sizeof(NVGvertex), gl->verts, GL_STREAM_DRAW);
+		}
 		glEnableVertexAttribArray(0);
 		glEnableVertexAttribArray(1);
-		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(NVGvertex), (const GLvoid*)(size_t)0);
-		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(NVGvertex), (const GLvoid*)(0 + 2*sizeof(float)));
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(NVGvertex), (const GLvoid*)vertBase);
+		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(NVGvertex), (const GLvoid*)(vertBase + 2*sizeof(float)));
+
+#if NANOVG_GL_USE_BATCHING
+		if (gl->nbatches > 0) {
+#if NANOVG_GL_USE_PERSISTENT_BUFFERS
+			if (ringUpload) {
+				glBindBuffer(GL_ARRAY_BUFFER, gl->uploadRing.buf);
+				glEnableVertexAttribArray(2);
+				glVertexAttribPointer(2, 1, GL_UNSIGNED_BYTE, GL_FALSE, 1, (const GLvoid*)paintBase);
+				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gl->uploadRing.buf);
+			} else
+#endif
+			{
+				glBindBuffer(GL_ARRAY_BUFFER, gl->paintBuf);
+				glBufferData(GL_ARRAY_BUFFER, gl->nverts, gl->paintIndices, GL_STREAM_DRAW);
+				glEnableVertexAttribArray(2);
+				glVertexAttribPointer(2, 1, GL_UNSIGNED_BYTE, GL_FALSE, 1, (const GLvoid*)0);
+
+				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gl->indexBuf);
+				glBufferData(GL_ELEMENT_ARRAY_BUFFER, gl->nindices * sizeof(GLuint), gl->indices, GL_STREAM_DRAW);
+			}
+
+			glUseProgram(gl->batchShader.prog);
+			glUniform1i(gl->batchShader.loc[GLNVG_LOC_TEX], 0);
+			glUniform2fv(gl->batchShader.loc[GLNVG_LOC_VIEWSIZE], 1, gl->view);
+			glUseProgram(gl->shader.prog);
+		}
+#endif
 
 		// Set view and texture just once per frame.
 		glUniform1i(gl->shader.loc[GLNVG_LOC_TEX], 0);
@@ -1279,6 +1815,16 @@ static void glnvg__renderFlush(void* uptr)
 		for (i = 0; i < gl->ncalls; i++) {
 			GLNVGcall* call = &gl->calls[i];
 			glnvg__blendFuncSeparate(gl,&call->blendFunc);
+#if NANOVG_GL_USE_BATCHING
+			if (batch < gl->nbatches && gl->batches[batch].firstCall == i) {
+				if (program != gl->batchShader.prog) glUseProgram(program = gl->batchShader.prog);
+				glnvg__drawBatch(gl, &gl->batches[batch]);
+				i += gl->batches[batch].callCount - 1;
+				batch++;
+				continue;
+			}
+			if (program != gl->shader.prog) glUseProgram(program = gl->shader.prog);
+#endif
 			if (call->type == GLNVG_FILL)
 				glnvg__fill(gl, call);
 			else if (call->type == GLNVG_CONVEXFILL)
@@ -1289,8 +1835,20 @@ static void glnvg__renderFlush(void* uptr)
 				glnvg__triangles(gl, call);
 		}
 
+#if NANOVG_GL_USE_PERSISTENT_BUFFERS
+		if (ringUpload)
+			glnvg__ringRelease(&gl->uploadRing);
+		if (gl->mappedVerts != NULL) {
+			glnvg__ringRelease(&gl->vertRing);
+			gl->mappedVerts = NULL;
+		}
+#endif
+
 		glDisableVertexAttribArray(0);
 		glDisableVertexAttribArray(1);
+#if NANOVG_GL_USE_BATCHING
+		if (gl->nbatches > 0) glDisableVertexAttribArray(2);
+#endif
 #if defined NANOVG_GL3
 		glBindVertexArray(0);
 #endif
@@ -1300,6 +1858,14 @@ static void glnvg__renderFlush(void* uptr)
 		glnvg__bindTexture(gl, 0);
 	}
 
+#if NANOVG_GL_USE_PERSISTENT_BUFFERS
+	// the frame went on in the cpu array, make the ring big enough for the next ones
+	if (gl->vertOverflow) {
+		glnvg__ringReserve(gl, &gl->vertRing, (GLsizeiptr)gl->flushVerts * sizeof(NVGvertex));
+		gl->vertOverflow = 0;
+	}
+#endif
+
 	// Reset calls
 	gl->nverts = 0;
 	gl->npaths = 0;
@@ -1352,6 +1918,19 @@ static int glnvg__allocPaths(GLNVGcontext* gl, int n)
 static int glnvg__allocVerts(GLNVGcontext* gl, int n)
 {
 	int ret = 0;
+#if NANOVG_GL_USE_PERSISTENT_BUFFERS
+	if (gl->nverts == 0 && gl->vertRing.buf != 0 && !gl->vertOverflow)
+		gl->mappedVerts = (NVGvertex*)glnvg__ringAcquire(&gl->vertRing);
+	if (gl->mappedVerts != NULL) {
+		if ((GLsizeiptr)(gl->nverts + n) * (GLsizeiptr)sizeof(NVGvertex) <= gl->vertRing.segmentSize) {
+			ret = gl->nverts;
+			gl->nverts += n;
+			return ret;
+		}
+		// out of ring space, the rest of the frame goes to the cpu array
+		gl->vertOverflow = 1;
+	}
+#endif
 	if (gl->nverts+n > gl->cverts) {
 		NVGvertex* verts;
 		int cverts = glnvg__maxi(gl->nverts + n, 4096) + gl->cverts/2; // 1.5x Overallocate
@@ -1360,6 +1939,12 @@ static int glnvg__allocVerts(GLNVGcontext* gl, int n)
 		gl->verts = verts;
 		gl->cverts = cverts;
 	}
+#if NANOVG_GL_USE_PERSISTENT_BUFFERS
+	if (gl->mappedVerts != NULL) {
+		memcpy(gl->verts, gl->mappedVerts, sizeof(NVGvertex) * gl->nverts);
+		gl->mappedVerts = NULL;
+	}
+#endif
 	ret = gl->nverts;
 	gl->nverts += n;
 	return ret;
@@ -1386,6 +1971,14 @@ static GLNVGfragUniforms* nvg__fragUniformPtr(GLNVGcontext* gl, int i)
 	return (GLNVGfragUniforms*)&gl->uniforms[i];
 }
 
+static NVGvertex* glnvg__vertPtr(GLNVGcontext* gl, int i)
+{
+#if NANOVG_GL_USE_PERSISTENT_BUFFERS
+	if (gl->mappedVerts != NULL) return &gl->mappedVerts[i];
+#endif
+	return &gl->verts[i];
+}
+
 static void glnvg__vset(NVGvertex* vtx, float x, float y, float u, float v)
 {
 	vtx->x = x;
@@ -1431,13 +2024,13 @@ static void glnvg__renderFill(void* uptr, NVGpaint* paint, NVGcompositeOperation
 		if (path->nfill > 0) {
 			copy->fillOffset = offset;
 			copy->fillCount = path->nfill;
-			memcpy(&gl->verts[offset], path->fill, sizeof(NVGvertex) * path->nfill);
+			memcpy(glnvg__vertPtr(gl, offset), path->fill, sizeof(NVGvertex) * path->nfill);
 			offset += path->nfill;
 		}
 		if (path->nstroke > 0) {
 			copy->strokeOffset = offset;
 			copy->strokeCount = path->nstroke;
-			memcpy(&gl->verts[offset], path->stroke, sizeof(NVGvertex) * path->nstroke);
+			memcpy(glnvg__vertPtr(gl, offset), path->stroke, sizeof(NVGvertex) * path->nstroke);
 			offset += path->nstroke;
 		}
 	}
@@ -1446,7 +2039,7 @@ static void glnvg__renderFill(void* uptr, NVGpaint* paint, NVGcompositeOperation
 	if (call->type == GLNVG_FILL) {
 		// Quad
 		call->triangleOffset = offset;
-		quad = &gl->verts[call->triangleOffset];
+		quad = glnvg__vertPtr(gl, call->triangleOffset);
 		glnvg__vset(&quad[0], bounds[2], bounds[3], 0.5f, 1.0f);
 		glnvg__vset(&quad[1], bounds[2], bounds[1], 0.5f, 1.0f);
 		glnvg__vset(&quad[2], bounds[0], bounds[3], 0.5f, 1.0f);
@@ -1504,7 +2097,7 @@ static void glnvg__renderStroke(void* uptr, NVGpaint* paint, NVGcompositeOperati
 		if (path->nstroke) {
 			copy->strokeOffset = offset;
 			copy->strokeCount = path->nstroke;
-			memcpy(&gl->verts[offset], path->stroke, sizeof(NVGvertex) * path->nstroke);
+			memcpy(glnvg__vertPtr(gl, offset), path->stroke, sizeof(NVGvertex) * path->nstroke);
 			offset += path->nstroke;
 		}
 	}
@@ -1550,7 +2143,7 @@ static void glnvg__renderTriangles(void* uptr, NVGpaint* paint, NVGcompositeOper
 	if (call->triangleOffset == -1) goto error;
 	call->triangleCount = nverts;
 
-	memcpy(&gl->verts[call->triangleOffset], verts, sizeof(NVGvertex) * nverts);
+	memcpy(glnvg__vertPtr(gl, call->triangleOffset), verts, sizeof(NVGvertex) * nverts);
 
 	// Fill shader
 	call->uniformOffset = glnvg__allocFragUniforms(gl, 1);
@@ -1574,6 +2167,20 @@ static void glnvg__renderDelete(void* uptr)
 	if (gl == NULL) return;
 
 	glnvg__deleteShader(&gl->shader);
+#if NANOVG_GL_USE_BATCHING
+	glnvg__deleteShader(&gl->batchShader);
+	if (gl->indexBuf != 0)
+		glDeleteBuffers(1, &gl->indexBuf);
+	if (gl->paintBuf != 0)
+		glDeleteBuffers(1, &gl->paintBuf);
+	free(gl->batches);
+	free(gl->indices);
+	free(gl->paintIndices);
+#endif
+#if NANOVG_GL_USE_PERSISTENT_BUFFERS
+	glnvg__ringDelete(&gl->vertRing);
+	glnvg__ringDelete(&gl->uploadRing);
+#endif
 
 #if NANOVG_GL3
 #if NANOVG_GL_USE_UNIFORMBUFFER
@@ -1698,4 +2305,71 @@ GLuint nvglImageHandleGLES3(NVGcontext* ctx, int image)
 	return tex->tex;
 }
 
+#if defined NANOVG_GL2
+void nvglFlushStatsGL2(NVGcontext* ctx, int* drawCalls, int* vertices)
+#elif defined NANOVG_GL3
+void nvglFlushStatsGL3(NVGcontext* ctx, int* drawCalls, int* vertices)
+#elif defined NANOVG_GLES2
+void nvglFlushStatsGLES2(NVGcontext* ctx, int* drawCalls, int* vertices)
+#elif defined NANOVG_GLES3
+void nvglFlushStatsGLES3(NVGcontext* ctx, int* drawCalls, int* vertices)
+#endif
+{
+	GLNVGcontext* gl = (GLNVGcontext*)nvgInternalParams(ctx)->userPtr;
+	if (drawCalls) *drawCalls = gl->flushDrawCalls;
+	if (vertices) *vertices = gl->flushVerts;
+}
+
+#if defined NANOVG_GL2
+void nvglMemoryUsageGL2(NVGcontext* ctx, size_t* cpuBytes, size_t* gpuBytes)
+#elif defined NANOVG_GL3
+void nvglMemoryUsageGL3(NVGcontext* ctx, size_t* cpuBytes, size_t* gpuBytes)
+#elif defined NANOVG_GLES2
+void nvglMemoryUsageGLES2(NVGcontext* ctx, size_t* cpuBytes, size_t* gpuBytes)
+#elif defined NANOVG_GLES3
+void nvglMemoryUsageGLES3(NVGcontext* ctx, size_t* cpuBytes, size_t* gpuBytes)
+#endif
+{
+	GLNVGcontext* gl = (GLNVGcontext*)nvgInternalParams(ctx)->userPtr;
+	size_t cpu = 0, gpu = 0;
+	int i;
+
+	cpu += sizeof(GLNVGcontext);
+	cpu += (size_t)gl->ctextures * sizeof(GLNVGtexture);
+	cpu += (size_t)gl->ccalls * sizeof(GLNVGcall);
+	cpu += (size_t)gl->cpaths * sizeof(GLNVGpath);
+	cpu += (size_t)gl->cverts * sizeof(NVGvertex);
+	cpu += (size_t)gl->cuniforms * gl->fragSize;
+
+#if NANOVG_GL_USE_BATCHING
+	cpu += (size_t)gl->cbatches * sizeof(GLNVGbatch);
+	cpu += (size_t)gl->cindices * sizeof(GLuint);
+	cpu += (size_t)gl->cpaintIndices;
+#endif
+
+#if NANOVG_GL_USE_PERSISTENT_BUFFERS
+	// a ring replaces the buffers respecified below, a ring that couldn't be created leaves them in use
+	gpu += (size_t)(gl->vertRing.segmentSize + gl->uploadRing.segmentSize) * NANOVG_GL_RING_SEGMENTS;
+	if (gl->vertRing.buf == 0)
+#endif
+	// the vertex buffer is respecified with the vertices of every flush
+	gpu += (size_t)gl->flushVerts * sizeof(NVGvertex);
+#if NANOVG_GL_USE_BATCHING
+	if (gl->nbatches > 0
+#if NANOVG_GL_USE_PERSISTENT_BUFFERS
+		&& gl->uploadRing.buf == 0
+#endif
+	)
+		gpu += (size_t)gl->nindices * sizeof(GLuint) + (size_t)gl->flushVerts;
+#endif
+	for (i = 0; i < gl->ntextures; i++) {
+		GLNVGtexture* tex = &gl->textures[i];
+		if (tex->tex == 0 || (tex->flags & NVG_IMAGE_NODELETE) != 0) continue;
+		gpu += (size_t)tex->width * tex->height * (tex->type == NVG_TEXTURE_RGBA ? 4 : 1);
+	}
+
+	if (cpuBytes) *cpuBytes = cpu;
+	if (gpuBytes) *gpuBytes = gpu;
+}
+
 #endif /* NANOVG_GL_IMPLEMENTATION */
@@ -0,0 +1,387 @@
+//
+// Recording back-end for NanoVG: a context that tessellates like any other but keeps the
+// resulting fills, strokes and triangles instead of drawing them. The recording is replayed
+// into a real back-end later, so several recorders can tessellate on separate threads while
+// one thread owns the GL context.
+//
+// Text needs the font atlas of the context that draws it; draw text on the target context.
+// Paint images are passed through as they are, they must be handles of the target context.
+//
+#ifndef NANOVG_RECORD_H
+#define NANOVG_RECORD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// edgeAntiAlias should match the target context, it changes the tessellated geometry.
+NVGcontext* nvgCreateRecorder(int edgeAntiAlias);
+void nvgDeleteRecorder(NVGcontext* ctx);
+
+// Hands everything recorded since the recorder's nvgBeginFrame to the back-end of `target`, in
+// the order it was recorded. Call between nvgBeginFrame and nvgEndFrame of the target, on the
+// thread that owns it. The recording is kept until the recorder's next nvgBeginFrame.
+void nvgrReplay(NVGcontext* recorder, NVGcontext* target);
+
+// Bytes held for calls, paths and vertices.
+size_t nvgrMemoryUsage(NVGcontext* ctx);
+
+// Vertices of everything recorded since nvgBeginFrame, in the order they were recorded.
+const NVGvertex* nvgrVertices(NVGcontext* ctx, int* count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NANOVG_RECORD_H */
+
+#ifdef NANOVG_RECORD_IMPLEMENTATION
+
+#include <stdlib.h>
+#include <string.h>
+#include "nanovg.h"
+
+enum NVGRcallType {
+	NVGR_FILL,
+	NVGR_STROKE,
+	NVGR_TRIANGLES,
+};
+
+struct NVGRcall {
+	int type;
+	NVGpaint paint;
+	NVGcompositeOperationState compositeOperation;
+	NVGscissor scissor;
+	float fringe;
+	float strokeWidth;
+	int lineStyle;
+	float bounds[4];
+	int pathOffset;
+	int pathCount;
+	int vertOffset;
+	int vertCount;
+};
+typedef struct NVGRcall NVGRcall;
+
+struct NVGRcontext {
+	NVGRcall* calls;
+	int ccalls;
+	int ncalls;
+	// fill and stroke point nowhere until the replay, the recorded vertices may still move
+	NVGpath* paths;
+	int* pathVerts; // fill and stroke offset per path
+	int cpaths;
+	int npaths;
+	NVGvertex* verts;
+	int cverts;
+	int nverts;
+	int textureId;
+};
+typedef struct NVGRcontext NVGRcontext;
+
+static int nvgr__maxi(int a, int b) { return a > b ? a : b; }
+
+static NVGRcall* nvgr__allocCall(NVGRcontext* rec)
+{
+	NVGRcall* ret;
+	if (rec->ncalls+1 > rec->ccalls) {
+		NVGRcall* calls;
+		int ccalls = nvgr__maxi(rec->ncalls+1, 128) + rec->ccalls/2; // 1.5x Overallocate
+		calls = (NVGRcall*)realloc(rec->calls, sizeof(NVGRcall) * ccalls);
+		if (calls == NULL) return NULL;
+		rec->calls = calls;
+		rec->ccalls = ccalls;
+	}
+	ret = &rec->calls[rec->ncalls++];
+	memset(ret, 0, sizeof(NVGRcall));
+	return ret;
+}
+
+static int nvgr__allocPaths(NVGRcontext* rec, int n)
+{
+	int ret;
+	if (rec->npaths+n > rec->cpaths) {
+		NVGpath* paths;
+		int* pathVerts;
+		int cpaths = nvgr__maxi(rec->npaths + n, 128) + rec->cpaths/2; // 1.5x Overallocate
+		paths = (NVGpath*)realloc(rec->paths, sizeof(NVGpath) * cpaths);
+		if (paths == NULL) return -1;
+		rec->paths = paths;
+		pathVerts = (int*)realloc(rec->pathVerts, sizeof(int) * 2 * cpaths);
+		if (pathVerts == NULL) return -1;
+		rec->pathVerts = pathVerts;
+		rec->cpaths = cpaths;
+	}
+	ret = rec->npaths;
+	rec->npaths += n;
+	return ret;
+}
+
+static int nvgr__allocVerts(NVGRcontext* rec, int n)
+{
+	int ret;
+	if (rec->nverts+n > rec->cverts) {
+		NVGvertex* verts;
+		int cverts = nvgr__maxi(rec->nverts + n, 4096) + rec->cverts/2; // 1.5x Overallocate
+		verts = (NVGvertex*)realloc(rec->verts, sizeof(NVGvertex) * cverts);
+		if (verts == NULL) return -1;
+		rec->verts = verts;
+		rec->cverts = cverts;
+	}
+	ret = rec->nverts;
+	rec->nverts += n;
+	return ret;
+}
+
+static int nvgr__copyPaths(NVGRcontext* rec, NVGRcall* call, const NVGpath* paths, int npaths)
+{
+	int i, nverts = 0, offset;
+
+	call->pathOffset = nvgr__allocPaths(rec, npaths);
+	if (call->pathOffset == -1) return 0;
+	call->pathCount = npaths;
+
+	for (i = 0; i < npaths; i++)
+		nverts += paths[i].nfill + paths[i].nstroke;
+	offset = nvgr__allocVerts(rec, nverts);
+	if (offset == -1) return 0;
+
+	for (i = 0; i < npaths; i++) {
+		NVGpath* copy = &rec->paths[call->pathOffset + i];
+		int* vertOffsets = &rec->pathVerts[(call->pathOffset + i) * 2];
+		*copy = paths[i];
+		copy->fill = NULL;
+		copy->stroke = NULL;
+		vertOffsets[0] = offset;
+		memcpy(&rec->verts[offset], paths[i].fill, sizeof(NVGvertex) * paths[i].nfill);
+		offset += paths[i].nfill;
+		vertOffsets[1] = offset;
+		memcpy(&rec->verts[offset], paths[i].stroke, sizeof(NVGvertex) * paths[i].nstroke);
+		offset += paths[i].nstroke;
+	}
+	return 1;
+}
+
+static void nvgr__clear(NVGRcontext* rec)
+{
+	rec->ncalls = 0;
+	rec->npaths = 0;
+	rec->nverts = 0;
+}
+
+static int nvgr__renderCreate(void* uptr)
+{
+	NVG_NOTUSED(uptr);
+	return 1;
+}
+
+// only the font atlas asks for textures, nothing recorded refers to them
+static int nvgr__renderCreateTexture(void* uptr, int type, int w, int h, int imageFlags, const unsigned char* data)
+{
+	NVGRcontext* rec = (NVGRcontext*)uptr;
+	NVG_NOTUSED(type);
+	NVG_NOTUSED(w);
+	NVG_NOTUSED(h);
+	NVG_NOTUSED(imageFlags);
+	NVG_NOTUSED(data);
+	return ++rec->textureId;
+}
+
+static int nvgr__renderDeleteTexture(void* uptr, int image)
+{
+	NVG_NOTUSED(uptr);
+	NVG_NOTUSED(image);
+	return 1;
+}
+
+static int nvgr__renderUpdateTexture(void* uptr, int image, int x, int y, int w, int h, const unsigned char* data)
+{
+	NVG_NOTUSED(uptr);
+	NVG_NOTUSED(image);
+	NVG_NOTUSED(x);
+	NVG_NOTUSED(y);
+	NVG_NOTUSED(w);
+	NVG_NOTUSED(h);
+	NVG_NOTUSED(data);
+	return 1;
+}
+
+static int nvgr__renderGetTextureSize(void* uptr, int image, int* w, int* h)
+{
+	NVG_NOTUSED(uptr);
+	NVG_NOTUSED(image);
+	NVG_NOTUSED(w);
+	NVG_NOTUSED(h);
+	return 0;
+}
+
+// called from nvgBeginFrame, a new frame starts a new recording
+static void nvgr__renderViewport(void* uptr, float width, float height, float devicePixelRatio)
+{
+	NVG_NOTUSED(width);
+	NVG_NOTUSED(height);
+	NVG_NOTUSED(devicePixelRatio);
+	nvgr__clear((NVGRcontext*)uptr);
+}
+
+static void nvgr__renderCancel(void* uptr)
+{
+	nvgr__clear((NVGRcontext*)uptr);
+}
+
+// nvgEndFrame, the recording stays until it is replayed
+static void nvgr__renderFlush(void* uptr)
+{
+	NVG_NOTUSED(uptr);
+}
+
+static void nvgr__renderFill(void* uptr, NVGpaint* paint, NVGcompositeOperationState compositeOperation, NVGscissor* scissor, float fringe,
+							 const float* bounds, const NVGpath* paths, int npaths)
+{
+	NVGRcontext* rec = (NVGRcontext*)uptr;
+	NVGRcall* call = nvgr__allocCall(rec);
+	if (call == NULL) return;
+
+	call->type = NVGR_FILL;
+	call->paint = *paint;
+	call->compositeOperation = compositeOperation;
+	call->scissor = *scissor;
+	call->fringe = fringe;
+	memcpy(call->bounds, bounds, sizeof(call->bounds));
+	if (!nvgr__copyPaths(rec, call, paths, npaths)) rec->ncalls--;
+}
+
+static void nvgr__renderStroke(void* uptr, NVGpaint* paint, NVGcompositeOperationState compositeOperation, NVGscissor* scissor, float fringe,
+							   float strokeWidth, int lineStyle, const NVGpath* paths, int npaths)
+{
+	NVGRcontext* rec = (NVGRcontext*)uptr;
+	NVGRcall* call = nvgr__allocCall(rec);
+	if (call == NULL) return;
+
+	call->type = NVGR_STROKE;
+	call->paint = *paint;
+	call->compositeOperation = compositeOperation;
+	call->scissor = *scissor;
+	call->fringe = fringe;
+	call->strokeWidth = strokeWidth;
+	call->lineStyle = lineStyle;
+	if (!nvgr__copyPaths(rec, call, paths, npaths)) rec->ncalls--;
+}
+
+static void nvgr__renderTriangles(void* uptr, NVGpaint* paint, NVGcompositeOperationState compositeOperation, NVGscissor* scissor,
+								  const NVGvertex* verts, int nverts, float fringe)
+{
+	NVGRcontext* rec = (NVGRcontext*)uptr;
+	NVGRcall* call = nvgr__allocCall(rec);
+	if (call == NULL) return;
+
+	call->type = NVGR_TRIANGLES;
+	call->paint = *paint;
+	call->compositeOperation = compositeOperation;
+	call->scissor = *scissor;
+	call->fringe = fringe;
+	call->vertOffset = nvgr__allocVerts(rec, nverts);
+	if (call->vertOffset == -1) {
+		rec->ncalls--;
+		return;
+	}
+	call->vertCount = nverts;
+	memcpy(&rec->verts[call->vertOffset], verts, sizeof(NVGvertex) * nverts);
+}
+
+static void nvgr__renderDelete(void* uptr)
+{
+	NVGRcontext* rec = (NVGRcontext*)uptr;
+	if (rec == NULL) return;
+
+	free(rec->calls);
+	free(rec->paths);
+	free(rec->pathVerts);
+	free(rec->verts);
+	free(rec);
+}
+
+NVGcontext* nvgCreateRecorder(int edgeAntiAlias)
+{
+	NVGparams params;
+	NVGcontext* ctx = NULL;
+	NVGRcontext* rec = (NVGRcontext*)malloc(sizeof(NVGRcontext));
+	if (rec == NULL) goto error;
+	memset(rec, 0, sizeof(NVGRcontext));
+
+	memset(&params, 0, sizeof(params));
+	params.renderCreate = nvgr__renderCreate;
+	params.renderCreateTexture = nvgr__renderCreateTexture;
+	params.renderDeleteTexture = nvgr__renderDeleteTexture;
+	params.renderUpdateTexture = nvgr__renderUpdateTexture;
+	params.renderGetTextureSize = nvgr__renderGetTextureSize;
+	params.renderViewport = nvgr__renderViewport;
+	params.renderCancel = nvgr__renderCancel;
+	params.renderFlush = nvgr__renderFlush;
+	params.renderFill = nvgr__renderFill;
+	params.renderStroke = nvgr__renderStroke;
+	params.renderTriangles = nvgr__renderTriangles;
+	params.renderDelete = nvgr__renderDelete;
+	params.userPtr = rec;
+	params.edgeAntiAlias = edgeAntiAlias;
+
+	ctx = nvgCreateInternal(&params);
+	if (ctx == NULL) goto error;
+
+	return ctx;
+
+error:
+	// 'rec' is freed by nvgDeleteInternal.
+	if (ctx != NULL) nvgDeleteInternal(ctx);
+	return NULL;
+}
+
+void nvgDeleteRecorder(NVGcontext* ctx)
+{
+	nvgDeleteInternal(ctx);
+}
+
+void nvgrReplay(NVGcontext* recorder, NVGcontext* target)
+{
+	NVGRcontext* rec = (NVGRcontext*)nvgInternalParams(recorder)->userPtr;
+	NVGparams* params = nvgInternalParams(target);
+	int i;
+
+	for (i = 0; i < rec->npaths; i++) {
+		NVGpath* path = &rec->paths[i];
+		path->fill = &rec->verts[rec->pathVerts[i*2]];
+		path->stroke = &rec->verts[rec->pathVerts[i*2+1]];
+	}
+
+	for (i = 0; i < rec->ncalls; i++) {
+		NVGRcall* call = &rec->calls[i];
+		if (call->type == NVGR_FILL)
+			params->renderFill(params->userPtr, &call->paint, call->compositeOperation, &call->scissor, call->fringe,
+							   call->bounds, &rec->paths[call->pathOffset], call->pathCount);
+		else if (call->type == NVGR_STROKE)
+			params->renderStroke(params->userPtr, &call->paint, call->compositeOperation, &call->scissor, call->fringe,
+								 call->strokeWidth, call->lineStyle, &rec->paths[call->pathOffset], call->pathCount);
+		else if (call->type == NVGR_TRIANGLES)
+			params->renderTriangles(params->userPtr, &call->paint, call->compositeOperation, &call->scissor,
+									&rec->verts[call->vertOffset], call->vertCount, call->fringe);
+	}
+}
+
+const NVGvertex* nvgrVertices(NVGcontext* ctx, int* count)
+{
+	NVGRcontext* rec = (NVGRcontext*)nvgInternalParams(ctx)->userPtr;
+	*count = rec->nverts;
+	return rec->verts;
+}
+
+size_t nvgrMemoryUsage(NVGcontext* ctx)
+{
+	NVGRcontext* rec = (NVGRcontext*)nvgInternalParams(ctx)->userPtr;
+	size_t bytes = sizeof(NVGRcontext);
+	bytes += (size_t)rec->ccalls * sizeof(NVGRcall);
+	bytes += (size_t)rec->cpaths * (sizeof(NVGpath) + 2 * sizeof(int));
+	bytes += (size_t)rec->cverts * sizeof(NVGvertex);
+	return bytes;
+}
+
+#endif /* NANOVG_RECORD_IMPLEMENTATION */
@@ -0,0 +1,1355 @@
+//
+// Software back-end for NanoVG: rasterizes on the CPU into a caller-owned RGBA buffer, for
+// machines without a GPU. It runs the same pipeline as nanovg_gl.h, with the same triangles,
+// stencil passes, face culling and fragment shader math. The output matches the GL back-ends
+// except where the two rasterizers round differently.
+//
+// The frame is split into bands of rows that are rasterized independently. Pass a parallelFor
+// to spread them over threads. Inner loops use SSE2 where available.
+//
+#ifndef NANOVG_SW_H
+#define NANOVG_SW_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Same values as NVG_ANTIALIAS and NVG_STENCIL_STROKES of the GL back-ends.
+enum NVGSWcreateFlags {
+	NVGSW_ANTIALIAS			= 1<<0,
+	NVGSW_STENCIL_STROKES	= 1<<1,
+};
+
+NVGcontext* nvgCreateSW(int flags);
+void nvgDeleteSW(NVGcontext* ctx);
+
+// The buffer nvgEndFrame draws into: width*height RGBA8 pixels with premultiplied alpha, rows
+// top to bottom, `stride` bytes apart. Frames are drawn over what the buffer holds.
+void nvgswSetTarget(NVGcontext* ctx, unsigned char* pixels, int width, int height, int stride);
+
+// Must call job(data, i) for every i in [0, count) and return once all of them are done. Jobs
+// write disjoint rows of the target.
+typedef void (*NVGSWparallelFor)(void* user, int count, void (*job)(void* data, int index), void* data);
+void nvgswSetParallel(NVGcontext* ctx, NVGSWparallelFor parallelFor, void* user);
+
+// Bytes held for textures, recorded calls and the stencil buffer.
+size_t nvgswMemoryUsage(NVGcontext* ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NANOVG_SW_H */
+
+#ifdef NANOVG_SW_IMPLEMENTATION
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "nanovg.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NANOVG_SW_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#define NANOVG_SW_BAND_HEIGHT 32
+#define NANOVG_SW_SUBPIXEL_BITS 8
+
+enum NVGSWshaderType {
+	NVGSW_SHADER_FILLGRAD,
+	NVGSW_SHADER_FILLIMG,
+	NVGSW_SHADER_SIMPLE,
+	NVGSW_SHADER_IMG
+};
+
+enum NVGSWcallType {
+	NVGSW_NONE = 0,
+	NVGSW_FILL,
+	NVGSW_CONVEXFILL,
+	NVGSW_STROKE,
+	NVGSW_TRIANGLES,
+};
+
+enum NVGSWprimitive {
+	NVGSW_TRIANGLE_LIST,
+	NVGSW_TRIANGLE_STRIP,
+	NVGSW_TRIANGLE_FAN,
+};
+
+enum NVGSWstencilFunc {
+	NVGSW_STENCIL_ALWAYS,
+	NVGSW_STENCIL_EQUAL_ZERO,
+	NVGSW_STENCIL_NOTEQUAL_ZERO,
+};
+
+enum NVGSWstencilOp {
+	NVGSW_STENCIL_KEEP,
+	NVGSW_STENCIL_WINDING, // increment for front faces, decrement for back faces, wrapping
+	NVGSW_STENCIL_INCR,
+	NVGSW_STENCIL_ZERO,
+};
+
+struct NVGSWtexture {
+	int id;
+	int type;
+	int width, height;
+	int flags;
+	unsigned char* data;
+};
+typedef struct NVGSWtexture NVGSWtexture;
+
+// the fragment uniforms of the GL back-end, matrices as 2x3 transforms
+struct NVGSWpaint {
+	float scissorMat[6];
+	float paintMat[6];
+	float innerCol[4];
+	float outerCol[4];
+	float scissorExt[2];
+	float scissorScale[2];
+	float extent[2];
+	float radius;
+	float feather;
+	float strokeMult;
+	float strokeThr;
+	int lineStyle;
+	int texType;
+	int type;
+	int image;
+};
+typedef struct NVGSWpaint NVGSWpaint;
+
+struct NVGSWblend {
+	int srcRGB, dstRGB, srcAlpha, dstAlpha;
+};
+typedef struct NVGSWblend NVGSWblend;
+
+struct NVGSWpath {
+	int fillOffset;
+	int fillCount;
+	int strokeOffset;
+	int strokeCount;
+};
+typedef struct NVGSWpath NVGSWpath;
+
+struct NVGSWcall {
+	int type;
+	int pathOffset;
+	int pathCount;
+	int triangleOffset;
+	int triangleCount;
+	int paintOffset;
+	NVGSWblend blend;
+	float minY, maxY; // in view units, for skipping bands
+};
+typedef struct NVGSWcall NVGSWcall;
+
+struct NVGSWcontext {
+	int flags;
+	float view[2];
+
+	NVGSWtexture* textures;
+	int ntextures;
+	int ctextures;
+	int textureId;
+
+	NVGSWcall* calls;
+	int ccalls;
+	int ncalls;
+	NVGSWpath* paths;
+	int cpaths;
+	int npaths;
+	NVGvertex* verts;
+	int cverts;
+	int nverts;
+	NVGSWpaint* paints;
+	int cpaints;
+	int npaints;
+
+	unsigned char* pixels;
+	int width, height, stride;
+	unsigned char* stencil;
+	int cstencil;
+
+	NVGSWparallelFor parallelFor;
+	void* parallelUser;
+};
+typedef struct NVGSWcontext NVGSWcontext;
+
+// what one pass of a call does with the triangles it draws
+struct NVGSWstate {
+	NVGSWcontext* sw;
+	const NVGSWpaint* paint;
+	const NVGSWtexture* tex;
+	NVGSWblend blend;
+	int stencilFunc;
+	int stencilOp;
+	int writeColor;
+	int cull;
+	float scale[2]; // view units to pixels
+	int y0, y1; // rows of the band
+};
+typedef struct NVGSWstate NVGSWstate;
+
+// attribute planes of a triangle, value = base + dx*px + dy*py at pixel centers
+struct NVGSWplanes {
+	float base[4], dx[4], dy[4]; // u, v, s, t
+};
+typedef struct NVGSWplanes NVGSWplanes;
+
+static int nvgsw__maxi(int a, int b) { return a > b ? a : b; }
+static int nvgsw__mini(int a, int b) { return a < b ? a : b; }
+static float nvgsw__minf(float a, float b) { return a < b ? a : b; }
+static float nvgsw__maxf(float a, float b) { return a > b ? a : b; }
+static float nvgsw__clampf(float a, float mn, float mx) { return a < mn ? mn : (a > mx ? mx : a); }
+
+static float nvgsw__smoothstep(float x)
+{
+	x = nvgsw__clampf(x, 0.0f, 1.0f);
+	return x * x * (3.0f - 2.0f * x);
+}
+
+static float nvgsw__fract(float x)
+{
+	return x - floorf(x);
+}
+
+static long long nvgsw__floorDiv(long long a, long long b)
+{
+	long long q = a / b;
+	if ((a % b != 0) && ((a < 0) != (b < 0))) q--;
+	return q;
+}
+
+static long long nvgsw__ceilDiv(long long a, long long b)
+{
+	return -nvgsw__floorDiv(-a, b);
+}
+
+static NVGSWtexture* nvgsw__allocTexture(NVGSWcontext* sw)
+{
+	NVGSWtexture* tex = NULL;
+	int i;
+
+	for (i = 0; i < sw->ntextures; i++) {
+		if (sw->textures[i].id == 0) {
+			tex = &sw->textures[i];
+			break;
+		}
+	}
+	if (tex == NULL) {
+		if (sw->ntextures+1 > sw->ctextures) {
+			NVGSWtexture* textures;
+			int ctextures = nvgsw__maxi(sw->ntextures+1, 4) + sw->ctextures/2; // 1.5x Overallocate
+			textures = (NVGSWtexture*)realloc(sw->textures, sizeof(NVGSWtexture)*ctextures);
+			if (textures == NULL) return NULL;
+			sw->textures = textures;
+			sw->ctextures = ctextures;
+		}
+		tex = &sw->textures[sw->ntextures++];
+	}
+
+	memset(tex, 0, sizeof(*tex));
+	tex->id = ++sw->textureId;
+	return tex;
+}
+
+static NVGSWtexture* nvgsw__findTexture(NVGSWcontext* sw, int id)
+{
+	int i;
+	for (i = 0; i < sw->ntextures; i++)
+		if (sw->textures[i].id == id)
+			return &sw->textures[i];
+	return NULL;
+}
+
+static int nvgsw__renderCreate(void* uptr)
+{
+	NVG_NOTUSED(uptr);
+	return 1;
+}
+
+static int nvgsw__renderCreateTexture(void* uptr, int type, int w, int h, int imageFlags, const unsigned char* data)
+{
+	NVGSWcontext* sw = (NVGSWcontext*)uptr;
+	NVGSWtexture* tex = nvgsw__allocTexture(sw);
+	size_t bytes = (size_t)w * h * (type == NVG_TEXTURE_RGBA ? 4 : 1);
+
+	if (tex == NULL) return 0;
+
+	// mipmaps aren't generated, images are always sampled from the full size
+	tex->data = (unsigned char*)malloc(bytes);
+	if (tex->data == NULL) {
+		tex->id = 0;
+		return 0;
+	}
+	if (data != NULL) memcpy(tex->data, data, bytes);
+	else memset(tex->data, 0, bytes);
+
+	tex->width = w;
+	tex->height = h;
+	tex->type = type;
+	tex->flags = imageFlags;
+	return tex->id;
+}
+
+static int nvgsw__renderDeleteTexture(void* uptr, int image)
+{
+	NVGSWcontext* sw = (NVGSWcontext*)uptr;
+	NVGSWtexture* tex = nvgsw__findTexture(sw, image);
+	if (tex == NULL) return 0;
+	free(tex->data);
+	memset(tex, 0, sizeof(*tex));
+	return 1;
+}
+
+static int nvgsw__renderUpdateTexture(void* uptr, int image, int x, int y, int w, int h, const unsigned char* data)
+{
+	NVGSWcontext* sw = (NVGSWcontext*)uptr;
+	NVGSWtexture* tex = nvgsw__findTexture(sw, image);
+	int bpp, row;
+
+	if (tex == NULL) return 0;
+
+	// data holds the whole image, like the GL back-end's unpack row length
+	bpp = tex->type == NVG_TEXTURE_RGBA ? 4 : 1;
+	for (row = y; row < y + h; row++) {
+		size_t offset = ((size_t)row * tex->width + x) * bpp;
+		memcpy(tex->data + offset, data + offset, (size_t)w * bpp);
+	}
+	return 1;
+}
+
+static int nvgsw__renderGetTextureSize(void* uptr, int image, int* w, int* h)
+{
+	NVGSWcontext* sw = (NVGSWcontext*)uptr;
+	NVGSWtexture* tex = nvgsw__findTexture(sw, image);
+	if (tex == NULL) return 0;
+	*w = tex->width;
+	*h = tex->height;
+	return 1;
+}
+
+static void nvgsw__renderViewport(void* uptr, float width, float height, float devicePixelRatio)
+{
+	NVGSWcontext* sw = (NVGSWcontext*)uptr;
+	NVG_NOTUSED(devicePixelRatio);
+	sw->view[0] = width;
+	sw->view[1] = height;
+}
+
+static void nvgsw__renderCancel(void* uptr)
+{
+	NVGSWcontext* sw = (NVGSWcontext*)uptr;
+	sw->nverts = 0;
+	sw->npaths = 0;
+	sw->ncalls = 0;
+	sw->npaints = 0;
+}
+
+static NVGcolor nvgsw__premulColor(NVGcolor c)
+{
+	c.r *= c.a;
+	c.g *= c.a;
+	c.b *= c.a;
+	return c;
+}
+
+static int nvgsw__convertPaint(NVGSWcontext* sw, NVGSWpaint* frag, NVGpaint* paint,
+							   NVGscissor* scissor, float width, float fringe, float strokeThr, int lineStyle)
+{
+	NVGSWtexture* tex = NULL;
+	NVGcolor inner = nvgsw__premulColor(paint->innerColor);
+	NVGcolor outer = nvgsw__premulColor(paint->outerColor);
+
+	memset(frag, 0, sizeof(*frag));
+
+	memcpy(frag->innerCol, inner.rgba, sizeof(frag->innerCol));
+	memcpy(frag->outerCol, outer.rgba, sizeof(frag->outerCol));
+	frag->lineStyle = lineStyle;
+
+	if (scissor->extent[0] < -0.5f || scissor->extent[1] < -0.5f) {
+		memset(frag->scissorMat, 0, sizeof(frag->scissorMat));
+		frag->scissorExt[0] = 1.0f;
+		frag->scissorExt[1] = 1.0f;
+		frag->scissorScale[0] = 1.0f;
+		frag->scissorScale[1] = 1.0f;
+	} else {
+		nvgTransformInverse(frag->scissorMat, scissor->xform);
+		frag->scissorExt[0] = scissor->extent[0];
+		frag->scissorExt[1] = scissor->extent[1];
+		frag->scissorScale[0] = sqrtf(scissor->xform[0]*scissor->xform[0] + scissor->xform[2]*scissor->xform[2]) / fringe;
+		frag->scissorScale[1] = sqrtf(scissor->xform[1]*scissor->xform[1] + scissor->xform[3]*scissor->xform[3]) / fringe;
+	}
+
+	memcpy(frag->extent, paint->extent, sizeof(frag->extent));
+	frag->strokeMult = (width*0.5f + fringe*0.5f) / fringe;
+	frag->strokeThr = strokeThr;
+
+	if (paint->image != 0) {
+		tex = nvgsw__findTexture(sw, paint->image);
+		if (tex == NULL) return 0;
+		if ((tex->flags & NVG_IMAGE_FLIPY) != 0) {
+			float m1[6], m2[6];
+			nvgTransformTranslate(m1, 0.0f, frag->extent[1] * 0.5f);
+			nvgTransformMultiply(m1, paint->xform);
+			nvgTransformScale(m2, 1.0f, -1.0f);
+			nvgTransformMultiply(m2, m1);
+			nvgTransformTranslate(m1, 0.0f, -frag->extent[1] * 0.5f);
+			nvgTransformMultiply(m1, m2);
+			nvgTransformInverse(frag->paintMat, m1);
+		} else {
+			nvgTransformInverse(frag->paintMat, paint->xform);
+		}
+		frag->type = NVGSW_SHADER_FILLIMG;
+		frag->image = paint->image;
+
+		if (tex->type == NVG_TEXTURE_RGBA)
+			frag->texType = (tex->flags & NVG_IMAGE_PREMULTIPLIED) ? 0 : 1;
+		else
+			frag->texType = 2;
+	} else {
+		frag->type = NVGSW_SHADER_FILLGRAD;
+		frag->radius = paint->radius;
+		frag->feather = paint->feather;
+		nvgTransformInverse(frag->paintMat, paint->xform);
+	}
+
+	return 1;
+}
+
+static float nvgsw__blendFactor(int factor, const float* src, const float* dst, int channel)
+{
+	switch (factor) {
+		case NVG_ZERO: return 0.0f;
+		case NVG_ONE: return 1.0f;
+		case NVG_SRC_COLOR: return src[channel];
+		case NVG_ONE_MINUS_SRC_COLOR: return 1.0f - src[channel];
+		case NVG_DST_COLOR: return dst[channel];
+		case NVG_ONE_MINUS_DST_COLOR: return 1.0f - dst[channel];
+		case NVG_SRC_ALPHA: return src[3];
+		case NVG_ONE_MINUS_SRC_ALPHA: return 1.0f - src[3];
+		case NVG_DST_ALPHA: return dst[3];
+		case NVG_ONE_MINUS_DST_ALPHA: return 1.0f - dst[3];
+		case NVG_SRC_ALPHA_SATURATE: return channel == 3 ? 1.0f : nvgsw__minf(src[3], 1.0f - dst[3]);
+		default: return -1.0f;
+	}
+}
+
+static NVGSWblend nvgsw__blendCompositeOperation(NVGcompositeOperationState op)
+{
+	NVGSWblend blend;
+	float probe[4] = { 0 };
+	blend.srcRGB = op.srcRGB;
+	blend.dstRGB = op.dstRGB;
+	blend.srcAlpha = op.srcAlpha;
+	blend.dstAlpha = op.dstAlpha;
+	// like the GL back-end, anything unknown falls back to premultiplied source over
+	if (nvgsw__blendFactor(blend.srcRGB, probe, probe, 0) < 0.0f || nvgsw__blendFactor(blend.dstRGB, probe, probe, 0) < 0.0f ||
+		nvgsw__blendFactor(blend.srcAlpha, probe, probe, 3) < 0.0f || nvgsw__blendFactor(blend.dstAlpha, probe, probe, 3) < 0.0f) {
+		blend.srcRGB = NVG_ONE;
+		blend.dstRGB = NVG_ONE_MINUS_SRC_ALPHA;
+		blend.srcAlpha = NVG_ONE;
+		blend.dstAlpha = NVG_ONE_MINUS_SRC_ALPHA;
+	}
+	return blend;
+}
+
+static NVGSWcall* nvgsw__allocCall(NVGSWcontext* sw)
+{
+	NVGSWcall* ret = NULL;
+	if (sw->ncalls+1 > sw->ccalls) {
+		NVGSWcall* calls;
+		int ccalls = nvgsw__maxi(sw->ncalls+1, 128) + sw->ccalls/2; // 1.5x Overallocate
+		calls = (NVGSWcall*)realloc(sw->calls, sizeof(NVGSWcall) * ccalls);
+		if (calls == NULL) return NULL;
+		sw->calls = calls;
+		sw->ccalls = ccalls;
+	}
+	ret = &sw->calls[sw->ncalls++];
+	memset(ret, 0, sizeof(NVGSWcall));
+	return ret;
+}
+
+static int nvgsw__allocPaths(NVGSWcontext* sw, int n)
+{
+	int ret = 0;
+	if (sw->npaths+n > sw->cpaths) {
+		NVGSWpath* paths;
+		int cpaths = nvgsw__maxi(sw->npaths + n, 128) + sw->cpaths/2; // 1.5x Overallocate
+		paths = (NVGSWpath*)realloc(sw->paths, sizeof(NVGSWpath) * cpaths);
+		if (paths == NULL) return -1;
+		sw->paths = paths;
+		sw->cpaths = cpaths;
+	}
+	ret = sw->npaths;
+	sw->npaths += n;
+	return ret;
+}
+
+static int nvgsw__allocVerts(NVGSWcontext* sw, int n)
+{
+	int ret = 0;
+	if (sw->nverts+n > sw->cverts) {
+		NVGvertex* verts;
+		int cverts = nvgsw__maxi(sw->nverts + n, 4096) + sw->cverts/2; // 1.5x Overallocate
+		verts = (NVGvertex*)realloc(sw->verts, sizeof(NVGvertex) * cverts);
+		if (verts == NULL) return -1;
+		sw->verts = verts;
+		sw->cverts = cverts;
+	}
+	ret = sw->nverts;
+	sw->nverts += n;
+	return ret;
+}
+
+static int nvgsw__allocPaints(NVGSWcontext* sw, int n)
+{
+	int ret = 0;
+	if (sw->npaints+n > sw->cpaints) {
+		NVGSWpaint* paints;
+		int cpaints = nvgsw__maxi(sw->npaints + n, 128) + sw->cpaints/2; // 1.5x Overallocate
+		paints = (NVGSWpaint*)realloc(sw->paints, sizeof(NVGSWpaint) * cpaints);
+		if (paints == NULL) return -1;
+		sw->paints = paints;
+		sw->cpaints = cpaints;
+	}
+	ret = sw->npaints;
+	sw->npaints += n;
+	return ret;
+}
+
+static void nvgsw__vset(NVGvertex* vtx, float x, float y, float u, float v)
+{
+	vtx->x = x;
+	vtx->y = y;
+	vtx->u = u;
+	vtx->v = v;
+	vtx->s = 0.0f;
+	vtx->t = 0.0f;
+}
+
+static void nvgsw__extendBounds(NVGSWcall* call, const NVGvertex* verts, int nverts)
+{
+	int i;
+	for (i = 0; i < nverts; i++) {
+		call->minY = nvgsw__minf(call->minY, verts[i].y);
+		call->maxY = nvgsw__maxf(call->maxY, verts[i].y);
+	}
+}
+
+static int nvgsw__copyPaths(NVGSWcontext* sw, NVGSWcall* call, const NVGpath* paths, int npaths, int extra)
+{
+	int i, nverts = extra, offset;
+
+	call->pathOffset = nvgsw__allocPaths(sw, npaths);
+	if (call->pathOffset == -1) return -1;
+	call->pathCount = npaths;
+	call->minY = 1e6f;
+	call->maxY = -1e6f;
+
+	for (i = 0; i < npaths; i++)
+		nverts += paths[i].nfill + paths[i].nstroke;
+	offset = nvgsw__allocVerts(sw, nverts);
+	if (offset == -1) return -1;
+
+	for (i = 0; i < npaths; i++) {
+		NVGSWpath* copy = &sw->paths[call->pathOffset + i];
+		const NVGpath* path = &paths[i];
+		memset(copy, 0, sizeof(NVGSWpath));
+		if (path->nfill > 0) {
+			copy->fillOffset = offset;
+			copy->fillCount = path->nfill;
+			memcpy(&sw->verts[offset], path->fill, sizeof(NVGvertex) * path->nfill);
+			nvgsw__extendBounds(call, path->fill, path->nfill);
+			offset += path->nfill;
+		}
+		if (path->nstroke > 0) {
+			copy->strokeOffset = offset;
+			copy->strokeCount = path->nstroke;
+			memcpy(&sw->verts[offset], path->stroke, sizeof(NVGvertex) * path->nstroke);
+			nvgsw__extendBounds(call, path->stroke, path->nstroke);
+			offset += path->nstroke;
+		}
+	}
+	return offset;
+}
+
+static void nvgsw__renderFill(void* uptr, NVGpaint* paint, NVGcompositeOperationState compositeOperation, NVGscissor* scissor, float fringe,
+							  const float* bounds, const NVGpath* paths, int npaths)
+{
+	NVGSWcontext* sw = (NVGSWcontext*)uptr;
+	NVGSWcall* call = nvgsw__allocCall(sw);
+	NVGvertex* quad;
+	NVGSWpaint* frag;
+	int offset;
+
+	if (call == NULL) return;
+
+	call->type = NVGSW_FILL;
+	call->triangleCount = 4;
+	call->blend = nvgsw__blendCompositeOperation(compositeOperation);
+
+	if (npaths == 1 && paths[0].convex) {
+		call->type = NVGSW_CONVEXFILL;
+		call->triangleCount = 0;	// Bounding box fill quad not needed for convex fill
+	}
+
+	offset = nvgsw__copyPaths(sw, call, paths, npaths, call->triangleCount);
+	if (offset == -1) goto error;
+
+	if (call->type == NVGSW_FILL) {
+		// Quad
+		call->triangleOffset = offset;
+		quad = &sw->verts[call->triangleOffset];
+		nvgsw__vset(&quad[0], bounds[2], bounds[3], 0.5f, 1.0f);
+		nvgsw__vset(&quad[1], bounds[2], bounds[1], 0.5f, 1.0f);
+		nvgsw__vset(&quad[2], bounds[0], bounds[3], 0.5f, 1.0f);
+		nvgsw__vset(&quad[3], bounds[0], bounds[1], 0.5f, 1.0f);
+		nvgsw__extendBounds(call, quad, 4);
+
+		call->paintOffset = nvgsw__allocPaints(sw, 2);
+		if (call->paintOffset == -1) goto error;
+		// Simple shader for stencil
+		frag = &sw->paints[call->paintOffset];
+		memset(frag, 0, sizeof(*frag));
+		frag->strokeThr = -1.0f;
+		frag->type = NVGSW_SHADER_SIMPLE;
+		// Fill shader
+		if (!nvgsw__convertPaint(sw, &sw->paints[call->paintOffset + 1], paint, scissor, fringe, fringe, -1.0f, 0)) goto error;
+	} else {
+		call->paintOffset = nvgsw__allocPaints(sw, 1);
+		if (call->paintOffset == -1) goto error;
+		// Fill shader
+		if (!nvgsw__convertPaint(sw, &sw->paints[call->paintOffset], paint, scissor, fringe, fringe, -1.0f, 0)) goto error;
+	}
+
+	return;
+
+error:
+	// We get here if call alloc was ok, but something else is not.
+	// Roll back the last call to prevent drawing it.
+	if (sw->ncalls > 0) sw->ncalls--;
+}
+
+static void nvgsw__renderStroke(void* uptr, NVGpaint* paint, NVGcompositeOperationState compositeOperation, NVGscissor* scissor, float fringe,
+								float strokeWidth, int lineStyle, const NVGpath* paths, int npaths)
+{
+	NVGSWcontext* sw = (NVGSWcontext*)uptr;
+	NVGSWcall* call = nvgsw__allocCall(sw);
+
+	if (call == NULL) return;
+
+	call->type = NVGSW_STROKE;
+	call->blend = nvgsw__blendCompositeOperation(compositeOperation);
+
+	if (nvgsw__copyPaths(sw, call, paths, npaths, 0) == -1) goto error;
+
+	if (sw->flags & NVGSW_STENCIL_STROKES) {
+		call->paintOffset = nvgsw__allocPaints(sw, 2);
+		if (call->paintOffset == -1) goto error;
+		if (!nvgsw__convertPaint(sw, &sw->paints[call->paintOffset], paint, scissor, strokeWidth, fringe, -1.0f, lineStyle)) goto error;
+		if (!nvgsw__convertPaint(sw, &sw->paints[call->paintOffset + 1], paint, scissor, strokeWidth, fringe, 1.0f - 0.5f/255.0f, lineStyle)) goto error;
+	} else {
+		call->paintOffset = nvgsw__allocPaints(sw, 1);
+		if (call->paintOffset == -1) goto error;
+		if (!nvgsw__convertPaint(sw, &sw->paints[call->paintOffset], paint, scissor, strokeWidth, fringe, -1.0f, lineStyle)) goto error;
+	}
+
+	return;
+
+error:
+	if (sw->ncalls > 0) sw->ncalls--;
+}
+
+static void nvgsw__renderTriangles(void* uptr, NVGpaint* paint, NVGcompositeOperationState compositeOperation, NVGscissor* scissor,
+								   const NVGvertex* verts, int nverts, float fringe)
+{
+	NVGSWcontext* sw = (NVGSWcontext*)uptr;
+	NVGSWcall* call = nvgsw__allocCall(sw);
+	NVGSWpaint* frag;
+
+	if (call == NULL) return;
+
+	call->type = NVGSW_TRIANGLES;
+	call->blend = nvgsw__blendCompositeOperation(compositeOperation);
+
+	call->triangleOffset = nvgsw__allocVerts(sw, nverts);
+	if (call->triangleOffset == -1) goto error;
+	call->triangleCount = nverts;
+	memcpy(&sw->verts[call->triangleOffset], verts, sizeof(NVGvertex) * nverts);
+	call->minY = 1e6f;
+	call->maxY = -1e6f;
+	nvgsw__extendBounds(call, verts, nverts);
+
+	call->paintOffset = nvgsw__allocPaints(sw, 1);
+	if (call->paintOffset == -1) goto error;
+	frag = &sw->paints[call->paintOffset];
+	if (!nvgsw__convertPaint(sw, frag, paint, scissor, 1.0f, fringe, -1.0f, 0)) goto error;
+	frag->type = NVGSW_SHADER_IMG;
+
+	return;
+
+error:
+	if (sw->ncalls > 0) sw->ncalls--;
+}
+
+// Fragment shading, the scalar version is the reference for everything else.
+
+static float nvgsw__sdroundrect(float px, float py, float ex, float ey, float rad)
+{
+	float dx = fabsf(px) - (ex - rad);
+	float dy = fabsf(py) - (ey - rad);
+	float ox = nvgsw__maxf(dx, 0.0f), oy = nvgsw__maxf(dy, 0.0f);
+	return nvgsw__minf(nvgsw__maxf(dx, dy), 0.0f) + sqrtf(ox*ox + oy*oy) - rad;
+}
+
+static float nvgsw__dashed(float u, float v)
+{
+	float fy = nvgsw__fract(v / 4.0f);
+	float w = fy > 0.5f ? 0.0f : 1.0f;
+	fy *= 4.0f;
+	if (fy >= 1.5f) fy -= 1.5f;
+	else if (fy <= 0.5f) fy = 0.5f - fy;
+	else fy = 0.0f;
+	return w * nvgsw__smoothstep(6.0f * (0.25f - (u*u + fy*fy)));
+}
+
+static float nvgsw__dotted(float u, float v)
+{
+	float fy = 4.0f * nvgsw__fract(v / 4.0f) - 0.5f;
+	return nvgsw__smoothstep(6.0f * (0.25f - (u*u + fy*fy)));
+}
+
+static void nvgsw__texel(const NVGSWtexture* tex, int x, int y, float* out)
+{
+	int repeatX = tex->flags & NVG_IMAGE_REPEATX, repeatY = tex->flags & NVG_IMAGE_REPEATY;
+	const unsigned char* p;
+
+	if (repeatX) { x %= tex->width; if (x < 0) x += tex->width; }
+	else x = nvgsw__mini(nvgsw__maxi(x, 0), tex->width - 1);
+	if (repeatY) { y %= tex->height; if (y < 0) y += tex->height; }
+	else y = nvgsw__mini(nvgsw__maxi(y, 0), tex->height - 1);
+
+	if (tex->type == NVG_TEXTURE_RGBA) {
+		p = &tex->data[((size_t)y * tex->width + x) * 4];
+		out[0] = p[0] / 255.0f;
+		out[1] = p[1] / 255.0f;
+		out[2] = p[2] / 255.0f;
+		out[3] = p[3] / 255.0f;
+	} else {
+		// a single channel texture reads as (r, 0, 0, 1)
+		out[0] = tex->data[(size_t)y * tex->width + x] / 255.0f;
+		out[1] = 0.0f;
+		out[2] = 0.0f;
+		out[3] = 1.0f;
+	}
+}
+
+// texture() with the filtering of the GL back-end, no mipmaps
+static void nvgsw__sample(const NVGSWtexture* tex, int texType, float u, float v, float* out)
+{
+	int i;
+
+	if (tex == NULL) {
+		out[0] = out[1] = out[2] = out[3] = 0.0f;
+		return;
+	}
+
+	if (tex->flags & NVG_IMAGE_NEAREST) {
+		nvgsw__texel(tex, (int)floorf(u * tex->width), (int)floorf(v * tex->height), out);
+	} else {
+		float x = u * tex->width - 0.5f, y = v * tex->height - 0.5f;
+		float x0 = floorf(x), y0 = floorf(y);
+		float fx = x - x0, fy = y - y0;
+		float t00[4], t10[4], t01[4], t11[4];
+		nvgsw__texel(tex, (int)x0, (int)y0, t00);
+		nvgsw__texel(tex, (int)x0 + 1, (int)y0, t10);
+		nvgsw__texel(tex, (int)x0, (int)y0 + 1, t01);
+		nvgsw__texel(tex, (int)x0 + 1, (int)y0 + 1, t11);
+		for (i = 0; i < 4; i++) {
+			float top = t00[i] + (t10[i] - t00[i]) * fx;
+			float bottom = t01[i] + (t11[i] - t01[i]) * fx;
+			out[i] = top + (bottom - top) * fy;
+		}
+	}
+
+	if (texType == 1) {
+		out[0] *= out[3];
+		out[1] *= out[3];
+		out[2] *= out[3];
+	} else if (texType == 2) {
+		out[1] = out[2] = out[3] = out[0];
+	}
+}
+
+// Returns 0 where the GL shader discards. (px, py) is the pixel center in view units.
+static int nvgsw__shade(const NVGSWstate* st, float px, float py, const float* attr, float* out)
+{
+	const NVGSWpaint* f = st->paint;
+	float sx, sy, scissor, strokeAlpha = 1.0f;
+	int i;
+
+	if (f->type == NVGSW_SHADER_SIMPLE) {
+		out[0] = out[1] = out[2] = out[3] = 1.0f;
+		return 1;
+	}
+
+	sx = fabsf((f->scissorMat[0]*px + f->scissorMat[2]*py) + f->scissorMat[4]) - f->scissorExt[0];
+	sy = fabsf((f->scissorMat[1]*px + f->scissorMat[3]*py) + f->scissorMat[5]) - f->scissorExt[1];
+	scissor = nvgsw__clampf(0.5f - sx * f->scissorScale[0], 0.0f, 1.0f) * nvgsw__clampf(0.5f - sy * f->scissorScale[1], 0.0f, 1.0f);
+
+	if (st->sw->flags & NVGSW_ANTIALIAS)
+		strokeAlpha = nvgsw__minf(1.0f, (1.0f - fabsf(attr[0]*2.0f - 1.0f)) * f->strokeMult) * nvgsw__minf(1.0f, attr[1]);
+	if (f->lineStyle == 2) strokeAlpha *= nvgsw__dashed(attr[2] * 0.5f, attr[3] * 0.5f);
+	if (f->lineStyle == 3) strokeAlpha *= nvgsw__dotted(attr[2] * 0.5f, attr[3] * 0.5f);
+	if (f->lineStyle == 4) strokeAlpha *= nvgsw__smoothstep(1.0f - 2.0f * fabsf(attr[2] * 0.5f));
+	if (((st->sw->flags & NVGSW_ANTIALIAS) || f->lineStyle > 1) && strokeAlpha < f->strokeThr) return 0;
+
+	if (f->type == NVGSW_SHADER_FILLGRAD) {
+		float ptx = (f->paintMat[0]*px + f->paintMat[2]*py) + f->paintMat[4];
+		float pty = (f->paintMat[1]*px + f->paintMat[3]*py) + f->paintMat[5];
+		float d = nvgsw__clampf((nvgsw__sdroundrect(ptx, pty, f->extent[0], f->extent[1], f->radius) + f->feather*0.5f) / f->feather, 0.0f, 1.0f);
+		for (i = 0; i < 4; i++)
+			out[i] = (f->innerCol[i] + (f->outerCol[i] - f->innerCol[i]) * d) * (strokeAlpha * scissor);
+	} else if (f->type == NVGSW_SHADER_FILLIMG) {
+		float ptx = (f->paintMat[0]*px + f->paintMat[2]*py + f->paintMat[4]) / f->extent[0];
+		float pty = (f->paintMat[1]*px + f->paintMat[3]*py + f->paintMat[5]) / f->extent[1];
+		nvgsw__sample(st->tex, f->texType, ptx, pty, out);
+		for (i = 0; i < 4; i++)
+			out[i] = out[i] * f->innerCol[i] * (strokeAlpha * scissor);
+	} else {
+		nvgsw__sample(st->tex, f->texType, attr[0], attr[1], out);
+		for (i = 0; i < 4; i++)
+			out[i] = out[i] * scissor * f->innerCol[i];
+	}
+	return 1;
+}
+
+
+#ifdef NANOVG_SW_SSE2
+
+static __m128 nvgsw__clamp4(__m128 x)
+{
+	return _mm_min_ps(_mm_max_ps(x, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+}
+
+static __m128 nvgsw__abs4(__m128 x)
+{
+	return _mm_and_ps(x, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)));
+}
+
+// nvgsw__shade for four neighbouring pixels of a gradient paint without line style. Writes the
+// colors channel by channel and returns a mask of the pixels that aren't discarded.
+static int nvgsw__shadeGradient4(const NVGSWstate* st, __m128 px, float py, __m128 u, __m128 v, __m128* out)
+{
+	const NVGSWpaint* f = st->paint;
+	__m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f), half = _mm_set1_ps(0.5f);
+	__m128 sx, sy, scissor, strokeAlpha = one, ptx, pty, dx, dy, ox, oy, d, alpha;
+	int keep = 0xf, i;
+
+	sx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(f->scissorMat[0]), px), _mm_set1_ps(f->scissorMat[2]*py)), _mm_set1_ps(f->scissorMat[4]));
+	sy = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(f->scissorMat[1]), px), _mm_set1_ps(f->scissorMat[3]*py)), _mm_set1_ps(f->scissorMat[5]));
+	sx = _mm_sub_ps(nvgsw__abs4(sx), _mm_set1_ps(f->scissorExt[0]));
+	sy = _mm_sub_ps(nvgsw__abs4(sy), _mm_set1_ps(f->scissorExt[1]));
+	scissor = _mm_mul_ps(nvgsw__clamp4(_mm_sub_ps(half, _mm_mul_ps(sx, _mm_set1_ps(f->scissorScale[0])))),
+						 nvgsw__clamp4(_mm_sub_ps(half, _mm_mul_ps(sy, _mm_set1_ps(f->scissorScale[1])))));
+
+	if (st->sw->flags & NVGSW_ANTIALIAS) {
+		__m128 edge = _mm_sub_ps(one, nvgsw__abs4(_mm_sub_ps(_mm_mul_ps(u, _mm_set1_ps(2.0f)), one)));
+		strokeAlpha = _mm_mul_ps(_mm_min_ps(one, _mm_mul_ps(edge, _mm_set1_ps(f->strokeMult))), _mm_min_ps(one, v));
+		keep = _mm_movemask_ps(_mm_cmpge_ps(strokeAlpha, _mm_set1_ps(f->strokeThr)));
+		if (keep == 0) return 0;
+	}
+
+	ptx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(f->paintMat[0]), px), _mm_set1_ps(f->paintMat[2]*py)), _mm_set1_ps(f->paintMat[4]));
+	pty = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(f->paintMat[1]), px), _mm_set1_ps(f->paintMat[3]*py)), _mm_set1_ps(f->paintMat[5]));
+	dx = _mm_sub_ps(nvgsw__abs4(ptx), _mm_set1_ps(f->extent[0] - f->radius));
+	dy = _mm_sub_ps(nvgsw__abs4(pty), _mm_set1_ps(f->extent[1] - f->radius));
+	ox = _mm_max_ps(dx, zero);
+	oy = _mm_max_ps(dy, zero);
+	d = _mm_add_ps(_mm_min_ps(_mm_max_ps(dx, dy), zero), _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(ox, ox), _mm_mul_ps(oy, oy))));
+	d = _mm_sub_ps(d, _mm_set1_ps(f->radius));
+	d = nvgsw__clamp4(_mm_div_ps(_mm_add_ps(d, _mm_set1_ps(f->feather*0.5f)), _mm_set1_ps(f->feather)));
+
+	alpha = _mm_mul_ps(strokeAlpha, scissor);
+	for (i = 0; i < 4; i++) {
+		__m128 inner = _mm_set1_ps(f->innerCol[i]);
+		__m128 color = _mm_add_ps(inner, _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(f->outerCol[i]), inner), d));
+		out[i] = _mm_mul_ps(color, alpha);
+	}
+	return keep;
+}
+
+#endif
+
+static int nvgsw__isSourceOver(NVGSWblend blend)
+{
+	return blend.srcRGB == NVG_ONE && blend.dstRGB == NVG_ONE_MINUS_SRC_ALPHA &&
+		   blend.srcAlpha == NVG_ONE && blend.dstAlpha == NVG_ONE_MINUS_SRC_ALPHA;
+}
+
+static void nvgsw__blend(NVGSWblend blend, const float* color, unsigned char* pixel)
+{
+	float src[4], dst[4];
+	int i;
+
+#ifdef NANOVG_SW_SSE2
+	if (nvgsw__isSourceOver(blend)) {
+		// src + dst * (1 - src alpha), all four channels at once
+		__m128i zero = _mm_setzero_si128();
+		__m128 s = nvgsw__clamp4(_mm_loadu_ps(color));
+		__m128i d8;
+		int packed;
+		memcpy(&packed, pixel, 4);
+		d8 = _mm_cvtsi32_si128(packed);
+		__m128 d = _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(d8, zero), zero)), _mm_set1_ps(1.0f / 255.0f));
+		__m128 inv = _mm_sub_ps(_mm_set1_ps(1.0f), _mm_shuffle_ps(s, s, _MM_SHUFFLE(3,3,3,3)));
+		__m128 res = nvgsw__clamp4(_mm_add_ps(s, _mm_mul_ps(d, inv)));
+		__m128i r32 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(res, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)));
+		__m128i r16 = _mm_packs_epi32(r32, r32);
+		packed = _mm_cvtsi128_si32(_mm_packus_epi16(r16, r16));
+		memcpy(pixel, &packed, 4);
+		return;
+	}
+#endif
+
+	for (i = 0; i < 4; i++) {
+		src[i] = nvgsw__clampf(color[i], 0.0f, 1.0f);
+		dst[i] = pixel[i] * (1.0f / 255.0f);
+	}
+	for (i = 0; i < 4; i++) {
+		float sf = nvgsw__blendFactor(i == 3 ? blend.srcAlpha : blend.srcRGB, src, dst, i);
+		float df = nvgsw__blendFactor(i == 3 ? blend.dstAlpha : blend.dstRGB, src, dst, i);
+		float res = nvgsw__clampf(src[i] * sf + dst[i] * df, 0.0f, 1.0f);
+		pixel[i] = (unsigned char)(res * 255.0f + 0.5f);
+	}
+}
+
+static int nvgsw__stencilTest(int func, unsigned char value)
+{
+	switch (func) {
+		case NVGSW_STENCIL_EQUAL_ZERO: return value == 0;
+		case NVGSW_STENCIL_NOTEQUAL_ZERO: return value != 0;
+		default: return 1;
+	}
+}
+
+static unsigned char nvgsw__stencilOp(int op, unsigned char value, int front)
+{
+	switch (op) {
+		case NVGSW_STENCIL_WINDING: return (unsigned char)(front ? value + 1 : value - 1);
+		case NVGSW_STENCIL_INCR: return value < 255 ? value + 1 : 255;
+		case NVGSW_STENCIL_ZERO: return 0;
+		default: return value;
+	}
+}
+
+// Shades and blends the pixels [x0, x1] of row y, with the triangle's attribute planes.
+static void nvgsw__span(const NVGSWstate* st, const NVGSWplanes* pl, int y, int x0, int x1, int front)
+{
+	NVGSWcontext* sw = st->sw;
+	unsigned char* stencil = &sw->stencil[(size_t)y * sw->width];
+	unsigned char* row = &sw->pixels[(size_t)y * sw->stride];
+	float yc = y + 0.5f, py = yc / st->scale[1];
+	float attrRow[4], attr[4], color[4];
+	int x = x0, i;
+
+	// only the stencil passes don't write color, their paints never discard
+	if (!st->writeColor) {
+		if (st->stencilOp == NVGSW_STENCIL_KEEP) return;
+		for (; x <= x1; x++)
+			if (nvgsw__stencilTest(st->stencilFunc, stencil[x]))
+				stencil[x] = nvgsw__stencilOp(st->stencilOp, stencil[x], front);
+		return;
+	}
+
+	for (i = 0; i < 4; i++)
+		attrRow[i] = pl->base[i] + pl->dy[i] * yc;
+
+#ifdef NANOVG_SW_SSE2
+	if (st->paint->type == NVGSW_SHADER_FILLGRAD && st->paint->lineStyle <= 1) {
+		__m128 lanes = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+		__m128 scale = _mm_set1_ps(st->scale[0]);
+		// the last group masks off the pixels past the span instead of leaving them to the
+		// scalar loop, spans of fan triangles are short
+		for (; x <= x1; x += 4) {
+			__m128 xc = _mm_add_ps(_mm_set1_ps((float)x), lanes), out[4];
+			__m128 u = _mm_add_ps(_mm_set1_ps(attrRow[0]), _mm_mul_ps(_mm_set1_ps(pl->dx[0]), xc));
+			__m128 v = _mm_add_ps(_mm_set1_ps(attrRow[1]), _mm_mul_ps(_mm_set1_ps(pl->dx[1]), xc));
+			float colors[4][4];
+			int pass = 0, keep;
+			for (i = 0; i < 4 && x + i <= x1; i++)
+				if (nvgsw__stencilTest(st->stencilFunc, stencil[x + i])) pass |= 1 << i;
+			if (pass == 0) continue;
+			keep = nvgsw__shadeGradient4(st, _mm_div_ps(xc, scale), py, u, v, out) & pass;
+			if (keep == 0) continue;
+			_MM_TRANSPOSE4_PS(out[0], out[1], out[2], out[3]);
+			for (i = 0; i < 4; i++)
+				_mm_storeu_ps(colors[i], out[i]);
+			for (i = 0; i < 4; i++) {
+				if ((keep & (1 << i)) == 0) continue;
+				stencil[x + i] = nvgsw__stencilOp(st->stencilOp, stencil[x + i], front);
+				nvgsw__blend(st->blend, colors[i], &row[(x + i) * 4]);
+			}
+		}
+	}
+#endif
+
+	for (; x <= x1; x++) {
+		float xc = x + 0.5f;
+		if (!nvgsw__stencilTest(st->stencilFunc, stencil[x])) continue;
+		for (i = 0; i < 4; i++)
+			attr[i] = attrRow[i] + pl->dx[i] * xc;
+		if (!nvgsw__shade(st, xc / st->scale[0], py, attr, color)) continue;
+		stencil[x] = nvgsw__stencilOp(st->stencilOp, stencil[x], front);
+		nvgsw__blend(st->blend, color, &row[x * 4]);
+	}
+}
+
+// Half-open edge test in 8 bit sub-pixels: an edge owns the pixel centers exactly on it when it
+// runs down the screen, or flat to the left, so shared edges are drawn once.
+static void nvgsw__triangle(const NVGSWstate* st, const NVGvertex* a, const NVGvertex* b, const NVGvertex* c)
+{
+	const float one = (float)(1 << NANOVG_SW_SUBPIXEL_BITS);
+	const long long half = 1 << (NANOVG_SW_SUBPIXEL_BITS - 1);
+	const NVGvertex* v[3];
+	long long x[3], y[3], area, minY, maxY, ex[3], ey[3], bias[3];
+	float fx[3], fy[3], det;
+	NVGSWplanes pl;
+	int i, front, rowMin, rowMax, row;
+
+	v[0] = a; v[1] = b; v[2] = c;
+	for (i = 0; i < 3; i++) {
+		fx[i] = v[i]->x * st->scale[0];
+		fy[i] = v[i]->y * st->scale[1];
+		x[i] = (long long)floorf(fx[i] * one + 0.5f);
+		y[i] = (long long)floorf(fy[i] * one + 0.5f);
+	}
+
+	// counter-clockwise in GL window coordinates, where y points up
+	area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+	if (area == 0) return;
+	front = area < 0;
+	if (st->cull && !front) return;
+	if (area < 0) {
+		const NVGvertex* tv = v[1]; v[1] = v[2]; v[2] = tv;
+		{ long long t = x[1]; x[1] = x[2]; x[2] = t; }
+		{ long long t = y[1]; y[1] = y[2]; y[2] = t; }
+		{ float t = fx[1]; fx[1] = fx[2]; fx[2] = t; }
+		{ float t = fy[1]; fy[1] = fy[2]; fy[2] = t; }
+	}
+
+	minY = y[0] < y[1] ? (y[0] < y[2] ? y[0] : y[2]) : (y[1] < y[2] ? y[1] : y[2]);
+	maxY = y[0] > y[1] ? (y[0] > y[2] ? y[0] : y[2]) : (y[1] > y[2] ? y[1] : y[2]);
+	rowMin = nvgsw__maxi((int)nvgsw__ceilDiv(minY - half, 1LL << NANOVG_SW_SUBPIXEL_BITS), st->y0);
+	rowMax = nvgsw__mini((int)nvgsw__floorDiv(maxY - half, 1LL << NANOVG_SW_SUBPIXEL_BITS), st->y1 - 1);
+	if (rowMin > rowMax) return;
+
+	for (i = 0; i < 3; i++) {
+		int j = (i + 1) % 3;
+		ex[i] = x[j] - x[i];
+		ey[i] = y[j] - y[i];
+		bias[i] = (ey[i] < 0 || (ey[i] == 0 && ex[i] < 0)) ? 0 : 1;
+	}
+
+	// attributes as planes over pixel coordinates, like the linear varyings of the GL pipeline
+	det = (fx[1] - fx[0]) * (fy[2] - fy[0]) - (fy[1] - fy[0]) * (fx[2] - fx[0]);
+	if (det == 0.0f) return;
+	for (i = 0; i < 4; i++) {
+		float a0 = i == 0 ? v[0]->u : i == 1 ? v[0]->v : i == 2 ? v[0]->s : v[0]->t;
+		float a1 = i == 0 ? v[1]->u : i == 1 ? v[1]->v : i == 2 ? v[1]->s : v[1]->t;
+		float a2 = i == 0 ? v[2]->u : i == 1 ? v[2]->v : i == 2 ? v[2]->s : v[2]->t;
+		float d1 = a1 - a0, d2 = a2 - a0;
+		pl.dx[i] = (d1 * (fy[2] - fy[0]) - d2 * (fy[1] - fy[0])) / det;
+		pl.dy[i] = (d2 * (fx[1] - fx[0]) - d1 * (fx[2] - fx[0])) / det;
+		pl.base[i] = a0 - pl.dx[i] * fx[0] - pl.dy[i] * fy[0];
+	}
+
+	for (row = rowMin; row <= rowMax; row++) {
+		long long py = ((long long)row << NANOVG_SW_SUBPIXEL_BITS) + half;
+		long long colMin = 0, colMax = st->sw->width - 1;
+		for (i = 0; i < 3; i++) {
+			// E(px) = ex * (py - y) - ey * (px - x) >= bias, with px = col * one + half
+			long long k = -ey[i];
+			long long m = ex[i] * (py - y[i]) + ey[i] * x[i] + k * half - bias[i];
+			if (k > 0) {
+				long long lo = nvgsw__ceilDiv(-m, k << NANOVG_SW_SUBPIXEL_BITS);
+				if (lo > colMin) colMin = lo;
+			} else if (k < 0) {
+				long long hi = nvgsw__floorDiv(m, (-k) << NANOVG_SW_SUBPIXEL_BITS);
+				if (hi < colMax) colMax = hi;
+			} else if (m < 0) {
+				colMax = -1;
+			}
+		}
+		if (colMin <= colMax)
+			nvgsw__span(st, &pl, row, (int)colMin, (int)colMax, front);
+	}
+}
+
+static void nvgsw__drawArrays(const NVGSWstate* st, int primitive, int offset, int count)
+{
+	const NVGvertex* verts = &st->sw->verts[offset];
+	int i;
+
+	switch (primitive) {
+		case NVGSW_TRIANGLE_LIST:
+			for (i = 0; i + 2 < count; i += 3)
+				nvgsw__triangle(st, &verts[i], &verts[i + 1], &verts[i + 2]);
+			break;
+		case NVGSW_TRIANGLE_STRIP:
+			// odd triangles swap their first two vertices to keep the winding
+			for (i = 0; i + 2 < count; i++) {
+				if (i & 1) nvgsw__triangle(st, &verts[i + 1], &verts[i], &verts[i + 2]);
+				else nvgsw__triangle(st, &verts[i], &verts[i + 1], &verts[i + 2]);
+			}
+			break;
+		case NVGSW_TRIANGLE_FAN:
+			for (i = 0; i + 2 < count; i++)
+				nvgsw__triangle(st, &verts[0], &verts[i + 1], &verts[i + 2]);
+			break;
+	}
+}
+
+static void nvgsw__setPass(NVGSWstate* st, const NVGSWpaint* paint, int stencilFunc, int stencilOp, int writeColor, int cull)
+{
+	st->paint = paint;
+	st->tex = paint->image != 0 ? nvgsw__findTexture(st->sw, paint->image) : NULL;
+	st->stencilFunc = stencilFunc;
+	st->stencilOp = stencilOp;
+	st->writeColor = writeColor;
+	st->cull = cull;
+}
+
+static void nvgsw__fill(NVGSWstate* st, const NVGSWcall* call)
+{
+	NVGSWcontext* sw = st->sw;
+	NVGSWpath* paths = &sw->paths[call->pathOffset];
+	int i, npaths = call->pathCount;
+
+	// Draw shapes
+	nvgsw__setPass(st, &sw->paints[call->paintOffset], NVGSW_STENCIL_ALWAYS, NVGSW_STENCIL_WINDING, 0, 0);
+	for (i = 0; i < npaths; i++)
+		nvgsw__drawArrays(st, NVGSW_TRIANGLE_FAN, paths[i].fillOffset, paths[i].fillCount);
+
+	// Draw anti-aliased pixels
+	if (sw->flags & NVGSW_ANTIALIAS) {
+		nvgsw__setPass(st, &sw->paints[call->paintOffset + 1], NVGSW_STENCIL_EQUAL_ZERO, NVGSW_STENCIL_KEEP, 1, 1);
+		for (i = 0; i < npaths; i++)
+			nvgsw__drawArrays(st, NVGSW_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
+	}
+
+	// Draw fill
+	nvgsw__setPass(st, &sw->paints[call->paintOffset + 1], NVGSW_STENCIL_NOTEQUAL_ZERO, NVGSW_STENCIL_ZERO, 1, 1);
+	nvgsw__drawArrays(st, NVGSW_TRIANGLE_STRIP, call->triangleOffset, call->triangleCount);
+}
+
+static void nvgsw__convexFill(NVGSWstate* st, const NVGSWcall* call)
+{
+	NVGSWcontext* sw = st->sw;
+	NVGSWpath* paths = &sw->paths[call->pathOffset];
+	int i, npaths = call->pathCount;
+
+	nvgsw__setPass(st, &sw->paints[call->paintOffset], NVGSW_STENCIL_ALWAYS, NVGSW_STENCIL_KEEP, 1, 1);
+	for (i = 0; i < npaths; i++) {
+		nvgsw__drawArrays(st, NVGSW_TRIANGLE_FAN, paths[i].fillOffset, paths[i].fillCount);
+		// Draw fringes
+		if (paths[i].strokeCount > 0)
+			nvgsw__drawArrays(st, NVGSW_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
+	}
+}
+
+static void nvgsw__stroke(NVGSWstate* st, const NVGSWcall* call)
+{
+	NVGSWcontext* sw = st->sw;
+	NVGSWpath* paths = &sw->paths[call->pathOffset];
+	int npaths = call->pathCount, i;
+
+	if (sw->flags & NVGSW_STENCIL_STROKES) {
+		// Fill the stroke base without overlap
+		nvgsw__setPass(st, &sw->paints[call->paintOffset + 1], NVGSW_STENCIL_EQUAL_ZERO, NVGSW_STENCIL_INCR, 1, 1);
+		for (i = 0; i < npaths; i++)
+			nvgsw__drawArrays(st, NVGSW_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
+
+		// Draw anti-aliased pixels.
+		nvgsw__setPass(st, &sw->paints[call->paintOffset], NVGSW_STENCIL_EQUAL_ZERO, NVGSW_STENCIL_KEEP, 1, 1);
+		for (i = 0; i < npaths; i++)
+			nvgsw__drawArrays(st, NVGSW_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
+
+		// Clear stencil buffer.
+		nvgsw__setPass(st, &sw->paints[call->paintOffset], NVGSW_STENCIL_ALWAYS, NVGSW_STENCIL_ZERO, 0, 1);
+		for (i = 0; i < npaths; i++)
+			nvgsw__drawArrays(st, NVGSW_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
+	} else {
+		nvgsw__setPass(st, &sw->paints[call->paintOffset], NVGSW_STENCIL_ALWAYS, NVGSW_STENCIL_KEEP, 1, 1);
+		// Draw Strokes
+		for (i = 0; i < npaths; i++)
+			nvgsw__drawArrays(st, NVGSW_TRIANGLE_STRIP, paths[i].strokeOffset, paths[i].strokeCount);
+	}
+}
+
+static void nvgsw__triangles(NVGSWstate* st, const NVGSWcall* call)
+{
+	NVGSWcontext* sw = st->sw;
+	nvgsw__setPass(st, &sw->paints[call->paintOffset], NVGSW_STENCIL_ALWAYS, NVGSW_STENCIL_KEEP, 1, 1);
+	nvgsw__drawArrays(st, NVGSW_TRIANGLE_LIST, call->triangleOffset, call->triangleCount);
+}
+
+// Runs every call over one band of rows. Bands share nothing but the recorded calls.
+static void nvgsw__renderBand(void* data, int index)
+{
+	NVGSWcontext* sw = (NVGSWcontext*)data;
+	NVGSWstate st;
+	int i;
+
+	memset(&st, 0, sizeof(st));
+	st.sw = sw;
+	st.scale[0] = sw->width / sw->view[0];
+	st.scale[1] = sw->height / sw->view[1];
+	st.y0 = index * NANOVG_SW_BAND_HEIGHT;
+	st.y1 = nvgsw__mini(st.y0 + NANOVG_SW_BAND_HEIGHT, sw->height);
+
+	memset(&sw->stencil[(size_t)st.y0 * sw->width], 0, (size_t)(st.y1 - st.y0) * sw->width);
+
+	for (i = 0; i < sw->ncalls; i++) {
+		NVGSWcall* call = &sw->calls[i];
+		if (call->maxY * st.scale[1] < st.y0 || call->minY * st.scale[1] > st.y1) continue;
+		st.blend = call->blend;
+		if (call->type == NVGSW_FILL)
+			nvgsw__fill(&st, call);
+		else if (call->type == NVGSW_CONVEXFILL)
+			nvgsw__convexFill(&st, call);
+		else if (call->type == NVGSW_STROKE)
+			nvgsw__stroke(&st, call);
+		else if (call->type == NVGSW_TRIANGLES)
+			nvgsw__triangles(&st, call);
+	}
+}
+
+static void nvgsw__renderFlush(void* uptr)
+{
+	NVGSWcontext* sw = (NVGSWcontext*)uptr;
+	int i, bands;
+
+	if (sw->ncalls > 0 && sw->pixels != NULL && sw->view[0] > 0.0f && sw->view[1] > 0.0f) {
+		size_t stencilSize = (size_t)sw->width * sw->height;
+		if (stencilSize > (size_t)sw->cstencil) {
+			unsigned char* stencil = (unsigned char*)realloc(sw->stencil, stencilSize);
+			if (stencil != NULL) {
+				sw->stencil = stencil;
+				sw->cstencil = (int)stencilSize;
+			}
+		}
+
+		if (stencilSize <= (size_t)sw->cstencil) {
+			bands = (sw->height + NANOVG_SW_BAND_HEIGHT - 1) / NANOVG_SW_BAND_HEIGHT;
+			if (sw->parallelFor != NULL && bands > 1) {
+				sw->parallelFor(sw->parallelUser, bands, nvgsw__renderBand, sw);
+			} else {
+				for (i = 0; i < bands; i++)
+					nvgsw__renderBand(sw, i);
+			}
+		}
+	}
+
+	// Reset calls
+	sw->nverts = 0;
+	sw->npaths = 0;
+	sw->ncalls = 0;
+	sw->npaints = 0;
+}
+
+static void nvgsw__renderDelete(void* uptr)
+{
+	NVGSWcontext* sw = (NVGSWcontext*)uptr;
+	int i;
+	if (sw == NULL) return;
+
+	for (i = 0; i < sw->ntextures; i++)
+		free(sw->textures[i].data);
+	free(sw->textures);
+	free(sw->calls);
+	free(sw->paths);
+	free(sw->verts);
+	free(sw->paints);
+	free(sw->stencil);
+	free(sw);
+}
+
+NVGcontext* nvgCreateSW(int flags)
+{
+	NVGparams params;
+	NVGcontext* ctx = NULL;
+	NVGSWcontext* sw = (NVGSWcontext*)malloc(sizeof(NVGSWcontext));
+	if (sw == NULL) goto error;
+	memset(sw, 0, sizeof(NVGSWcontext));
+
+	memset(&params, 0, sizeof(params));
+	params.renderCreate = nvgsw__renderCreate;
+	params.renderCreateTexture = nvgsw__renderCreateTexture;
+	params.renderDeleteTexture = nvgsw__renderDeleteTexture;
+	params.renderUpdateTexture = nvgsw__renderUpdateTexture;
+	params.renderGetTextureSize = nvgsw__renderGetTextureSize;
+	params.renderViewport = nvgsw__renderViewport;
+	params.renderCancel = nvgsw__renderCancel;
+	params.renderFlush = nvgsw__renderFlush;
+	params.renderFill = nvgsw__renderFill;
+	params.renderStroke = nvgsw__renderStroke;
+	params.renderTriangles = nvgsw__renderTriangles;
+	params.renderDelete = nvgsw__renderDelete;
+	params.userPtr = sw;
+	params.edgeAntiAlias = flags & NVGSW_ANTIALIAS ? 1 : 0;
+
+	sw->flags = flags;
+
+	ctx = nvgCreateInternal(&params);
+	if (ctx == NULL) goto error;
+
+	return ctx;
+
+error:
+	// 'sw' is freed by nvgDeleteInternal.
+	if (ctx != NULL) nvgDeleteInternal(ctx);
+	return NULL;
+}
+
+void nvgDeleteSW(NVGcontext* ctx)
+{
+	nvgDeleteInternal(ctx);
+}
+
+void nvgswSetTarget(NVGcontext* ctx, unsigned char* pixels, int width, int height, int stride)
+{
+	NVGSWcontext* sw = (NVGSWcontext*)nvgInternalParams(ctx)->userPtr;
+	sw->pixels = pixels;
+	sw->width = width;
+	sw->height = height;
+	sw->stride = stride;
+}
+
+void nvgswSetParallel(NVGcontext* ctx, NVGSWparallelFor parallelFor, void* user)
+{
+	NVGSWcontext* sw = (NVGSWcontext*)nvgInternalParams(ctx)->userPtr;
+	sw->parallelFor = parallelFor;
+	sw->parallelUser = user;
+}
+
+size_t nvgswMemoryUsage(NVGcontext* ctx)
+{
+	NVGSWcontext* sw = (NVGSWcontext*)nvgInternalParams(ctx)->userPtr;
+	size_t bytes = sizeof(NVGSWcontext);
+	int i;
+	for (i = 0; i < sw->ntextures; i++)
+		if (sw->textures[i].id != 0)
+			bytes += (size_t)sw->textures[i].width * sw->textures[i].height * (sw->textures[i].type == NVG_TEXTURE_RGBA ? 4 : 1);
+	bytes += (size_t)sw->ctextures * sizeof(NVGSWtexture);
+	bytes += (size_t)sw->ccalls * sizeof(NVGSWcall);
+	bytes += (size_t)sw->cpaths * sizeof(NVGSWpath);
+	bytes += (size_t)sw->cverts * sizeof(NVGvertex);
+	bytes += (size_t)sw->cpaints * sizeof(NVGSWpaint);
+	bytes += (size_t)sw->cstencil;
+	return bytes;
+}
+
+#endif /* NANOVG_SW_IMPLEMENTATION */
@@ -0,0 +1,32 @@
+#include "AllocationCounter.h"
+
+#ifdef QUICKGUI_COUNT_ALLOCATIONS
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<uint64_t> s_allocations{ 0 };
+
+// the array and nothrow forms forward to these, the aligned forms aren't counted
+void* operator new(size_t size) {
+	s_allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* ptr = std::malloc(size ? size : 1)) return ptr;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+	std::free(ptr);
+}
+
+uint64_t allocationCount() {
+	return s_allocations.load(std::memory_order_relaxed);
+}
+#else
+uint64_t allocationCount() {
+	return 0;
+}
+#endif
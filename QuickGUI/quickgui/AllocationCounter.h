@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstdint>
+
+// Number of global operator new calls so far. Only counted when the library is built with
+// QUICKGUI_COUNT_ALLOCATIONS defined (it replaces the global operator new/delete), 0 otherwise.
+uint64_t allocationCount();
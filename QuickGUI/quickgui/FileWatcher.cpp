@@ -0,0 +1,74 @@
+#include "FileWatcher.h"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+// how often the modification time is checked when inotify isn't available
+constexpr auto pollInterval = std::chrono::milliseconds(250);
+
+FileWatcher::FileWatcher(const std::filesystem::path& path)
+	: m_path(std::filesystem::absolute(path))
+{
+	std::error_code ec;
+	m_lastWrite = std::filesystem::last_write_time(m_path, ec);
+
+#ifdef __linux__
+	m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (m_inotify < 0) return;
+
+	m_watch = inotify_add_watch(
+		m_inotify,
+		m_path.parent_path().c_str(),
+		IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE
+	);
+	if (m_watch < 0) {
+		close(m_inotify);
+		m_inotify = -1;
+	}
+#endif
+}
+
+FileWatcher::~FileWatcher() {
+#ifdef __linux__
+	if (m_inotify >= 0) close(m_inotify);
+#endif
+}
+
+bool FileWatcher::changed() {
+#ifdef __linux__
+	if (m_inotify >= 0) {
+		alignas(inotify_event) char buffer[4096];
+		bool hit = false;
+
+		for (;;) {
+			ssize_t length = read(m_inotify, buffer, sizeof(buffer));
+			if (length <= 0) break;
+
+			for (ssize_t offset = 0; offset < length;) {
+				auto event = reinterpret_cast<const inotify_event*>(buffer + offset);
+				if (event->len > 0 && m_path.filename() == event->name) hit = true;
+				offset += sizeof(inotify_event) + event->len;
+			}
+		}
+
+		return hit;
+	}
+#endif
+
+	return pollWriteTime();
+}
+
+bool FileWatcher::pollWriteTime() {
+	auto now = std::chrono::steady_clock::now();
+	if (now - m_lastPoll < pollInterval) return false;
+	m_lastPoll = now;
+
+	std::error_code ec;
+	auto writeTime = std::filesystem::last_write_time(m_path, ec);
+	if (ec || writeTime == m_lastWrite) return false;
+
+	m_lastWrite = writeTime;
+	return true;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+
+// Reports when a file was written. Uses inotify on Linux (watching the directory, so files
+// replaced by editors through a rename are seen too) and polls the modification time elsewhere.
+class FileWatcher {
+public:
+	FileWatcher(const std::filesystem::path& path);
+	~FileWatcher();
+
+	FileWatcher(const FileWatcher&) = delete;
+	FileWatcher& operator =(const FileWatcher&) = delete;
+
+	// true once after every change, cheap enough to call every frame
+	bool changed();
+
+	const std::filesystem::path& path() const { return m_path; }
+
+private:
+	std::filesystem::path m_path;
+
+	int m_inotify{ -1 }, m_watch{ -1 };
+
+	std::filesystem::file_time_type m_lastWrite{};
+	std::chrono::steady_clock::time_point m_lastPoll{};
+
+	bool pollWriteTime();
+};
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "WidgetKey.h"
+
+// Open-addressed (linear probing) hash map from WidgetID to V. The ids are already
+// FNV hashes, they only get a multiplicative mix before being masked into the table.
+// InvalidWidget marks an empty slot, so it can't be used as a key.
+// Inserting may grow the table, which invalidates references to the stored values.
+template <typename V>
+class FlatMap {
+public:
+	V* find(WidgetID key) {
+		if (m_slots.empty()) return nullptr;
+
+		for (size_t i = slotFor(key);; i = (i + 1) & m_mask) {
+			Slot& slot = m_slots[i];
+			if (slot.key == key) return &slot.value;
+			if (slot.key == InvalidWidget) return nullptr;
+		}
+	}
+
+	const V* find(WidgetID key) const {
+		return const_cast<FlatMap*>(this)->find(key);
+	}
+
+	bool contains(WidgetID key) const { return find(key) != nullptr; }
+
+	V& operator [](WidgetID key) {
+		if ((m_count + 1) * 4 > m_slots.size() * 3) grow();
+
+		for (size_t i = slotFor(key);; i = (i + 1) & m_mask) {
+			Slot& slot = m_slots[i];
+			if (slot.key == key) return slot.value;
+			if (slot.key == InvalidWidget) {
+				slot.key = key;
+				slot.value = V();
+				m_count++;
+				return slot.value;
+			}
+		}
+	}
+
+	bool erase(WidgetID key) {
+		if (m_slots.empty()) return false;
+
+		size_t i = slotFor(key);
+		while (m_slots[i].key != key) {
+			if (m_slots[i].key == InvalidWidget) return false;
+			i = (i + 1) & m_mask;
+		}
+
+		// backward shift, pull later entries of the probe chain into the hole
+		for (size_t j = (i + 1) & m_mask; m_slots[j].key != InvalidWidget; j = (j + 1) & m_mask) {
+			size_t home = slotFor(m_slots[j].key);
+			bool reachable = i <= j ? (home > i && home <= j) : (home > i || home <= j);
+			if (reachable) continue;
+
+			m_slots[i].key = m_slots[j].key;
+			m_slots[i].value = std::move(m_slots[j].value);
+			i = j;
+		}
+
+		m_slots[i].key = InvalidWidget;
+		m_slots[i].value = V();
+		m_count--;
+		return true;
+	}
+
+	size_t size() const { return m_count; }
+	size_t memoryUsage() const { return m_slots.capacity() * sizeof(Slot); }
+
+	template <typename Fn>
+	void forEach(Fn&& fn) const {
+		for (auto&& slot : m_slots) {
+			if (slot.key != InvalidWidget) fn(slot.key, slot.value);
+		}
+	}
+
+	void clear() {
+		m_slots.clear();
+		m_count = 0;
+		m_mask = 0;
+	}
+
+private:
+	struct Slot {
+		WidgetID key{ InvalidWidget };
+		V value{};
+	};
+
+	std::vector<Slot> m_slots;
+	size_t m_count{ 0 };
+	size_t m_mask{ 0 };
+
+	size_t slotFor(WidgetID key) const {
+		return size_t((key * 0x9E3779B97F4A7C15ull) >> 32) & m_mask;
+	}
+
+	void grow() {
+		std::vector<Slot> old = std::move(m_slots);
+		size_t capacity = old.empty() ? 64 : old.size() * 2;
+
+		m_slots = std::vector<Slot>(capacity);
+		m_mask = capacity - 1;
+
+		for (auto&& slot : old) {
+			if (slot.key == InvalidWidget) continue;
+
+			size_t i = slotFor(slot.key);
+			while (m_slots[i].key != InvalidWidget) i = (i + 1) & m_mask;
+			m_slots[i].key = slot.key;
+			m_slots[i].value = std::move(slot.value);
+		}
+	}
+};
@@ -0,0 +1,57 @@
+#include "FrameArena.h"
+
+FrameArena::FrameArena(size_t capacity) {
+	m_blocks.reserve(8);
+	addBlock(capacity);
+}
+
+void FrameArena::reset() {
+	m_highWater = std::max(m_highWater, m_used);
+
+	if (m_blocks.size() > 1) {
+		size_t total = capacity();
+		m_blocks.clear();
+		addBlock(total);
+	}
+
+	m_offset = 0;
+	m_used = 0;
+}
+
+std::string_view FrameArena::vformat(std::string_view fmt, std::format_args args) {
+	FrameString str(this);
+	str.reserve(str.capacity() + 1); // past the small string buffer, so the characters live in the arena
+	std::vformat_to(std::back_inserter(str), fmt, args);
+
+	// the string gives its buffer back when it goes out of scope, but deallocating is a no-op,
+	// so the characters stay valid until the reset
+	return std::string_view(str.data(), str.size());
+}
+
+size_t FrameArena::capacity() const {
+	size_t total = 0;
+	for (auto&& block : m_blocks) total += block.size;
+	return total;
+}
+
+void* FrameArena::do_allocate(size_t bytes, size_t alignment) {
+	Block& block = m_blocks.back();
+
+	uintptr_t base = reinterpret_cast<uintptr_t>(block.data.get());
+	uintptr_t aligned = (base + m_offset + alignment - 1) & ~uintptr_t(alignment - 1);
+	size_t end = (aligned - base) + bytes;
+
+	if (end > block.size) {
+		addBlock(std::max(block.size * 2, bytes + alignment));
+		return do_allocate(bytes, alignment);
+	}
+
+	m_used += end - m_offset;
+	m_offset = end;
+	return reinterpret_cast<void*>(aligned);
+}
+
+void FrameArena::addBlock(size_t size) {
+	m_blocks.push_back(Block{ std::make_unique<std::byte[]>(size), size });
+	m_offset = 0;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Bump allocator for things that only live until the end of the gui frame. Deallocation is a
+// no-op, everything is released at once by reset(). Allocations that don't fit the block go to
+// extra blocks, which reset() folds into one block big enough for the whole frame, so once the
+// frames have settled the arena doesn't touch the heap anymore.
+class FrameArena : public std::pmr::memory_resource {
+public:
+	explicit FrameArena(size_t capacity = 64 * 1024);
+
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator =(const FrameArena&) = delete;
+
+	void reset();
+
+	// `count` value-initialized Ts, valid until the next reset
+	template <typename T>
+	std::span<T> allocateArray(size_t count) {
+		static_assert(std::is_trivially_destructible_v<T>, "the arena never runs destructors");
+		T* data = static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+		std::uninitialized_value_construct_n(data, count);
+		return std::span<T>(data, count);
+	}
+
+	template <typename T>
+	std::span<T> copyArray(std::span<const T> source) {
+		static_assert(std::is_trivially_destructible_v<T>, "the arena never runs destructors");
+		T* data = static_cast<T*>(allocate(sizeof(T) * source.size(), alignof(T)));
+		std::uninitialized_copy(source.begin(), source.end(), data);
+		return std::span<T>(data, source.size());
+	}
+
+	// formats into the arena, the view is valid until the next reset
+	template <typename... Args>
+	std::string_view format(std::format_string<Args...> fmt, Args&&... args) {
+		return vformat(fmt.get(), std::make_format_args(args...));
+	}
+	std::string_view vformat(std::string_view fmt, std::format_args args);
+
+	size_t capacity() const;
+	// bytes handed out since the last reset
+	size_t used() const { return m_used; }
+	// most bytes a single frame used so far
+	size_t highWater() const { return m_highWater; }
+
+protected:
+	void* do_allocate(size_t bytes, size_t alignment) override;
+	void do_deallocate(void*, size_t, size_t) override {}
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+	struct Block {
+		std::unique_ptr<std::byte[]> data;
+		size_t size;
+	};
+
+	std::vector<Block> m_blocks;
+	size_t m_offset{ 0 }; // into the last block
+	size_t m_used{ 0 }, m_highWater{ 0 };
+
+	void addBlock(size_t size);
+};
+
+using FrameString = std::pmr::string;
+
+template <typename T>
+using FrameVector = std::pmr::vector<T>;
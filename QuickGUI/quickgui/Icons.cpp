@@ -1,25 +1,61 @@
 #include "Icons.h"
 
-std::string cpToUTF8(int cp) {
-	std::string str(8, '\0');
+#include <algorithm>
+#include <array>
+#include <iterator>
 
-	int n = 0;
-	if (cp < 0x80) n = 1;
-	else if (cp < 0x800) n = 2;
-	else if (cp < 0x10000) n = 3;
-	else if (cp < 0x200000) n = 4;
-	else if (cp < 0x4000000) n = 5;
-	else if (cp <= 0x7fffffff) n = 6;
-	str[n] = '\0';
-	switch (n) {
-		case 6: str[5] = 0x80 | (cp & 0x3f); cp = cp >> 6; cp |= 0x4000000;
-		case 5: str[4] = 0x80 | (cp & 0x3f); cp = cp >> 6; cp |= 0x200000;
-		case 4: str[3] = 0x80 | (cp & 0x3f); cp = cp >> 6; cp |= 0x10000;
-		case 3: str[2] = 0x80 | (cp & 0x3f); cp = cp >> 6; cp |= 0x800;
-		case 2: str[1] = 0x80 | (cp & 0x3f); cp = cp >> 6; cp |= 0xc0;
-		case 1: str[0] = cp;
+struct IconGlyph {
+	uint32_t codepoint;
+	char utf8[4];
+	uint8_t length;
+};
+
+static constexpr IconGlyph encodeGlyph(uint32_t cp) {
+	IconGlyph glyph{ .codepoint = cp, .utf8 = {}, .length = 0 };
+	if (cp < 0x80) {
+		glyph.utf8[0] = char(cp);
+		glyph.length = 1;
+	}
+	else if (cp < 0x800) {
+		glyph.utf8[0] = char(0xC0 | (cp >> 6));
+		glyph.utf8[1] = char(0x80 | (cp & 0x3F));
+		glyph.length = 2;
+	}
+	else if (cp < 0x10000) {
+		glyph.utf8[0] = char(0xE0 | (cp >> 12));
+		glyph.utf8[1] = char(0x80 | ((cp >> 6) & 0x3F));
+		glyph.utf8[2] = char(0x80 | (cp & 0x3F));
+		glyph.length = 3;
+	}
+	else {
+		glyph.utf8[0] = char(0xF0 | (cp >> 18));
+		glyph.utf8[1] = char(0x80 | ((cp >> 12) & 0x3F));
+		glyph.utf8[2] = char(0x80 | ((cp >> 6) & 0x3F));
+		glyph.utf8[3] = char(0x80 | (cp & 0x3F));
+		glyph.length = 4;
 	}
+	return glyph;
+}
+
+static constexpr auto iconGlyphs = [] {
+	std::array<IconGlyph, std::size(iconCodepoints)> glyphs{};
+	for (size_t i = 0; i < glyphs.size(); i++) {
+		glyphs[i] = encodeGlyph(iconCodepoints[i]);
+	}
+	return glyphs;
+}();
+
+static_assert(
+	std::is_sorted(std::begin(iconCodepoints), std::end(iconCodepoints)),
+	"iconCodepoints must be sorted, regenerate Icons.h with fonts/extract.py"
+);
+static_assert(encodeGlyph(IC_INFO).length == 3 && encodeGlyph(IC_ROCKET).length == 4);
 
-	str.erase(std::find(str.begin(), str.end(), '\0'), str.end());
-	return str;
+std::string_view iconUTF8(uint32_t cp) {
+	auto glyph = std::lower_bound(
+		iconGlyphs.begin(), iconGlyphs.end(), cp,
+		[](const IconGlyph& glyph, uint32_t cp) { return glyph.codepoint < cp; }
+	);
+	if (glyph == iconGlyphs.end() || glyph->codepoint != cp) return {};
+	return std::string_view(glyph->utf8, glyph->length);
 }
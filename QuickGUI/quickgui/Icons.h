@@ -1,8 +1,11 @@
 #pragma once
 
-#include <string>
+#include <cstdint>
+#include <string_view>
 
-std::string cpToUTF8(int cp);
+// UTF-8 encoding of an icon codepoint, empty if the codepoint isn't one of the icons below.
+// the strings are static, built at compile time in Icons.cpp.
+std::string_view iconUTF8(uint32_t cp);
 
 #define IC_INFO 0x2139
 #define IC_ARROW_LEFT 0x2190
@@ -266,4 +269,269 @@ std::string cpToUTF8(int cp);
 #define IC_ROCKET 0x1F680
 #define IC_BLOCKED 0x1F6AB
 
-#define ICON(x) cpToUTF8(x)
+// every icon codepoint, sorted
+constexpr uint32_t iconCodepoints[] = {
+	IC_INFO,
+	IC_ARROW_LEFT,
+	IC_ARROW_UP,
+	IC_ARROW_RIGHT,
+	IC_ARROW_BOTTOM,
+	IC_ARROW_UP_LEFT,
+	IC_ARROW_DOWN_RIGHT,
+	IC_ARROW_SWAP,
+	IC_INFINITE,
+	IC_PLUS,
+	IC_MINUS,
+	IC_HOME,
+	IC_KEYBOARD,
+	IC_BACKSPACE,
+	IC_PAUSE,
+	IC_FAST_FORWARD,
+	IC_REWIND,
+	IC_END,
+	IC_BEGIN,
+	IC_HOURGLASS,
+	IC_STOP,
+	IC_TRIANGLE_UP,
+	IC_PLAY,
+	IC_TRIANGLE_RIGHT,
+	IC_TRIANGLE_DOWN,
+	IC_TRIANGLE_LEFT,
+	IC_LIGHT_DARK,
+	IC_CLOUD,
+	IC_STAR_FULL,
+	IC_STAR_EMPTY,
+	IC_TRASH,
+	IC_MENU,
+	IC_MOON,
+	IC_HEART_EMPTY,
+	IC_HEART_FULL,
+	IC_NOTE1,
+	IC_NOTE2,
+	IC_GRID,
+	IC_FLAG,
+	IC_TOOLS,
+	IC_GEAR,
+	IC_WARNING,
+	IC_LIGHTNING,
+	IC_RECORD,
+	IC_CLOUD_ZAP,
+	IC_REEL,
+	IC_PLANE,
+	IC_MAIL,
+	IC_PENCIL,
+	IC_FEATHER,
+	IC_CHECK,
+	IC_X,
+	IC_X_CIRCLE,
+	IC_X_SQUARE,
+	IC_QUESTION,
+	IC_QUOTE,
+	IC_PLUS_CIRCLE,
+	IC_MINUS_CIRCLE,
+	IC_ARROW_RIGHT2,
+	IC_SEND,
+	IC_SHARE,
+	IC_REFRESH_LEFT,
+	IC_REFRESH_RIGHT,
+	IC_ARROW_LEFT2,
+	IC_ARROW_UP2,
+	IC_ARROW_DOWN2,
+	IC_LIST_PLUS,
+	IC_LIST,
+	IC_ARROW_LEFT3,
+	IC_ARROW_RIGHT3,
+	IC_ARROW_UP3,
+	IC_ARROW_DOWN3,
+	IC_PERSON_PLUS,
+	IC_QUESTION_CIRCLE,
+	IC_INFO_CIRCLE,
+	IC_EYE,
+	IC_TAG,
+	IC_CLOUD_UPLOAD,
+	IC_REPLY,
+	IC_REPLY_ALL,
+	IC_CODE,
+	IC_SHARE2,
+	IC_PRINTER,
+	IC_REFRESH2,
+	IC_COMMENT,
+	IC_CHAT,
+	IC_VCARD,
+	IC_DIRECTIONS,
+	IC_PIN,
+	IC_MAP,
+	IC_COMPASS,
+	IC_TRASH2,
+	IC_DOCUMENT_EMPTY,
+	IC_DOCUMENT_TEXT,
+	IC_DOCUMENTS,
+	IC_RECTANGLE,
+	IC_FILE_DRAWER,
+	IC_RSS,
+	IC_SHARE3,
+	IC_SHOPPING_CART,
+	IC_LOGIN,
+	IC_LOGOUT,
+	IC_RIGHT_TRIANGLE,
+	IC_EXPAND,
+	IC_CONTRACT,
+	IC_COPY,
+	IC_WEB_PUBLISH,
+	IC_WINDOW,
+	IC_SPINNER,
+	IC_PIE_CHART,
+	IC_LANGUAGES,
+	IC_WAVES,
+	IC_DATABASE,
+	IC_HDD,
+	IC_BUCKET,
+	IC_THERMOMETER,
+	IC_ARROW_DOWN_CIRCLE,
+	IC_ARROW_LEFT_CIRCLE,
+	IC_ARROW_RIGHT_CIRCLE,
+	IC_ARROW_UP_CIRCLE,
+	IC_CHEVRON_DOWN,
+	IC_CHEVRON_LEFT,
+	IC_CHEVRON_RIGHT,
+	IC_CHEVRON_UP,
+	IC_CHEVRON_THIN_DOWN,
+	IC_CHEVRON_THIN_LEFT,
+	IC_CHEVRON_THIN_RIGHT,
+	IC_CHEVRON_THIN_UP,
+	IC_CHEVRON_BIG_DOWN,
+	IC_CHEVRON_BIG_LEFT,
+	IC_CHEVRON_BIG_RIGHT,
+	IC_CHEVRON_BIG_UP,
+	IC_PROGRESS_0,
+	IC_PROGRESS_1,
+	IC_PROGRESS_2,
+	IC_PROGRESS_3,
+	IC_HISTORY,
+	IC_NETWORK,
+	IC_TRAY_EMPTY,
+	IC_HDD_SAVE,
+	IC_BUOY,
+	IC_TAG2,
+	IC_DOT1,
+	IC_DOT2,
+	IC_DOT3,
+	IC_SUITCASE2,
+	IC_BRANCH,
+	IC_FORK,
+	IC_BRANCH2,
+	IC_BRANCH3,
+	IC_BRANCH4,
+	IC_BRUSH,
+	IC_PAPER_PLANE,
+	IC_MAGNET,
+	IC_SPEEDOMETER,
+	IC_CONE,
+	IC_CC,
+	IC_PERSON_CIRCLE,
+	IC_NO_MONEY,
+	IC_NO_EURO,
+	IC_NO_YEN,
+	IC_GLYPH229,
+	IC_EQUALS_CIRCLE,
+	IC_NO_C,
+	IC_ZERO_CIRCLE,
+	IC_COPY_CIRCLE,
+	IC_BLOCKS_CIRCLE,
+	IC_GITHUB,
+	IC_GITHUB_CIRCLE,
+	IC_FACEBOOK,
+	IC_FACEBOOK2,
+	IC_FACEBOOK3,
+	IC_LINKEDIN,
+	IC_LINKEDIN2,
+	IC_GLYPH254,
+	IC_GLYPH255,
+	IC_GLYPH256,
+	IC_GLYPH257,
+	IC_GLYPH258,
+	IC_GLYPH259,
+	IC_GLYPH260,
+	IC_GLYPH261,
+	IC_SPOTIFY2,
+	IC_SPOTIFY,
+	IC_INSTAGRAM,
+	IC_DROPBOX,
+	IC_SKYPE2,
+	IC_SKYPE,
+	IC_PAYPAL,
+	IC_PICASA,
+	IC_SOUNDCLOUD,
+	IC_MYSPACE,
+	IC_BEHANCE,
+	IC_BOOTSTRAP,
+	IC_STORYBOOK,
+	IC_FLAG1,
+	IC_DROPS_DISABLED,
+	IC_IMAGE_LIST,
+	IC_EARTH,
+	IC_LEAF,
+	IC_MORTARBOARD,
+	IC_MICROPHONE,
+	IC_TICKET,
+	IC_VIDEO,
+	IC_AIM,
+	IC_FILE_MUSIC,
+	IC_TROPHY,
+	IC_LIKE,
+	IC_DISLIKE,
+	IC_SHOPPING_BAG,
+	IC_PERSON,
+	IC_PEOPLE,
+	IC_LIGHTBULB,
+	IC_FATAL,
+	IC_WATERDROPS,
+	IC_WATERDROP,
+	IC_CREDITCARD,
+	IC_MONITOR,
+	IC_SUITCASE,
+	IC_SAVE,
+	IC_CD,
+	IC_FOLDER_OPEN,
+	IC_RECEIPT,
+	IC_CALENDAR,
+	IC_LINE_CHART,
+	IC_BAR_CHART,
+	IC_CLIPBOARD,
+	IC_PAPERCLIP,
+	IC_BOOKMARK_LIST,
+	IC_BOOK,
+	IC_BOOK_OPEN,
+	IC_TELEPHONE,
+	IC_MEGAPHONE,
+	IC_UPLOAD,
+	IC_DOWNLOAD,
+	IC_BOX,
+	IC_ARTICLE,
+	IC_PHONE,
+	IC_WIFI,
+	IC_CAMERA,
+	IC_RANDOM,
+	IC_LOOP,
+	IC_REFRESH,
+	IC_BRIGHTNESS_DOWN,
+	IC_BRIGHTNESS_UP,
+	IC_LIGHT_OFF,
+	IC_LIGHT,
+	IC_BATTERY,
+	IC_SEARCH,
+	IC_KEY,
+	IC_LOCK_CLOSED,
+	IC_LOCK_OPEN,
+	IC_NOTIFICATION,
+	IC_BOOKMARK,
+	IC_LINK,
+	IC_BACK,
+	IC_FLASHLIGHT,
+	IC_CHART_UP,
+	IC_CLOCK_5,
+	IC_ROCKET,
+	IC_BLOCKED,
+};
+
+#define ICON(x) iconUTF8(x)
@@ -0,0 +1,94 @@
+#include "MemoryRegistry.h"
+
+#include <algorithm>
+#include <mutex>
+
+namespace {
+
+struct Reporter {
+	uint64_t id;
+	std::function<MemoryUsage()> report;
+	MemoryEntry entry;
+};
+
+struct Registry {
+	std::mutex mutex;
+	std::vector<Reporter> reporters;
+	uint64_t nextId{ 1 };
+	MemoryUsage total, peakTotal;
+};
+
+Registry& registry() {
+	static Registry r;
+	return r;
+}
+
+}
+
+MemoryReporter::MemoryReporter(std::string name, std::function<MemoryUsage()> report) {
+	auto& reg = registry();
+	std::lock_guard lock(reg.mutex);
+
+	m_id = reg.nextId++;
+	reg.reporters.push_back({ m_id, std::move(report), MemoryEntry{ std::move(name) } });
+}
+
+MemoryReporter::~MemoryReporter() {
+	if (m_id == 0) return;
+
+	auto& reg = registry();
+	std::lock_guard lock(reg.mutex);
+	std::erase_if(reg.reporters, [this](const Reporter& r) { return r.id == m_id; });
+}
+
+MemoryReporter::MemoryReporter(MemoryReporter&& other) noexcept
+	: m_id(other.m_id)
+{
+	other.m_id = 0;
+}
+
+MemoryReporter& MemoryReporter::operator=(MemoryReporter&& other) noexcept {
+	if (this != &other) {
+		MemoryReporter old(std::move(*this));
+		m_id = other.m_id;
+		other.m_id = 0;
+	}
+	return *this;
+}
+
+void MemoryRegistry::sample() {
+	auto& reg = registry();
+	std::lock_guard lock(reg.mutex);
+
+	reg.total = {};
+	for (auto&& r : reg.reporters) {
+		MemoryEntry& e = r.entry;
+		e.current = r.report();
+		e.peak.cpu = std::max(e.peak.cpu, e.current.cpu);
+		e.peak.gpu = std::max(e.peak.gpu, e.current.gpu);
+		reg.total += e.current;
+	}
+
+	reg.peakTotal.cpu = std::max(reg.peakTotal.cpu, reg.total.cpu);
+	reg.peakTotal.gpu = std::max(reg.peakTotal.gpu, reg.total.gpu);
+}
+
+void MemoryRegistry::entries(std::vector<MemoryEntry>& out) {
+	auto& reg = registry();
+	std::lock_guard lock(reg.mutex);
+
+	out.resize(reg.reporters.size());
+	for (size_t i = 0; i < out.size(); i++) out[i] = reg.reporters[i].entry;
+}
+
+MemoryUsage MemoryRegistry::total() {
+	auto& reg = registry();
+	std::lock_guard lock(reg.mutex);
+	return reg.total;
+}
+
+MemoryUsage MemoryRegistry::peakTotal() {
+	auto& reg = registry();
+	std::lock_guard lock(reg.mutex);
+	return reg.peakTotal;
+}
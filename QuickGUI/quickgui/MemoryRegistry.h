@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+struct MemoryUsage {
+	size_t cpu{ 0 }, gpu{ 0 }; // bytes
+
+	MemoryUsage& operator +=(const MemoryUsage& other) {
+		cpu += other.cpu;
+		gpu += other.gpu;
+		return *this;
+	}
+};
+
+struct MemoryEntry {
+	std::string name;
+	MemoryUsage current{}, peak{};
+};
+
+// Keeps a subsystem listed in the MemoryRegistry for as long as it lives. The callback is asked
+// for the current footprint (usually container capacities) whenever the registry is sampled,
+// so reporting costs nothing between samples.
+class MemoryReporter {
+public:
+	MemoryReporter() = default;
+	MemoryReporter(std::string name, std::function<MemoryUsage()> report);
+	~MemoryReporter();
+
+	MemoryReporter(MemoryReporter&& other) noexcept;
+	MemoryReporter& operator=(MemoryReporter&& other) noexcept;
+	MemoryReporter(const MemoryReporter&) = delete;
+	MemoryReporter& operator=(const MemoryReporter&) = delete;
+
+private:
+	uint64_t m_id{ 0 };
+};
+
+// Footprint of every registered subsystem, with the highest value seen per entry since it was
+// registered. Entries disappear with their reporter.
+class MemoryRegistry {
+public:
+	// asks every reporter for its usage and updates the peaks
+	static void sample();
+
+	// as of the last sample, in registration order. `out` is overwritten, keep it across calls
+	// and the names are copied into the strings it already holds
+	static void entries(std::vector<MemoryEntry>& out);
+	static MemoryUsage total();
+	static MemoryUsage peakTotal();
+};
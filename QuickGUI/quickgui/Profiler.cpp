@@ -0,0 +1,379 @@
+#include "Profiler.h"
+
+#include "../glad/glad.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+
+std::atomic<bool> Profiler::s_enabled{ false };
+
+namespace {
+
+constexpr size_t ringCapacity = 1 << 14; // zones kept per thread, power of two
+constexpr uint32_t maxDepth = 64; // deeper zones are counted but not recorded
+constexpr size_t maxGpuZones = 256; // unresolved queries before new gpu zones are dropped
+constexpr uint64_t gpuCalibrationInterval = 1'000'000'000; // ns
+constexpr double statsSmoothing = 0.1;
+constexpr uint32_t statsMaxIdle = 120; // frames without a call before a zone leaves the stats
+
+// single producer (the owning thread), read from the GL thread for stats and trace export.
+// the writer never waits: a reader copies what it wants and then drops anything the writer
+// may have overwritten while it was copying.
+struct ThreadRing {
+	std::string name;
+	uint32_t tid{ 0 };
+	bool owned{ true };
+
+	std::unique_ptr<ProfileEvent[]> events{ new ProfileEvent[ringCapacity] };
+	std::atomic<uint64_t> written{ 0 };
+
+	// owning thread only
+	const char* openNames[maxDepth]{};
+	uint64_t openStarts[maxDepth]{};
+	uint32_t depth{ 0 };
+
+	// newFrame only
+	uint64_t statsRead{ 0 };
+
+	void push(const ProfileEvent& e) {
+		uint64_t w = written.load(std::memory_order_relaxed);
+		events[w & (ringCapacity - 1)] = e;
+		written.store(w + 1, std::memory_order_release);
+	}
+
+	// appends the events from index `from` on that are still in the ring, returns the next index
+	uint64_t read(uint64_t from, std::vector<ProfileEvent>& out) const {
+		uint64_t end = written.load(std::memory_order_acquire);
+		uint64_t first = std::max(from, end > ringCapacity ? end - ringCapacity : 0);
+
+		size_t base = out.size();
+		for (uint64_t i = first; i < end; i++) out.push_back(events[i & (ringCapacity - 1)]);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		uint64_t after = written.load(std::memory_order_relaxed);
+		if (after > ringCapacity && after - ringCapacity > first) {
+			size_t overwritten = size_t(std::min(after - ringCapacity, end) - first);
+			out.erase(out.begin() + base, out.begin() + base + overwritten);
+		}
+		return end;
+	}
+};
+
+struct Registry {
+	std::mutex mutex;
+	std::vector<std::unique_ptr<ThreadRing>> rings;
+	uint32_t nextTid{ 1 };
+
+	ThreadRing* add(const char* name) {
+		auto ring = std::make_unique<ThreadRing>();
+		ring->name = name;
+		ring->tid = nextTid++;
+		rings.push_back(std::move(ring));
+		return rings.back().get();
+	}
+};
+
+Registry& registry() {
+	static Registry r;
+	return r;
+}
+
+// hands the ring back when its thread exits, the next new thread takes it over
+// (the NDI sender thread is started again with every start)
+struct RingOwner {
+	ThreadRing* ring{ nullptr };
+
+	~RingOwner() {
+		if (!ring) return;
+		std::lock_guard lock(registry().mutex);
+		ring->owned = false;
+	}
+};
+
+thread_local RingOwner t_owner;
+thread_local const char* t_threadName = "thread";
+
+ThreadRing& threadRing() {
+	if (!t_owner.ring) {
+		auto& reg = registry();
+		std::lock_guard lock(reg.mutex);
+
+		for (auto&& ring : reg.rings) {
+			if (!ring->owned) {
+				ring->owned = true;
+				ring->name = t_threadName;
+				ring->depth = 0;
+				t_owner.ring = ring.get();
+				break;
+			}
+		}
+		if (!t_owner.ring) t_owner.ring = reg.add(t_threadName);
+	}
+	return *t_owner.ring;
+}
+
+// gpu zones live on the GL thread only, no locking
+struct GpuQuery {
+	GLuint begin, end;
+	const char* name;
+	uint32_t depth;
+};
+
+struct GpuState {
+	ThreadRing* ring{ nullptr };
+	std::vector<GLuint> freeQueries;
+	std::vector<GpuQuery> open, pending; // pending in the order they ended, which is the order they finish
+
+	int64_t offset{ 0 }; // cpu ns - gpu ns
+	uint64_t calibratedAt{ 0 };
+
+	GLuint takeQuery() {
+		GLuint query = 0;
+		if (freeQueries.empty()) glGenQueries(1, &query);
+		else {
+			query = freeQueries.back();
+			freeQueries.pop_back();
+		}
+		return query;
+	}
+
+	void calibrate() {
+		uint64_t cpuNow = Profiler::now();
+		if (calibratedAt != 0 && cpuNow - calibratedAt < gpuCalibrationInterval) return;
+
+		GLint64 gpuNow = 0;
+		glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+		offset = int64_t(cpuNow) - int64_t(gpuNow);
+		calibratedAt = cpuNow;
+	}
+
+	void resolve() {
+		size_t done = 0;
+		for (; done < pending.size(); done++) {
+			auto& query = pending[done];
+
+			GLint available = 0;
+			glGetQueryObjectiv(query.end, GL_QUERY_RESULT_AVAILABLE, &available);
+			if (!available) break;
+
+			if (done == 0) calibrate();
+
+			GLuint64 begin = 0, end = 0;
+			glGetQueryObjectui64v(query.begin, GL_QUERY_RESULT, &begin);
+			glGetQueryObjectui64v(query.end, GL_QUERY_RESULT, &end);
+			ring->push({ query.name, uint64_t(int64_t(begin) + offset), uint64_t(int64_t(end) + offset), query.depth });
+
+			freeQueries.push_back(query.begin);
+			freeQueries.push_back(query.end);
+		}
+		pending.erase(pending.begin(), pending.begin() + done);
+	}
+};
+
+GpuState& gpuState() {
+	static GpuState gpu;
+	return gpu;
+}
+
+const uint64_t s_epoch = Profiler::now();
+
+std::vector<ProfileZoneStats> s_stats;
+double s_frameMs = 0.0;
+uint64_t s_lastFrame = 0;
+
+void updateStats() {
+	std::vector<double> ms(s_stats.size(), 0.0), calls(s_stats.size(), 0.0);
+	std::vector<ProfileEvent> events;
+
+	auto& reg = registry();
+	std::lock_guard lock(reg.mutex);
+
+	for (size_t r = 0; r < reg.rings.size(); r++) {
+		auto& ring = *reg.rings[r];
+		events.clear();
+		ring.statsRead = ring.read(ring.statsRead, events);
+
+		for (auto&& e : events) {
+			auto it = std::find_if(s_stats.begin(), s_stats.end(), [&](const ProfileZoneStats& s) {
+				return s.threadIndex == r && (s.name == e.name || std::strcmp(s.name, e.name) == 0);
+			});
+			size_t index = size_t(it - s_stats.begin());
+			if (it == s_stats.end()) {
+				s_stats.push_back({ ring.name, e.name, 0.0, 0.0, r, 0 });
+				ms.push_back(0.0);
+				calls.push_back(0.0);
+			}
+			ms[index] += double(e.end - e.start) / 1e6;
+			calls[index] += 1.0;
+		}
+	}
+
+	for (size_t i = 0; i < s_stats.size(); i++) {
+		auto& s = s_stats[i];
+		s.ms += (ms[i] - s.ms) * statsSmoothing;
+		s.calls += (calls[i] - s.calls) * statsSmoothing;
+		s.idleFrames = calls[i] > 0.0 ? 0 : s.idleFrames + 1;
+		s.thread = reg.rings[s.threadIndex]->name;
+	}
+
+	std::erase_if(s_stats, [](const ProfileZoneStats& s) { return s.idleFrames > statsMaxIdle; });
+	std::stable_sort(s_stats.begin(), s_stats.end(), [](const ProfileZoneStats& a, const ProfileZoneStats& b) {
+		if (a.threadIndex != b.threadIndex) return a.threadIndex < b.threadIndex;
+		return a.ms > b.ms;
+	});
+}
+
+void writeJSONString(std::ostream& out, std::string_view str) {
+	out << '"';
+	for (char c : str) {
+		if (c == '"' || c == '\\') out << '\\';
+		out << c;
+	}
+	out << '"';
+}
+
+}
+
+void Profiler::setEnabled(bool enabled) {
+	s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Profiler::setThreadName(const char* name) {
+	// the ring itself is only created once the thread records its first zone
+	t_threadName = name;
+	if (!t_owner.ring) return;
+
+	std::lock_guard lock(registry().mutex);
+	t_owner.ring->name = name;
+}
+
+void Profiler::beginZone(const char* name) {
+	auto& ring = threadRing();
+	uint32_t depth = ring.depth++;
+	if (depth < maxDepth) {
+		ring.openNames[depth] = name;
+		ring.openStarts[depth] = now();
+	}
+}
+
+void Profiler::endZone() {
+	auto& ring = threadRing();
+	if (ring.depth == 0) return;
+
+	uint32_t depth = --ring.depth;
+	if (depth < maxDepth) ring.push({ ring.openNames[depth], ring.openStarts[depth], now(), depth });
+}
+
+void Profiler::beginGpuZone(const char* name) {
+	auto& gpu = gpuState();
+	if (!gpu.ring) {
+		std::lock_guard lock(registry().mutex);
+		gpu.ring = registry().add("GPU");
+	}
+
+	// queries that never resolve (lost context, driver trouble) mustn't grow without bound,
+	// a dropped zone keeps its place on the stack so the matching end still pairs up
+	if (gpu.open.size() + gpu.pending.size() >= maxGpuZones) {
+		gpu.open.push_back({ 0, 0, name, uint32_t(gpu.open.size()) });
+		return;
+	}
+
+	GpuQuery query{ gpu.takeQuery(), gpu.takeQuery(), name, uint32_t(gpu.open.size()) };
+	glQueryCounter(query.begin, GL_TIMESTAMP);
+	gpu.open.push_back(query);
+}
+
+void Profiler::endGpuZone() {
+	auto& gpu = gpuState();
+	if (gpu.open.empty()) return;
+
+	GpuQuery query = gpu.open.back();
+	gpu.open.pop_back();
+	if (query.begin == 0) return;
+
+	glQueryCounter(query.end, GL_TIMESTAMP);
+	gpu.pending.push_back(query);
+}
+
+void Profiler::newFrame() {
+	// zones issued before the profiler was switched off still need their queries back
+	if (!gpuState().pending.empty()) gpuState().resolve();
+
+	if (!enabled()) {
+		s_lastFrame = 0;
+		return;
+	}
+
+	uint64_t t = now();
+	if (s_lastFrame != 0) s_frameMs += (double(t - s_lastFrame) / 1e6 - s_frameMs) * statsSmoothing;
+	s_lastFrame = t;
+
+	updateStats();
+}
+
+const std::vector<ProfileZoneStats>& Profiler::stats() {
+	return s_stats;
+}
+
+double Profiler::frameMs() {
+	return s_frameMs;
+}
+
+bool Profiler::writeTrace(const std::string& path) {
+	std::ofstream out(path, std::ios::trunc);
+	if (!out) return false;
+
+	out << std::fixed << std::setprecision(3);
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+	auto& reg = registry();
+	std::lock_guard lock(reg.mutex);
+
+	std::vector<ProfileEvent> events;
+	bool first = true;
+	auto separator = [&] {
+		if (!first) out << ",\n";
+		first = false;
+	};
+
+	for (auto&& ring : reg.rings) {
+		separator();
+		out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << ring->tid << ",\"args\":{\"name\":";
+		writeJSONString(out, ring->name);
+		out << "}}";
+
+		events.clear();
+		ring->read(0, events);
+		for (auto&& e : events) {
+			separator();
+			out << "{\"name\":";
+			writeJSONString(out, e.name);
+			out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << ring->tid
+				<< ",\"ts\":" << double(int64_t(e.start - s_epoch)) / 1000.0
+				<< ",\"dur\":" << double(e.end - e.start) / 1000.0 << "}";
+		}
+	}
+
+	out << "\n]}\n";
+	return out.good();
+}
+
+size_t Profiler::memoryUsage() {
+	auto& reg = registry();
+	std::lock_guard lock(reg.mutex);
+
+	size_t bytes = reg.rings.size() * (sizeof(ThreadRing) + ringCapacity * sizeof(ProfileEvent));
+	bytes += s_stats.capacity() * sizeof(ProfileZoneStats);
+	return bytes;
+}
+
+uint64_t Profiler::now() {
+	return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()
+	).count());
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Scoped CPU zones (PROFILE_ZONE) and GL timer query zones (PROFILE_GPU_ZONE), recorded into a
+// ring per thread. The rings feed the HUD (QuickGUI::profilerHUD) and the Chrome trace export
+// (chrome://tracing or ui.perfetto.dev).
+// Zone names must outlive the profiler (string literals), only the pointer is stored.
+// While disabled a zone costs a relaxed load and a branch, QUICKGUI_NO_PROFILER removes them.
+
+struct ProfileEvent {
+	const char* name;
+	uint64_t start, end; // ns on Profiler::now()
+	uint32_t depth;
+};
+
+struct ProfileZoneStats {
+	std::string thread;
+	const char* name;
+	double ms; // per frame, smoothed
+	double calls; // per frame, smoothed
+
+	size_t threadIndex;
+	uint32_t idleFrames;
+};
+
+class Profiler {
+public:
+	static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+	static void setEnabled(bool enabled);
+
+	// name shown for the calling thread in the HUD and trace
+	static void setThreadName(const char* name);
+
+	static void beginZone(const char* name);
+	static void endZone();
+
+	// GL_TIMESTAMP queries, only on the thread owning the GL context
+	static void beginGpuZone(const char* name);
+	static void endGpuZone();
+
+	// once per frame on the GL thread: reads back finished gpu queries and updates stats()
+	static void newFrame();
+
+	static const std::vector<ProfileZoneStats>& stats();
+	static double frameMs();
+
+	// everything still in the rings
+	static bool writeTrace(const std::string& path);
+
+	// bytes held by the rings and stats
+	static size_t memoryUsage();
+
+	static uint64_t now();
+
+private:
+	static std::atomic<bool> s_enabled;
+};
+
+class ProfileZone {
+public:
+	explicit ProfileZone(const char* name)
+		: m_active(Profiler::enabled())
+	{
+		if (m_active) Profiler::beginZone(name);
+	}
+	~ProfileZone() {
+		if (m_active) Profiler::endZone();
+	}
+
+	ProfileZone(const ProfileZone&) = delete;
+	ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+	bool m_active;
+};
+
+class ProfileGpuZone {
+public:
+	explicit ProfileGpuZone(const char* name)
+		: m_active(Profiler::enabled())
+	{
+		if (m_active) Profiler::beginGpuZone(name);
+	}
+	~ProfileGpuZone() {
+		if (m_active) Profiler::endGpuZone();
+	}
+
+	ProfileGpuZone(const ProfileGpuZone&) = delete;
+	ProfileGpuZone& operator=(const ProfileGpuZone&) = delete;
+
+private:
+	bool m_active;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+#ifdef QUICKGUI_NO_PROFILER
+#define PROFILE_ZONE(name)
+#define PROFILE_GPU_ZONE(name)
+#else
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_GPU_ZONE(name) ProfileGpuZone PROFILE_CONCAT(profileGpuZone, __LINE__)(name)
+#endif
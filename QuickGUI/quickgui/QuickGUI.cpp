@@ -2,10 +2,17 @@
 
 #define NANOVG_GL3_IMPLEMENTATION
 #include "../nanovg/nanovg_gl.h"
+#include "../nanovg/nanovg_gl_utils.h"
 
+#include "AllocationCounter.h"
 #include "Icons.h"
+#include "Profiler.h"
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
 #include <fstream>
 #include <format>
 
@@ -74,18 +81,37 @@ static void hsvToRGB(float h, float s, float v, float& r, float& g, float& b) {
 #pragma endregion
 
 QuickGUI::~QuickGUI() {
+	m_memoryReporters.clear(); // they read the nanovg context
+
+	for (auto&& [radius, fb] : m_hueRings) {
+		if (fb) nvgluDeleteFramebuffer(fb);
+	}
+
 	if (m_context) {
 		nvgDeleteGL3(m_context);
 		m_context = nullptr;
 	}
 }
 
+static double steadySeconds() {
+	using namespace std::chrono;
+	return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
 void QuickGUI::beginFrame(uint32_t width, uint32_t height) {
+	pollStyleSheet();
+
+	m_time = steadySeconds();
+	m_frameAllocationsStart = allocationCount();
+	m_redrawAt = std::numeric_limits<double>::infinity(); // widgets schedule again while drawing
+
 	if (!m_state.mouseDown) m_state.hoveredWidget = InvalidWidget;
 
 	m_state.screenWidth = width;
 	m_state.screenHeight = height;
 
+	bakeHueRings();
+
 	nvgBeginFrame(context(), width, height, float(width) / float(height));
 	nvgFontSize(context(), 13.0f);
 	m_layoutStack.push_back(Rect(0, 0, width, height));
@@ -99,11 +125,56 @@ void QuickGUI::endFrame() {
 	if (!m_state.mouseDown) m_state.activeWidget = InvalidWidget;
 	m_state.mouseDelta.x = 0;
 	m_state.mouseDelta.y = 0;
-	nvgEndFrame(context());
+	{
+		PROFILE_ZONE("QuickGUI::flush");
+		PROFILE_GPU_ZONE("gui");
+		nvgEndFrame(context());
+	}
 	m_layoutStack.clear();
+	m_idStack.clear();
+
+	m_frame++;
+	if (m_frame % gcInterval == 0) {
+		m_widgetStates.collect(m_frame, gcMaxAge, [this](WidgetID id) {
+			return id == m_state.focusedWidget || id == m_state.activeWidget || id == m_openPopup;
+		});
+	}
 	m_state.keyDown = false;
 	m_state.keyUp = false;
 	m_state.mouseScroll = 0.0f;
+
+	if (m_pendingFrames > 0) m_pendingFrames--;
+
+	m_frameArena.reset();
+	m_frameAllocations = allocationCount() - m_frameAllocationsStart;
+}
+
+void QuickGUI::requestRedraw() {
+	m_pendingFrames = redrawFrames;
+}
+
+void QuickGUI::requestRedrawIn(double seconds) {
+	m_redrawAt = std::min(m_redrawAt, steadySeconds() + seconds);
+}
+
+bool QuickGUI::needsRedraw() {
+	if (pollStyleSheet()) return true;
+	return m_pendingFrames > 0 || steadySeconds() >= m_redrawAt;
+}
+
+double QuickGUI::redrawTimeout() const {
+	if (m_pendingFrames > 0) return 0.0;
+	return std::max(0.0, m_redrawAt - steadySeconds());
+}
+
+void QuickGUI::loadFonts(NVGcontext* ctx) {
+	int normal = nvgCreateFont(ctx, "normal", "OpenSans-Regular.ttf");
+	int bold = nvgCreateFont(ctx, "bold", "OpenSans-Bold.ttf");
+	int italic = nvgCreateFont(ctx, "italic", "OpenSans-Italic.ttf");
+	int icons = nvgCreateFont(ctx, "icons", "entypo.ttf");
+	nvgAddFallbackFontId(ctx, normal, icons);
+	nvgAddFallbackFontId(ctx, bold, icons);
+	nvgAddFallbackFontId(ctx, italic, icons);
 }
 
 NVGcontext* QuickGUI::context() {
@@ -114,39 +185,60 @@ NVGcontext* QuickGUI::context() {
 #endif
 		m_context = nvgCreateGL3(flags);
 
-		m_fontNormal = nvgCreateFont(m_context, "normal", "OpenSans-Regular.ttf");
-		m_fontBold = nvgCreateFont(m_context, "bold", "OpenSans-Bold.ttf");
-		m_fontItalic = nvgCreateFont(m_context, "italic", "OpenSans-Italic.ttf");
-		m_fontIcons = nvgCreateFont(m_context, "icons", "entypo.ttf");
-		nvgAddFallbackFontId(m_context, m_fontNormal, m_fontIcons);
-		nvgAddFallbackFontId(m_context, m_fontBold, m_fontIcons);
-		nvgAddFallbackFontId(m_context, m_fontItalic, m_fontIcons);
+		loadFonts(m_context);
 		nvgFontFace(m_context, "normal");
 
-		std::ifstream fp("style.sty");
-		std::string str = std::string(
-			std::istreambuf_iterator<char>(fp),
-			std::istreambuf_iterator<char>()
-		);
-		m_styleSheet.parse(str);
+		m_styleWatcher = std::make_unique<FileWatcher>(StyleSheetPath);
+		reloadStyleSheet();
+
+		registerMemoryReporters();
 	}
 	return m_context;
 }
 
-static WidgetID widgetID(const std::string& id) {
-	return std::hash<std::string>()(id);
+bool QuickGUI::pollStyleSheet() {
+	if (!m_styleWatcher || !m_styleWatcher->changed()) return false;
+
+	reloadStyleSheet();
+	requestRedraw();
+	return true;
 }
 
-Widget QuickGUI::widget(const std::string& id, Rect bounds, bool checkBlocked) {
-	const WidgetID wid = widgetID(id);
+void QuickGUI::reloadStyleSheet() {
+	std::ifstream fp(StyleSheetPath);
+	std::string str = std::string(
+		std::istreambuf_iterator<char>(fp),
+		std::istreambuf_iterator<char>()
+	);
 
-	auto pos = m_widgetState.find(wid);
-	if (pos == m_widgetState.end()) {
-		m_widgetState[wid] = Widget();
-		pos = m_widgetState.find(wid);
+	try {
+		m_styleSheet.parse(str);
+	}
+	catch (const StyleSheetError& e) {
+		// keep drawing with the previous styles until the file is fixed
+		fprintf(stderr, "%s:%s\n", StyleSheetPath, e.what());
 	}
+	resolveStyles();
+}
+
+void QuickGUI::pushID(WidgetKey id) {
+	m_idStack.push_back(makeID(id));
+}
+
+void QuickGUI::popID() {
+	m_idStack.pop_back();
+}
+
+WidgetID QuickGUI::makeID(WidgetKey id) const {
+	return combineID(m_idStack.empty() ? widgetkey::FNVOffset : m_idStack.back(), id);
+}
 
-	Widget& ret = pos->second;
+Widget QuickGUI::widget(WidgetKey id, Rect bounds, bool checkBlocked) {
+	return widgetByID(makeID(id), bounds, checkBlocked);
+}
+
+Widget QuickGUI::widgetByID(WidgetID wid, Rect bounds, bool checkBlocked) {
+	Widget& ret = m_widgetStates.common(wid, m_frame);
 	ret.clicked = false;
 	ret.keyPressed = false;
 	ret.relativeDelta.x = 0;
@@ -165,12 +257,14 @@ Widget QuickGUI::widget(const std::string& id, Rect bounds, bool checkBlocked) {
 	bool insideParentPanel = true;
 	if (!m_panelStack.empty()) {
 		auto panel = m_panelStack.back();
-		auto panelW = m_panels[panel.id];
 		Rect parentRect = panel.bounds;
 
 		// compensate scrolling
-		parentRect.x += panelW.scroll.x;
-		parentRect.y += panelW.scroll.y;
+		if (auto record = m_widgetStates.get(panel.handle)) {
+			auto& panelW = WidgetStateArena::stateOf<Panel>(*record);
+			parentRect.x += panelW.scroll.x;
+			parentRect.y += panelW.scroll.y;
+		}
 		insideParentPanel = parentRect.hasPoint(m_state.mousePosition);
 	}
 
@@ -217,41 +311,34 @@ Widget QuickGUI::widget(const std::string& id, Rect bounds, bool checkBlocked) {
 	return ret;
 }
 
-void QuickGUI::text(const std::string& text, Rect bounds, const std::string& style) {
+StyleId QuickGUI::styleId(std::string_view name) {
+	context();
+	return m_styleSheet.id(name);
+}
+
+void QuickGUI::text(std::string_view text, Rect bounds, StyleId style) {
 	auto ctx = context();
-	m_styleSheet.draw(style, ctx, bounds, text, 0);
+	m_styleSheet.draw(style == InvalidStyle ? m_styles.text : style, ctx, bounds, text, 0);
 }
 
-bool QuickGUI::button(const std::string& id, const std::string& text, Rect bounds, size_t icon) {
+bool QuickGUI::button(WidgetKey id, std::string_view text, Rect bounds, size_t icon) {
+	PROFILE_ZONE("QuickGUI::button");
 	auto ctx = context();
 	auto wd = widget(id, bounds);
 
-	std::string style = "button";
-	switch (wd.state) {
-		case WidgetState::Normal:
-		case WidgetState::Focused: style = "button"; break;
-		case WidgetState::Hovered: style = "button_hover"; break;
-		case WidgetState::Active: style = "button_active"; break;
-		case WidgetState::Disabled: style = "button_disabled"; break;
-	}
+	StyleId style = m_styleSheet.variant(m_styles.button, wd.state);
 	
 	m_styleSheet.draw(style, ctx, bounds, text, icon);
 
 	return wd.clicked;
 }
 
-bool QuickGUI::iconButton(const std::string& id, size_t icon, Rect bounds) {
+bool QuickGUI::iconButton(WidgetKey id, size_t icon, Rect bounds) {
+	PROFILE_ZONE("QuickGUI::iconButton");
 	auto ctx = context();
 	auto wd = widget(id, bounds);
 
-	std::string style = "icon_button";
-	switch (wd.state) {
-		case WidgetState::Normal:
-		case WidgetState::Focused: style = "icon_button"; break;
-		case WidgetState::Hovered: style = "icon_button_hover"; break;
-		case WidgetState::Active: style = "icon_button_active"; break;
-		case WidgetState::Disabled: style = "icon_button_disabled"; break;
-	}
+	StyleId style = m_styleSheet.variant(m_styles.iconButton, wd.state);
 
 	auto element = m_styleSheet.draw(style, ctx, bounds, "", 0);
 	Rect innerBounds = element.bounds;
@@ -263,11 +350,7 @@ bool QuickGUI::iconButton(const std::string& id, size_t icon, Rect bounds) {
 	nvgFontSize(ctx, 23.0f);
 
 	auto ico = ICON(icon);
-	float b[4];
-	nvgTextBounds(ctx, 0.0f, 0.0f, ico.c_str(), nullptr, b);
-
-	float iconWidth = b[2] - b[0];
-	float iconHeight = b[3] - b[1];
+	auto [iconWidth, iconHeight] = m_styleSheet.measureText(ctx, ico);
 	float iconOffX = (innerBounds.width / 2.0f - iconWidth / 2.0f);
 	float iconOffY = (innerBounds.height / 2.0f - iconHeight / 2.0f);
 
@@ -275,8 +358,8 @@ bool QuickGUI::iconButton(const std::string& id, size_t icon, Rect bounds) {
 		ctx,
 		innerBounds.x + iconOffX,
 		innerBounds.y + iconOffY + 1.5f,
-		ico.c_str(),
-		nullptr
+		ico.data(),
+		ico.data() + ico.size()
 	);
 
 	nvgRestore(ctx);
@@ -284,7 +367,8 @@ bool QuickGUI::iconButton(const std::string& id, size_t icon, Rect bounds) {
 	return wd.clicked;
 }
 
-void QuickGUI::checkBox(const std::string& id, const std::string& text, Rect bounds, bool& checked) {
+void QuickGUI::checkBox(WidgetKey id, std::string_view text, Rect bounds, bool& checked) {
+	PROFILE_ZONE("QuickGUI::checkBox");
 	const float boxSize = 22.0f;
 
 	auto ctx = context();
@@ -293,33 +377,30 @@ void QuickGUI::checkBox(const std::string& id, const std::string& text, Rect bou
 	Rect tBounds = bounds;
 	tBounds.x += (boxSize + 5.0f);
 	tBounds.width -= (boxSize + 5.0f);
-	m_styleSheet.draw("text_middle", ctx, tBounds, text, 0);
+	m_styleSheet.draw(m_styles.textMiddle, ctx, tBounds, text, 0);
 
 	Rect pBounds = bounds;
 	pBounds.width = pBounds.height = boxSize;
 	pBounds.y = bounds.y + (bounds.height / 2.0f - boxSize / 2.0f);
-	m_styleSheet.draw("panel", ctx, pBounds, "", checked ? IC_CHECK : 0);
+	m_styleSheet.draw(m_styles.panel, ctx, pBounds, "", checked ? IC_CHECK : 0);
 
 	if (wd.clicked) {
 		checked = !checked;
 	}
 }
 
-void QuickGUI::showPopup(const std::string& id) {
-	m_openPopup = widgetID(id);
+void QuickGUI::showPopup(WidgetKey id) {
+	m_openPopup = makeID(id);
 	m_inputBlocked = true;
 }
 
-bool QuickGUI::popup(const std::string& id, MenuItem* items, size_t numItems, size_t& selected) {
-	auto wid = widgetID(id);
-	auto&& pos = m_popups.find(wid);
-	if (pos == m_popups.end()) {
-		m_popups[wid] = Popup();
-		pos = m_popups.find(wid);
-	}
-
-	pos->second.id = id;
-	pos->second.items = std::vector<MenuItem>(items, items + numItems);
+bool QuickGUI::popup(WidgetKey id, MenuItem* items, size_t numItems, size_t& selected) {
+	PROFILE_ZONE("QuickGUI::popup");
+	auto wid = makeID(id);
+	auto& popup = m_widgetStates.state<Popup>(wid, m_frame);
+	popup.id = wid;
+	popup.items = m_frameArena.copyArray(std::span<const MenuItem>(items, numItems));
+	popup.frame = m_frame;
 
 	if (m_openPopup != wid) return false;
 
@@ -332,10 +413,7 @@ bool QuickGUI::popup(const std::string& id, MenuItem* items, size_t numItems, si
 
 	int width = 0;
 	for (size_t i = 0; i < numItems; i++) {
-		float bounds[4];
-		nvgTextBounds(ctx, 0, 0, items[i].text.c_str(), nullptr, bounds);
-
-		int textWidth = int(bounds[2] - bounds[0]);
+		int textWidth = int(m_styleSheet.measureText(ctx, items[i].text).width);
 		if (items[i].icon) {
 			textWidth += iconSpaceWidth;
 		}
@@ -360,7 +438,7 @@ bool QuickGUI::popup(const std::string& id, MenuItem* items, size_t numItems, si
 		MenuItem item = items[i];
 
 		Rect wdBounds = Rect(bounds.x, y, bounds.width, itemHeight);
-		auto wd = widget(item.text + id, wdBounds, false);
+		auto wd = widgetByID(combineID(wid, WidgetKey::index(i)), wdBounds, false);
 
 		if (wd.clicked) {
 			m_inputBlocked = false;
@@ -393,12 +471,15 @@ static void updateCursor(TextEdit& edit, Rect bounds) {
 	}
 }
 
-static void drawCursor(NVGcontext* ctx, TextEdit& edit, Rect bounds) {
-	edit.blinkTime += 0.07f;
-	if (edit.blinkTime >= 1.0f) {
-		edit.blinkTime = 0.0f;
-		edit.cursorShow = !edit.cursorShow;
-	}
+// the cursor is shown for this many seconds, then hidden for as long
+constexpr double cursorBlinkPeriod = 0.5;
+
+// returns the seconds left until the cursor toggles
+static double drawCursor(NVGcontext* ctx, TextEdit& edit, Rect bounds, double now) {
+	if (edit.blinkStart < 0.0) edit.blinkStart = now;
+
+	double phase = std::fmod(now - edit.blinkStart, cursorBlinkPeriod * 2.0);
+	edit.cursorShow = phase < cursorBlinkPeriod;
 
 	if (edit.cursorShow) {
 		float cursorX = edit.glyphs[edit.cursor].x;
@@ -409,6 +490,8 @@ static void drawCursor(NVGcontext* ctx, TextEdit& edit, Rect bounds) {
 		nvgText(ctx, cursorX - edit.viewOffset, bounds.height / 2, "|", nullptr);
 		nvgRestore(ctx);
 	}
+
+	return cursorBlinkPeriod - std::fmod(phase, cursorBlinkPeriod);
 }
 
 static void lineEditor(
@@ -433,7 +516,7 @@ static void lineEditor(
 			text.insert(text.begin() + edit.cursor, char(guiState.typedChar));
 			edit.cursor++;
 			updateCursor(edit, bounds);
-			edit.blinkTime = 0.0f;
+			edit.blinkStart = -1.0;
 			edit.cursorShow = true;
 		}
 		else {
@@ -458,7 +541,7 @@ static void lineEditor(
 					break;
 				default: break;
 			}
-			edit.blinkTime = 0.0f;
+			edit.blinkStart = -1.0;
 			edit.cursorShow = true;
 			updateCursor(edit, bounds);
 		}
@@ -478,13 +561,15 @@ static void lineEditor(
 			}
 			i++;
 		}
-		edit.blinkTime = 0.0f;
+		edit.blinkStart = -1.0;
 		edit.cursorShow = true;
 	}
 }
 
-static void drawEditText(NVGcontext* ctx, TextEdit& edit, const std::string& text, Rect bounds) {
-	std::string textP = text + " ";
+static void drawEditText(NVGcontext* ctx, FrameArena& arena, TextEdit& edit, const std::string& text, Rect bounds) {
+	// positions for one past the last character too, that's where the cursor goes at the end
+	FrameString textP(text, &arena);
+	textP += ' ';
 	edit.glyphs.resize(textP.size());
 
 	nvgSave(ctx);
@@ -492,47 +577,39 @@ static void drawEditText(NVGcontext* ctx, TextEdit& edit, const std::string& tex
 
 	nvgIntersectScissor(ctx, 0.0f, 0.0f, bounds.width, bounds.height);
 	nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE);
-	nvgTextGlyphPositions(ctx, 0.0f, 0.0f, textP.c_str(), nullptr, edit.glyphs.data(), edit.glyphs.size());
+	nvgTextGlyphPositions(ctx, 0.0f, 0.0f, textP.data(), textP.data() + textP.size(), edit.glyphs.data(), edit.glyphs.size());
 
 	nvgText(ctx, -edit.viewOffset, bounds.height / 2 + 1.5f, text.c_str(), nullptr);
 	nvgRestore(ctx);
 }
 
-void QuickGUI::textEdit(const std::string& id, Rect bounds, std::string& text, const std::string& placeholder) {
+void QuickGUI::textEdit(WidgetKey id, Rect bounds, std::string& text, std::string_view placeholder) {
+	PROFILE_ZONE("QuickGUI::textEdit");
 	auto wd = widget(id, bounds);
 	auto ctx = context();
 
 	bool focused = m_state.focusedWidget == wd.id;
 
-	std::string style = "textedit";
+	StyleId style = m_styles.textEdit;
 	if (focused) {
-		style = "textedit_focus";
+		style = m_styleSheet.variant(m_styles.textEdit, WidgetState::Focused);
 	}
 	m_styleSheet.draw(style, ctx, bounds, "", 0);
 	
 	if (text.empty() && !focused) {
-		m_styleSheet.draw("placeholder", ctx, bounds, placeholder, 0);
+		m_styleSheet.draw(m_styles.placeholder, ctx, bounds, placeholder, 0);
 	}
 	
 	m_styleSheet.fontSetup(style, ctx, bounds);
 
-	auto pos = m_textEdits.find(wd.id);
-	if (pos == m_textEdits.end()) {
-		m_textEdits[wd.id] = TextEdit();
-		pos = m_textEdits.find(wd.id);
-	}
-
-	auto& edit = pos->second;
-
-	std::string textP = text + " ";
-	edit.glyphs.resize(textP.size());
+	auto& edit = m_widgetStates.state<TextEdit>(wd.id, m_frame);
 
 	nvgSave(ctx);
 
-	drawEditText(ctx, edit, text, bounds);
+	drawEditText(ctx, m_frameArena, edit, text, bounds);
 	
 	if (focused) {
-		drawCursor(ctx, edit, bounds);
+		requestRedrawIn(drawCursor(ctx, edit, bounds, m_time));
 		lineEditor(wd, bounds, edit, text, m_state);
 	}
 
@@ -558,13 +635,14 @@ static void updateValue(NumberEdit& numEdit, int dx, float& value, float step, f
 }
 
 void QuickGUI::number(
-	const std::string& id,
+	WidgetKey id,
 	Rect bounds,
 	float& value, float minValue, float maxValue, float step,
-	const std::string& fmt,
-	const std::string& label
+	std::string_view fmt,
+	std::string_view label
 )
 {
+	PROFILE_ZONE("QuickGUI::number");
 	Rect decBounds = Rect(bounds.x, bounds.y, 16, bounds.height);
 	Rect incBounds = Rect(bounds.x + bounds.width - 16, bounds.y, 16, bounds.height);
 	Rect mainBounds = Rect(
@@ -578,67 +656,60 @@ void QuickGUI::number(
 	auto wid = widget(id, mainBounds);
 	bool focused = m_state.focusedWidget == wid.id;
 
-	auto pos = m_numberEdits.find(wid.id);
-	if (pos == m_numberEdits.end()) {
-		m_numberEdits[wid.id] = NumberEdit();
-	}
-
-	auto& numEdit = m_numberEdits[wid.id];
+	auto& numEdit = m_widgetStates.state<NumberEdit>(wid.id, m_frame);
 
-	std::string valueText = std::vformat(fmt, std::make_format_args(value));
+	std::string_view valueText = m_frameArena.vformat(fmt, std::make_format_args(value));
 
 	nvgSave(ctx);
 	
-	m_styleSheet.draw("panel", ctx, bounds, "", 0);
+	m_styleSheet.draw(m_styles.panel, ctx, bounds, "", 0);
 
-	auto el = m_styleSheet.fontSetup("textedit", ctx, mainBounds);
+	auto el = m_styleSheet.fontSetup(m_styles.textEdit, ctx, mainBounds);
 
 	float labelOffset = 0.0f;
 	if (!numEdit.editingText) {
 		nvgTranslate(ctx, mainBounds.x, mainBounds.y);
 
-		auto allText = label + valueText;
-		float txtBounds[4];
-		nvgTextBounds(ctx, 0.0f, 0.0f, allText.c_str(), nullptr, txtBounds);
-		labelOffset = mainBounds.width / 2 - (txtBounds[2] - txtBounds[0]) / 2;
+		FrameString allText(label, &m_frameArena);
+		allText += valueText;
+		labelOffset = mainBounds.width / 2 - m_styleSheet.measureText(ctx, allText).width / 2;
 
 		if (!label.empty()) {
 			nvgSave(ctx);
 			nvgGlobalAlpha(ctx, 0.5f);
 			nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE);
 			nvgApplyFillPaint(ctx, el.textPaint.value_or(Color{ 1.0f, 1.0f, 1.0f, 1.0f }));
-			nvgText(ctx, labelOffset, mainBounds.height / 2 + 1.5f, label.c_str(), nullptr);
+			nvgText(ctx, labelOffset, mainBounds.height / 2 + 1.5f, label.data(), label.data() + label.size());
 			
-			float lblBounds[4];
-			nvgTextBounds(ctx, 0.0f, 0.0f, label.c_str(), nullptr, lblBounds);
-
-			labelOffset += (lblBounds[2] - lblBounds[0]) + 3.0f;
+			labelOffset += m_styleSheet.measureText(ctx, label).width + 3.0f;
 
 			nvgRestore(ctx);
 		}
 
 		nvgApplyFillPaint(ctx, el.textPaint.value_or(Color{ 1.0f, 1.0f, 1.0f, 1.0f }));
 		nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE);
-		nvgText(ctx, labelOffset, mainBounds.height / 2 + 1.5f, valueText.c_str(), nullptr);
+		nvgText(ctx, labelOffset, mainBounds.height / 2 + 1.5f, valueText.data(), valueText.data() + valueText.size());
 	}
 	else {
-		drawEditText(ctx, numEdit.edit, numEdit.text, mainBounds);
+		drawEditText(ctx, m_frameArena, numEdit.edit, numEdit.text, mainBounds);
 		if (focused) {
-			drawCursor(ctx, numEdit.edit, mainBounds);
+			requestRedrawIn(drawCursor(ctx, numEdit.edit, mainBounds, m_time));
 		}
 	}
 
 	nvgRestore(ctx);
 
-	if (iconButton(id + "_dec", IC_CHEVRON_LEFT, decBounds)) {
+	pushID(id);
+	if (iconButton("dec", IC_CHEVRON_LEFT, decBounds)) {
 		value -= step;
 		value = std::clamp(value, minValue, maxValue);
 	}
 
-	if (iconButton(id + "_inc", IC_CHEVRON_RIGHT, incBounds)) {
+	if (iconButton("inc", IC_CHEVRON_RIGHT, incBounds)) {
 		value += step;
 		value = std::clamp(value, minValue, maxValue);
 	}
+	popID();
 
 	bool clickedInside =
 		mainBounds.hasPoint(m_state.mousePosition) &&
@@ -688,36 +759,15 @@ void QuickGUI::number(
 	}
 }
 
-void QuickGUI::colorPicker(const std::string& id, Rect bounds, Color& color) {
-	const float hueBarWidth = 18.0f;
-	auto ctx = context();
-	auto wd = widget(id, bounds);
-	bool focused = m_state.focusedWidget == wd.id;
-
-	auto pos = m_colorPickers.find(wd.id);
-	if (pos == m_colorPickers.end()) {
-		m_colorPickers[wd.id] = ColorPicker();
-	}
-
-	auto& cpicker = m_colorPickers[wd.id];
-	rgbToHSV(color[0], color[1], color[2], cpicker.hsv[0], cpicker.hsv[1], cpicker.hsv[2]);
-
-	nvgSave(ctx);
-
-	m_styleSheet.draw("panel", ctx, bounds, "", 0);
-
-	nvgTranslate(ctx, bounds.x, bounds.y);
+constexpr float hueBarWidth = 18.0f;
 
-	Rect b = bounds;
-	b.expand(-5);
+static int hueRingSize(int radius) {
+	return radius * 2 + 4; // room for the outline
+}
 
-	float cx = b.width * 0.5f;
-	float cy = b.height * 0.5f;
-	float r1 = (b.width < b.height ? b.width : b.height) * 0.5f - 5.0f;
-	float r0 = r1 - hueBarWidth;
+static void drawHueRing(NVGcontext* ctx, float cx, float cy, float r0, float r1) {
 	float aeps = 0.5f / r1;
 
-#pragma region Rendering
 	for (int i = 0; i < 6; i++) {
 		float a0 = (float)i / 6.0f * NVG_PI * 2.0f - aeps;
 		float a1 = (float)(i + 1.0f) / 6.0f * NVG_PI * 2.0f + aeps;
@@ -742,6 +792,111 @@ void QuickGUI::colorPicker(const std::string& id, Rect bounds, Color& color) {
 	nvgStrokeColor(ctx, nvgRGBA(0, 0, 0, 64));
 	nvgStrokeWidth(ctx, 1.0f);
 	nvgStroke(ctx);
+}
+
+void QuickGUI::bakeHueRings() {
+	PROFILE_ZONE("QuickGUI::bakeHueRings");
+	if (m_pendingHueRings.empty()) return;
+
+	auto ctx = context();
+
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+
+	for (int radius : m_pendingHueRings) {
+		int size = hueRingSize(radius);
+
+		// a failed framebuffer is remembered too, that size just keeps drawing the ring directly
+		NVGLUframebuffer* fb = nvgluCreateFramebuffer(ctx, size, size, 0);
+		m_hueRings[radius] = fb;
+		if (!fb) continue;
+
+		nvgluBindFramebuffer(fb);
+		glViewport(0, 0, size, size);
+		glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+		nvgBeginFrame(ctx, size, size, 1.0f);
+		drawHueRing(ctx, size / 2.0f, size / 2.0f, radius - hueBarWidth, float(radius));
+		nvgEndFrame(ctx);
+	}
+
+	nvgluBindFramebuffer(nullptr);
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+	m_pendingHueRings.clear();
+}
+
+void QuickGUI::registerMemoryReporters() {
+	m_memoryReporters.emplace_back("nanovg", [this] {
+		return MemoryUsage{ nvgMemoryUsage(m_context), 0 };
+	});
+	m_memoryReporters.emplace_back("nanovg GL (textures, vertices)", [this] {
+		MemoryUsage usage;
+		nvglMemoryUsageGL3(m_context, &usage.cpu, &usage.gpu);
+		return usage;
+	});
+	m_memoryReporters.emplace_back("gui widget states", [this] {
+		return MemoryUsage{ m_widgetStates.memoryUsage(), 0 };
+	});
+	m_memoryReporters.emplace_back("gui frame arena", [this] {
+		return MemoryUsage{ m_frameArena.capacity(), 0 };
+	});
+	m_memoryReporters.emplace_back("gui text cache", [this] {
+		return MemoryUsage{ m_styleSheet.textCache().memoryUsage(), 0 };
+	});
+	// the ring images are nanovg textures and counted there, this is their stencil buffers
+	m_memoryReporters.emplace_back("gui hue ring stencils", [this] {
+		MemoryUsage usage;
+		for (auto&& [radius, fb] : m_hueRings) {
+			size_t size = size_t(hueRingSize(radius));
+			if (fb) usage.gpu += size * size;
+		}
+		return usage;
+	});
+}
+
+void QuickGUI::colorPicker(WidgetKey id, Rect bounds, Color& color) {
+	PROFILE_ZONE("QuickGUI::colorPicker");
+	auto ctx = context();
+	auto wd = widget(id, bounds);
+	bool focused = m_state.focusedWidget == wd.id;
+
+	auto& cpicker = m_widgetStates.state<ColorPicker>(wd.id, m_frame);
+	rgbToHSV(color[0], color[1], color[2], cpicker.hsv[0], cpicker.hsv[1], cpicker.hsv[2]);
+
+	nvgSave(ctx);
+
+	m_styleSheet.draw(m_styles.panel, ctx, bounds, "", 0);
+
+	nvgTranslate(ctx, bounds.x, bounds.y);
+
+	Rect b = bounds;
+	b.expand(-5);
+
+	float cx = b.width * 0.5f;
+	float cy = b.height * 0.5f;
+	// whole pixels, so pickers of about the same size share the cached ring
+	int ringRadius = int((b.width < b.height ? b.width : b.height) * 0.5f - 5.0f);
+	float r1 = float(ringRadius);
+	float r0 = r1 - hueBarWidth;
+
+#pragma region Rendering
+	auto ring = m_hueRings.find(ringRadius);
+	if (ring != m_hueRings.end() && ring->second) {
+		float size = float(hueRingSize(ringRadius));
+		float x = cx - size / 2.0f, y = cy - size / 2.0f;
+
+		nvgBeginPath(ctx);
+		nvgRect(ctx, x, y, size, size);
+		nvgFillPaint(ctx, nvgImagePattern(ctx, x, y, size, size, 0.0f, ring->second->image, 1.0f));
+		nvgFill(ctx);
+	}
+	else {
+		drawHueRing(ctx, cx, cy, r0, r1);
+		if (ring == m_hueRings.end() && std::find(m_pendingHueRings.begin(), m_pendingHueRings.end(), ringRadius) == m_pendingHueRings.end()) {
+			m_pendingHueRings.push_back(ringRadius);
+		}
+	}
 
 	// Selector
 	nvgSave(ctx);
@@ -887,6 +1042,7 @@ static void drawImage(
 }
 
 Rect QuickGUI::image(uint32_t handle, Rect bounds, ImageFit fit) {
+	PROFILE_ZONE("QuickGUI::image");
 	auto ctx = context();
 
 	auto pos = m_imageMap.find(handle);
@@ -895,7 +1051,7 @@ Rect QuickGUI::image(uint32_t handle, Rect bounds, ImageFit fit) {
 		pos = m_imageMap.find(handle);
 	}
 
-	m_styleSheet.draw("panel", ctx, bounds, "", 0);
+	m_styleSheet.draw(m_styles.panel, ctx, bounds, "", 0);
 
 	int iw, ih;
 	nvgImageSize(ctx, pos->second, &iw, &ih);
@@ -949,7 +1105,7 @@ Rect QuickGUI::image(uint32_t handle, Rect bounds, ImageFit fit) {
 
 static void drawRadioButton(
 	NVGcontext* ctx,
-	const std::string& text,
+	std::string_view text,
 	float x, float y, float w, float h,
 	float radiusLeft = 12.0f, float radiusRight = 12.0f,
 	float bgBright = 0.0f,
@@ -969,39 +1125,30 @@ static void drawRadioButton(
 	nvgFillColor(ctx, nvgRGBf(1.0f - bgBright, 1.0f - bgBright, 1.0f - bgBright));
 	nvgTextAlign(ctx, NVG_ALIGN_CENTER | NVG_ALIGN_MIDDLE);
 	nvgFontSize(ctx, 14.0f);
-	nvgTextBox(ctx, x, y + h / 2 + 1.5f, w, text.c_str(), nullptr);
+	nvgTextBox(ctx, x, y + h / 2 + 1.5f, w, text.data(), text.data() + text.size());
 }
 
-bool QuickGUI::radioSelector(const std::string& id, Rect bounds, RadioButton* buttons, size_t count, size_t& selected) {
+bool QuickGUI::radioSelector(WidgetKey id, Rect bounds, RadioButton* buttons, size_t count, size_t& selected) {
+	PROFILE_ZONE("QuickGUI::radioSelector");
 	auto ctx = context();
-	auto root = widgetID(id);
+	auto root = makeID(id);
 
-	m_styleSheet.draw("panel", ctx, bounds, "", 0);
+	m_styleSheet.draw(m_styles.panel, ctx, bounds, "", 0);
 
-	auto el = m_styleSheet.fontSetup("button", ctx, bounds);
+	auto el = m_styleSheet.fontSetup(m_styles.button, ctx, bounds);
 
 	auto buttonWidth = bounds.width / count;
 	for (size_t i = 0; i < count; i++) {
 		auto item = buttons[i];
 		auto b = Rect(bounds.x + i * buttonWidth, bounds.y, buttonWidth, bounds.height);
 
-		auto wd = widget(id + item.text, b);
-		std::string style = "button_empty";
-		switch (wd.state) {
-			case WidgetState::Normal:
-			case WidgetState::Focused: style = "button_empty"; break;
-			case WidgetState::Hovered: style = "button_hover"; break;
-			case WidgetState::Active: style = "button_active"; break;
-			case WidgetState::Disabled: style = "button_empty"; break;
-		}
+		auto wd = widgetByID(combineID(root, WidgetKey::index(i)), b);
+		// the unselected buttons are transparent but share the button hover/active looks
+		StyleId style = m_styles.buttonEmpty;
+		if (i == selected || wd.state == WidgetState::Hovered) style = m_styles.buttonHover;
+		else if (wd.state == WidgetState::Active) style = m_styles.buttonActive;
 
-		if (i == selected) {
-			style = "button_hover";
-		}
-
-		if (!style.empty()) {
-			m_styleSheet.draw(style, ctx, b, item.text, item.icon);
-		}
+		m_styleSheet.draw(style, ctx, b, item.text, item.icon);
 
 		if (wd.clicked) {
 			selected = i;
@@ -1015,24 +1162,20 @@ bool QuickGUI::radioSelector(const std::string& id, Rect bounds, RadioButton* bu
 constexpr float scrollSize = 18.0f;
 constexpr float contentPadding = 50.0f;
 
-void QuickGUI::beginPanel(const std::string& id, Rect bounds) {
+void QuickGUI::beginPanel(WidgetKey id, Rect bounds) {
 	auto ctx = context();
-	auto root = widgetID(id);
+	auto root = makeID(id);
 
-	auto pos = m_panels.find(root);
-	if (pos == m_panels.end()) {
-		m_panels[root] = Panel();
-	}
-
-	auto& panel = m_panels[root];
+	auto& record = m_widgetStates.acquire(root, m_frame);
+	auto& panel = WidgetStateArena::stateOf<Panel>(record);
 	
-	m_styleSheet.draw("panel_hollow", ctx, bounds, "", 0);
-	auto el = m_styleSheet.getElement("panel_hollow", ctx, bounds);
+	m_styleSheet.draw(m_styles.panelHollow, ctx, bounds, "", 0);
+	auto el = m_styleSheet.getElement(m_styles.panelHollow, ctx, bounds);
 
 	bounds.y -= panel.scroll.y;
 
 	PanelData data{
-		.id = root,
+		.handle = m_widgetStates.handle(record),
 		.bounds = bounds,
 	};
 	m_panelStack.push_back(data);
@@ -1052,7 +1195,8 @@ void QuickGUI::endPanel() {
 	PanelData data = m_panelStack.back();
 	m_panelStack.pop_back();
 
-	auto& panel = m_panels[data.id];
+	auto& record = *m_widgetStates.get(data.handle);
+	auto& panel = WidgetStateArena::stateOf<Panel>(record);
 	Rect currentBounds = layoutPeek();
 
 	float contentSize = (currentBounds.y - data.bounds.y) + contentPadding;
@@ -1066,7 +1210,7 @@ void QuickGUI::endPanel() {
 	);
 
 	nvgResetScissor(ctx);
-	m_styleSheet.draw("scroll_track", ctx, handleArea, "", 0);
+	m_styleSheet.draw(m_styles.scrollTrack, ctx, handleArea, "", 0);
 
 	if (contentSize - contentPadding > 0.0f) {
 		Rect handle;
@@ -1075,16 +1219,9 @@ void QuickGUI::endPanel() {
 		handle.width = handleArea.width;
 		handle.height = (float(handleArea.height) * pageScale + 0.5f);
 
-		auto wd = widget(std::to_string(panel.data.id) + "_thumb", handleArea);
+		auto wd = widgetByID(combineID(record.id, "thumb"), handleArea);
 
-		std::string style = "scroll_thumb";
-		switch (wd.state) {
-			case WidgetState::Normal:
-			case WidgetState::Focused: style = "scroll_thumb"; break;
-			case WidgetState::Hovered: style = "scroll_thumb_hover"; break;
-			case WidgetState::Active: style = "scroll_thumb_active"; break;
-			case WidgetState::Disabled: style = "scroll_thumb"; break;
-		}
+		StyleId style = m_styleSheet.variant(m_styles.scrollThumb, wd.state);
 		m_styleSheet.draw(style, ctx, handle, "", 0);
 
 		bool clickedInside =
@@ -1114,17 +1251,130 @@ void QuickGUI::endPanel() {
 	layoutPopBounds();
 }
 
-void QuickGUI::tabs(const std::string& id, Rect bounds, MenuItem* items, size_t numItems, size_t& selected) {
+bool QuickGUI::list(
+	WidgetKey id,
+	Rect bounds,
+	size_t count,
+	size_t& selected,
+	const std::function<MenuItem(size_t)>& item
+) {
+	PROFILE_ZONE("QuickGUI::list");
+	const float rowHeight = 24.0f;
+	const float minThumbHeight = 16.0f;
+
+	auto ctx = context();
+	auto root = makeID(id);
+
+	m_styleSheet.draw(m_styles.panelHollow, ctx, bounds, "", 0);
+
+	Rect rows = Rect(bounds.x, bounds.y, bounds.width - scrollSize, bounds.height);
+	auto wd = widgetByID(root, rows);
+	auto& view = m_widgetStates.state<ListView>(root, m_frame);
+
+	const size_t previous = selected;
+	const size_t pageRows = std::max(size_t(1), size_t(rows.height / rowHeight));
+	const float maxScroll = std::max(0.0f, rowHeight * count - rows.height);
+
+	if (wd.keyPressed && count > 0) {
+		size_t current = selected < count ? selected : 0;
+		switch (m_state.key) {
+			case Key::UP: selected = current > 0 ? current - 1 : 0; break;
+			case Key::DOWN: selected = selected < count ? std::min(current + 1, count - 1) : 0; break;
+			case Key::PAGEUP: selected = current > pageRows ? current - pageRows : 0; break;
+			case Key::PAGEDOWN: selected = std::min(current + pageRows, count - 1); break;
+			case Key::HOME: selected = 0; break;
+			case Key::END: selected = count - 1; break;
+			default: break;
+		}
+	}
+
+	if (wd.clicked) {
+		size_t row = size_t((wd.relativeMouse.y + view.scroll) / rowHeight);
+		if (row < count) selected = row;
+	}
+
+	if (m_state.hoveredWidget == root) {
+		view.scroll -= m_state.mouseScroll * rowHeight * 3.0f;
+	}
+
+	// keep the selection visible, whoever changed it
+	if (selected != view.lastSelected && selected < count) {
+		float top = rowHeight * selected;
+		if (top < view.scroll) view.scroll = top;
+		else if (top + rowHeight > view.scroll + rows.height) view.scroll = top + rowHeight - rows.height;
+	}
+	view.lastSelected = selected;
+
+	// scroll bar
+	Rect track = Rect(rows.x + rows.width, bounds.y, scrollSize, bounds.height);
+	m_styleSheet.draw(m_styles.scrollTrack, ctx, track, "", 0);
+
+	if (maxScroll > 0.0f) {
+		float thumbHeight = std::max(minThumbHeight, track.height * rows.height / (rowHeight * count));
+		float travel = track.height - thumbHeight;
+
+		auto thumb = widgetByID(combineID(root, "thumb"), track);
+		if (isMouseDownWidget(thumb.id)) {
+			float thumbY = travel * std::clamp(view.scroll / maxScroll, 0.0f, 1.0f);
+			if (!view.dragging) {
+				view.dragging = true;
+				view.grabOffset = thumb.relativeMouse.y - thumbY;
+			}
+			view.scroll = (thumb.relativeMouse.y - view.grabOffset) / travel * maxScroll;
+		}
+		else {
+			view.dragging = false;
+		}
+
+		view.scroll = std::clamp(view.scroll, 0.0f, maxScroll);
+
+		Rect handle = Rect(track.x, track.y + travel * (view.scroll / maxScroll), track.width, thumbHeight);
+		m_styleSheet.draw(m_styleSheet.variant(m_styles.scrollThumb, thumb.state), ctx, handle, "", 0);
+	}
+	else {
+		view.scroll = 0.0f;
+	}
+
+	// only the rows in view from here on
+	size_t first = size_t(view.scroll / rowHeight);
+	size_t last = std::min(count, size_t((view.scroll + rows.height) / rowHeight) + 1);
+
+	size_t hoveredRow = SIZE_MAX;
+	if (m_state.hoveredWidget == root) {
+		hoveredRow = size_t((m_state.mousePosition.y - rows.y + view.scroll) / rowHeight);
+	}
+
+	nvgSave(ctx);
+	nvgIntersectScissor(ctx, rows.x, rows.y, rows.width, rows.height);
+
+	for (size_t i = first; i < last; i++) {
+		WidgetState state = WidgetState::Normal;
+		if (i == selected) state = WidgetState::Active;
+		else if (i == hoveredRow) state = WidgetState::Hovered;
+
+		MenuItem row = item(i);
+		Rect rowBounds = Rect(rows.x, rows.y + rowHeight * i - view.scroll, rows.width, rowHeight);
+		m_styleSheet.draw(m_styleSheet.variant(m_styles.menuItem, state), ctx, rowBounds, row.text, row.icon);
+	}
+
+	nvgRestore(ctx);
+
+	return selected != previous;
+}
+
+void QuickGUI::tabs(WidgetKey id, Rect bounds, MenuItem* items, size_t numItems, size_t& selected) {
+	PROFILE_ZONE("QuickGUI::tabs");
 	const float buttonHorPad = 6.0f;
 	const float buttonHeight = 24.0f;
 
 	auto ctx = context();
+	auto root = makeID(id);
 	float x = bounds.x + buttonHorPad;
 	float y = bounds.y;
 
 	for (size_t i = 0; i < numItems; i++) {
 		auto item = items[i];
-		auto [tw, th] = m_styleSheet.calculateBounds("tab", ctx, item.text, item.icon);
+		auto [tw, th] = m_styleSheet.calculateBounds(m_styles.tab, ctx, item.text, item.icon);
 
 		Rect wBounds = Rect(x, y, tw + buttonHorPad * 2, buttonHeight);
 
@@ -1136,19 +1386,12 @@ void QuickGUI::tabs(const std::string& id, Rect bounds, MenuItem* items, size_t
 			wBounds.y = y;
 		}
 
-		auto wd = widget(id + "#" + std::to_string(i), wBounds);
+		auto wd = widgetByID(combineID(root, WidgetKey::index(i)), wBounds);
 
-		std::string style = "tab";
-		switch (wd.state) {
-			case WidgetState::Normal:
-			case WidgetState::Focused: style = "tab"; break;
-			case WidgetState::Hovered: style = "tab_hover"; break;
-			case WidgetState::Active: style = "tab_active"; break;
-			case WidgetState::Disabled: style = "tab_disabled"; break;
-		}
+		StyleId style = m_styleSheet.variant(m_styles.tab, wd.state);
 
 		if (i == selected) {
-			style = "tab_hover";
+			style = m_styleSheet.variant(m_styles.tab, WidgetState::Hovered);
 		}
 
 		m_styleSheet.draw(style, ctx, wBounds, item.text, item.icon);
@@ -1160,12 +1403,70 @@ void QuickGUI::tabs(const std::string& id, Rect bounds, MenuItem* items, size_t
 		}
 	}
 
-	m_styleSheet.draw("panel", ctx, Rect(bounds.x, y + buttonHeight, bounds.width, 2), "", 0);
+	m_styleSheet.draw(m_styles.panel, ctx, Rect(bounds.x, y + buttonHeight, bounds.width, 2), "", 0);
+}
+
+void QuickGUI::profilerHUD(Rect bounds) {
+	if (!Profiler::enabled()) return;
+
+	const float rowHeight = 16.0f;
+	const float padding = 8.0f;
+
+	auto ctx = context();
+	nvgSave(ctx);
+	nvgScissor(ctx, bounds.x, bounds.y, bounds.width, bounds.height);
+
+	nvgBeginPath(ctx);
+	nvgRoundedRect(ctx, bounds.x, bounds.y, bounds.width, bounds.height, 4.0f);
+	nvgFillColor(ctx, nvgRGBA(0, 0, 0, 200));
+	nvgFill(ctx);
+
+	nvgFontFace(ctx, "normal");
+	nvgFontSize(ctx, 13.0f);
+
+	float y = bounds.y + padding / 2 + rowHeight / 2;
+	auto row = [&](std::string_view left, std::string_view right, NVGcolor color) {
+		if (y > bounds.y + bounds.height) return;
+		nvgFillColor(ctx, color);
+		nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE);
+		nvgText(ctx, bounds.x + padding, y, left.data(), left.data() + left.size());
+		nvgTextAlign(ctx, NVG_ALIGN_RIGHT | NVG_ALIGN_MIDDLE);
+		nvgText(ctx, bounds.x + bounds.width - padding, y, right.data(), right.data() + right.size());
+		y += rowHeight;
+	};
+
+	const NVGcolor headerColor = nvgRGB(255, 200, 80);
+	const NVGcolor zoneColor = nvgRGB(230, 230, 230);
+
+	row(
+		m_frameArena.format("frame {:.2f} ms", Profiler::frameMs()),
+		m_frameArena.format("{} allocations", m_frameAllocations),
+		headerColor
+	);
+
+	const std::string* thread = nullptr;
+	for (auto&& zone : Profiler::stats()) {
+		if (!thread || *thread != zone.thread) {
+			thread = &zone.thread;
+			row(*thread, "ms / frame   calls", headerColor);
+		}
+		row(zone.name, m_frameArena.format("{:.3f}   {:.0f}", zone.ms, zone.calls), zoneColor);
+	}
+
+	nvgRestore(ctx);
+
+	// the numbers change every frame
+	requestRedraw();
 }
 
 void QuickGUI::renderPopups() {
-	for (auto&& [wid, popup] : m_popups) {
-		if (m_openPopup != wid) continue;
+	PROFILE_ZONE("QuickGUI::renderPopups");
+	if (m_openPopup == InvalidWidget) return;
+
+	auto open = m_widgetStates.find(m_openPopup);
+	if (open && std::holds_alternative<Popup>(open->state)) {
+		const Popup& popup = std::get<Popup>(open->state);
+		if (popup.frame != m_frame) return; // popup() wasn't called this frame, the items are gone
 
 		const size_t itemHeight = 24;
 		const size_t paddingX = 10;
@@ -1175,14 +1476,11 @@ void QuickGUI::renderPopups() {
 		auto position = m_state.lastClickedPosition;
 
 		Rect tmpBounds = Rect(0, 0, 1, 1);
-		m_styleSheet.fontSetup("menu_item", ctx, tmpBounds);
+		m_styleSheet.fontSetup(m_styles.menuItem, ctx, tmpBounds);
 
 		int width = 0;
 		for (size_t i = 0; i < popup.items.size(); i++) {
-			float bounds[4];
-			nvgTextBounds(ctx, 0, 0, popup.items[i].text.c_str(), nullptr, bounds);
-
-			int textWidth = int(bounds[2] - bounds[0]);
+			int textWidth = int(m_styleSheet.measureText(ctx, popup.items[i].text).width);
 			if (popup.items[i].icon) {
 				textWidth += iconSpaceWidth;
 			}
@@ -1196,22 +1494,15 @@ void QuickGUI::renderPopups() {
 			itemHeight * popup.items.size() + paddingY * 2
 		);
 
-		m_styleSheet.draw("panel", ctx, bounds, "", 0);
+		m_styleSheet.draw(m_styles.panel, ctx, bounds, "", 0);
 
 		float y = bounds.y + paddingY;
 		for (size_t i = 0; i < popup.items.size(); i++) {
 			MenuItem item = popup.items[i];
 
-			auto wd = getWidget(item.text + popup.id);
+			auto wd = getWidget(combineID(popup.id, WidgetKey::index(i)));
 
-			std::string style = "menu_item";
-			switch (wd.state) {
-				case WidgetState::Normal:
-				case WidgetState::Focused: style = "menu_item"; break;
-				case WidgetState::Hovered: style = "menu_item_hover"; break;
-				case WidgetState::Active: style = "menu_item_active"; break;
-				case WidgetState::Disabled: style = "menu_item_disabled"; break;
-			}
+			StyleId style = m_styleSheet.variant(m_styles.menuItem, wd.state);
 
 			Rect wdBounds = Rect(bounds.x, y, bounds.width, itemHeight);
 			m_styleSheet.draw(style, ctx, wdBounds, item.text, item.icon);
@@ -1221,16 +1512,28 @@ void QuickGUI::renderPopups() {
 	}
 }
 
-Widget& QuickGUI::getWidget(const std::string& id) {
-	const WidgetID wid = widgetID(id);
-
-	auto&& pos = m_widgetState.find(wid);
-	if (pos == m_widgetState.end()) {
-		m_widgetState[wid] = Widget();
-		pos = m_widgetState.find(wid);
-	}
+void QuickGUI::resolveStyles() {
+	m_styles = {
+		.text = m_styleSheet.id("text"),
+		.textMiddle = m_styleSheet.id("text_middle"),
+		.button = m_styleSheet.id("button"),
+		.buttonEmpty = m_styleSheet.id("button_empty"),
+		.buttonHover = m_styleSheet.id("button_hover"),
+		.buttonActive = m_styleSheet.id("button_active"),
+		.iconButton = m_styleSheet.id("icon_button"),
+		.panel = m_styleSheet.id("panel"),
+		.panelHollow = m_styleSheet.id("panel_hollow"),
+		.scrollTrack = m_styleSheet.id("scroll_track"),
+		.scrollThumb = m_styleSheet.id("scroll_thumb"),
+		.textEdit = m_styleSheet.id("textedit"),
+		.placeholder = m_styleSheet.id("placeholder"),
+		.tab = m_styleSheet.id("tab"),
+		.menuItem = m_styleSheet.id("menu_item")
+	};
+}
 
-	return pos->second;
+Widget& QuickGUI::getWidget(WidgetID wid) {
+	return m_widgetStates.common(wid, m_frame);
 }
 
 void QuickGUI::debugRect(Rect r) {
@@ -1259,27 +1562,29 @@ Rect QuickGUI::layoutPeek() {
 	return m_layoutStack.back();
 }
 
-std::vector<Rect> QuickGUI::layoutSliceHorizontal(
+std::span<Rect> QuickGUI::layoutSliceHorizontal(
 	int height,
 	int columns,
 	int gap
 ) {
-	std::vector<Rect> ret;
+	// the rounded down column width can leave room for one extra column
+	auto ret = m_frameArena.allocateArray<Rect>(columns + 1);
+	size_t count = 0;
 
 	auto bounds = layoutCutTop(height);
 	layoutPushBounds(bounds);
 
 	int columnWidth = (bounds.width / columns);
 
-	while (layoutPeek().width > 0) {
+	while (layoutPeek().width > 0 && count < ret.size()) {
 		Rect b = layoutCutLeft(columnWidth - gap);
 		layoutCutLeft(gap);
-		ret.push_back(b);
+		ret[count++] = b;
 	}
 
 	layoutPopBounds();
 
-	return ret;
+	return ret.first(count);
 }
 
 Rect QuickGUI::layoutCutTop(int height) {
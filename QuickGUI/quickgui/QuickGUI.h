@@ -7,23 +7,19 @@
 #include <cstdint>
 #include <functional>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
+#include <memory>
 
+#include "FileWatcher.h"
+#include "FrameArena.h"
+#include "MemoryRegistry.h"
 #include "StyleSheet.h"
-
-using WidgetID = std::size_t;
-constexpr WidgetID InvalidWidget = WidgetID(0);
-
-enum class WidgetState : uint8_t {
-	Normal = 0,
-	Hovered,
-	Active,
-	Focused,
-	Disabled,
-	Count
-};
+#include "WidgetArena.h"
+#include "WidgetKey.h"
 
 enum class Alignment : uint8_t {
 	Left = 0,
@@ -94,10 +90,11 @@ struct QuickGUIState {
 		focusedWidget{ InvalidWidget };
 };
 
+// menu items are usually static tables, the text isn't owned
 struct MenuItem {
 	size_t icon;
-	std::string text;
-	std::vector<MenuItem> children;
+	std::string_view text;
+	std::span<const MenuItem> children;
 };
 
 struct TextEdit {
@@ -105,7 +102,7 @@ struct TextEdit {
 
 	int32_t cursor{ 0 };
 	bool cursorShow{ false }, ctrl{ false };
-	float blinkTime{ 0.0f };
+	double blinkStart{ -1.0 }; // gui time the cursor started blinking, negative restarts it
 
 	float viewOffset{ 0.0f };
 };
@@ -132,11 +129,11 @@ struct ColorPicker {
 
 struct RadioButton {
 	size_t icon{ 0 };
-	std::string text;
+	std::string_view text;
 };
 
 struct PanelData {
-	WidgetID id;
+	WidgetHandle handle;
 	Rect bounds;
 };
 
@@ -147,11 +144,23 @@ struct Panel {
 	PanelData data;
 };
 
+struct ListView {
+	float scroll{ 0.0f }, grabOffset{ 0.0f };
+	bool dragging{ false };
+	size_t lastSelected{ SIZE_MAX };
+};
+
 struct Popup {
-	std::string id;
-	std::vector<MenuItem> items;
+	WidgetID id{ InvalidWidget };
+	// copied into the frame arena, only valid during `frame`
+	std::span<const MenuItem> items;
+	uint64_t frame{ 0 };
 };
 
+using WidgetStateArena = WidgetArena<Widget, TextEdit, NumberEdit, ColorPicker, Panel, Popup, ListView>;
+
+struct NVGLUframebuffer;
+
 class QuickGUI {
 public:
 	~QuickGUI();
@@ -167,7 +176,20 @@ public:
 	void beginFrame(uint32_t width, uint32_t height);
 	void endFrame();
 
+	// frames are only needed after input, when a widget animates (e.g. the text cursor)
+	// or when the host asks for one, e.g. because an image shown in the gui changed
+	void requestRedraw();
+	void requestRedrawIn(double seconds);
+	bool needsRedraw();
+	// seconds until a scheduled redraw is due, infinity if none is
+	double redrawTimeout() const;
+
+	// seconds on a steady clock, sampled in beginFrame
+	double time() const { return m_time; }
+
 	NVGcontext* context();
+	// the ui's fonts, by name, into any context that draws text like the ui does
+	static void loadFonts(NVGcontext* ctx);
 
 	// layout stuff
 	Rect layoutCutTop(int height);
@@ -178,49 +200,66 @@ public:
 	Rect layoutPopBounds();
 	Rect layoutPeek();
 
-	std::vector<Rect> layoutSliceHorizontal(int height, int columns, int gap = 6);
+	// the rects live in the frame arena
+	std::span<Rect> layoutSliceHorizontal(int height, int columns, int gap = 6);
+
+	// memory for temporaries that only need to live until endFrame
+	FrameArena& frameArena() { return m_frameArena; }
+	// heap allocations made by the last frame, see AllocationCounter.h
+	uint64_t frameAllocations() const { return m_frameAllocations; }
 
-	Widget widget(const std::string& id, Rect bounds, bool checkBlocked = true);
+	const WidgetStateArena& widgetStates() const { return m_widgetStates; }
 
-	void text(const std::string& text, Rect bounds, const std::string& style = "text");
+	// ids are hashed together with every scope pushed before them, so the same key can be
+	// reused by widgets under different scopes (e.g. one per list item).
+	void pushID(WidgetKey id);
+	void popID();
+	WidgetID makeID(WidgetKey id) const;
+
+	Widget widget(WidgetKey id, Rect bounds, bool checkBlocked = true);
+
+	// resolve custom styles once and keep the id, drawing with an id is a plain array index
+	StyleId styleId(std::string_view name);
+
+	void text(std::string_view text, Rect bounds, StyleId style = InvalidStyle);
 	bool button(
-		const std::string& id,
-		const std::string& text,
+		WidgetKey id,
+		std::string_view text,
 		Rect bounds,
 		size_t icon = 0
 	);
 
 	bool iconButton(
-		const std::string& id,
+		WidgetKey id,
 		size_t icon,
 		Rect bounds
 	);
 
-	void checkBox(const std::string& id, const std::string& text, Rect bounds, bool& checked);
+	void checkBox(WidgetKey id, std::string_view text, Rect bounds, bool& checked);
 
-	void showPopup(const std::string& id);
-	bool popup(const std::string& id, MenuItem* items, size_t numItems, size_t& selected);
+	void showPopup(WidgetKey id);
+	bool popup(WidgetKey id, MenuItem* items, size_t numItems, size_t& selected);
 
 	void textEdit(
-		const std::string& id,
+		WidgetKey id,
 		Rect bounds,
 		std::string& text,
-		const std::string& placeholder = ""
+		std::string_view placeholder = ""
 	);
 
 	void number(
-		const std::string& id,
+		WidgetKey id,
 		Rect bounds,
 		float& value,
 		float minValue = 0.0f,
 		float maxValue = 1.0f,
 		float step = 0.1f,
-		const std::string& fmt = "{:.2f}",
-		const std::string& label = ""
+		std::string_view fmt = "{:.2f}",
+		std::string_view label = ""
 	);
 
 	void colorPicker(
-		const std::string& id,
+		WidgetKey id,
 		Rect bounds,
 		Color& color
 	);
@@ -231,40 +270,90 @@ public:
 		ImageFit fit = ImageFit::Stretch
 	);
 
-	bool radioSelector(const std::string& id, Rect bounds, RadioButton* buttons, size_t count, size_t& selected);
+	bool radioSelector(WidgetKey id, Rect bounds, RadioButton* buttons, size_t count, size_t& selected);
 
 	void beginPanel(
-		const std::string& id,
+		WidgetKey id,
 		Rect bounds
 	);
 	void endPanel();
 
-	void tabs(const std::string& id, Rect bounds, MenuItem* items, size_t numItems, size_t& selected);
+	void tabs(WidgetKey id, Rect bounds, MenuItem* items, size_t numItems, size_t& selected);
+
+	// Scrolling list of `count` rows that only asks for (`item(index)`) and draws the rows in
+	// view, so its cost doesn't depend on the count. Rows are selected by clicking, or with the
+	// arrow/page/home/end keys while the list is focused; SIZE_MAX means nothing is selected.
+	// The selection is scrolled into view whenever it changes. Returns true if the user changed it.
+	bool list(
+		WidgetKey id,
+		Rect bounds,
+		size_t count,
+		size_t& selected,
+		const std::function<MenuItem(size_t)>& item
+	);
+
+	// Profiler overlay, the smoothed per-frame cost of each zone grouped by thread.
+	// Draws nothing while the profiler is disabled.
+	void profilerHUD(Rect bounds);
 
 protected:
 	void renderPopups();
-	Widget& getWidget(const std::string& id);
+	Widget widgetByID(WidgetID wid, Rect bounds, bool checkBlocked = true);
+	Widget& getWidget(WidgetID wid);
 
 	QuickGUIState m_state{};
 	StyleSheet m_styleSheet;
 
-	NVGcontext* m_context{ nullptr };
+	// ids of the styles the built-in widgets use, see resolveStyles
+	struct {
+		StyleId text, textMiddle;
+		StyleId button, buttonEmpty, buttonHover, buttonActive, iconButton;
+		StyleId panel, panelHollow, scrollTrack, scrollThumb;
+		StyleId textEdit, placeholder;
+		StyleId tab, menuItem;
+	} m_styles{};
+	void resolveStyles();
+
+	// style.sty is watched and reparsed when it's saved, only the changed styles are recompiled
+	static constexpr const char* StyleSheetPath = "style.sty";
+	std::unique_ptr<FileWatcher> m_styleWatcher;
+	void reloadStyleSheet();
+	bool pollStyleSheet();
+
+	// a redraw draws this many frames, so state changed by the input is seen by every widget
+	static constexpr int redrawFrames = 2;
+	int m_pendingFrames{ redrawFrames };
+	double m_redrawAt{ 0.0 };
+	double m_time{ 0.0 };
 
-	int32_t m_fontNormal, m_fontItalic, m_fontBold, m_fontIcons;
+	NVGcontext* m_context{ nullptr };
 
 	std::vector<Rect> m_layoutStack{};
 	std::vector<PanelData> m_panelStack{};
+	std::vector<WidgetID> m_idStack{};
 
 	WidgetID m_openPopup{ InvalidWidget };
 
-	std::map<WidgetID, TextEdit> m_textEdits;
-	std::map<WidgetID, NumberEdit> m_numberEdits;
-	std::map<WidgetID, ColorPicker> m_colorPickers;
-	std::map<WidgetID, Panel> m_panels;
-	std::map<WidgetID, Popup> m_popups;
-	std::map<WidgetID, Widget> m_widgetState;
+	// state of widgets not drawn for this many frames is dropped (checked every gcInterval frames)
+	static constexpr uint64_t gcMaxAge = 600;
+	static constexpr uint64_t gcInterval = 60;
+
+	WidgetStateArena m_widgetStates;
+	uint64_t m_frame{ 0 };
+
+	FrameArena m_frameArena;
+	uint64_t m_frameAllocationsStart{ 0 }, m_frameAllocations{ 0 };
 	std::map<GLuint, int> m_imageMap;
 
+	// hue rings of the color pickers, pre-rendered per outer radius. new sizes are drawn directly
+	// for one frame and rendered into a framebuffer before the next one (see bakeHueRings).
+	std::map<int, NVGLUframebuffer*> m_hueRings;
+	std::vector<int> m_pendingHueRings;
+	void bakeHueRings();
+
+	std::vector<MemoryReporter> m_memoryReporters;
+	void registerMemoryReporters();
+
 	bool m_inputBlocked{ false };
 
 	void debugRect(Rect r);
@@ -5,8 +5,11 @@
 #include <stdexcept>
 #include <format>
 #include <cassert>
+#include <charconv>
 
 #include "Icons.h"
+#include "Profiler.h"
+#include "WidgetKey.h"
 
 static float hue2rgb(float p, float q, float t) {
 	if (t < 0) t += 1;
@@ -48,27 +51,47 @@ StyleFunctionValue style_Gradient(NVGcontext* ctx, const ParamList& params, Rect
 	);
 }
 
+static const char* StateSuffixes[size_t(WidgetState::Count)] = {
+	"", "_hover", "_active", "_focus", "_disabled"
+};
+
 static const std::unordered_map<std::string, StyleFunctionCallback> StyleFunctions = {
 	{ "gradient", style_Gradient }
 };
  
+// Cursor over the stylesheet text. Tokens are returned as views into the input and the
+// cursor keeps track of the line/column it is at for error messages.
 struct StringParser {
-	std::vector<char> input;
+	std::string_view input;
+	size_t pos{ 0 };
+	int line{ 1 }, column{ 1 };
+
+	bool done() const { return pos >= input.size(); }
 
 	char next() {
-		if (input.empty()) return 0;
-		char c = input[0];
-		input.erase(input.begin());
+		if (done()) return 0;
+		char c = input[pos++];
+		if (c == '\n') {
+			line++;
+			column = 1;
+		}
+		else {
+			column++;
+		}
 		return c;
 	}
 
-	char peek() {
-		if (input.empty()) return 0;
-		return input[0];
+	char peek() const {
+		if (done()) return 0;
+		return input[pos];
+	}
+
+	[[noreturn]] void fail(const std::string& message) const {
+		throw StyleSheetError(message, line, column);
 	}
 
 	void skipSpaces() {
-		while (peek() != 0 && isspace(peek())) next();
+		while (peek() != 0 && isspace(uint8_t(peek()))) next();
 	}
 
 	bool skipIfPresentAndSpaces(char c) {
@@ -79,50 +102,68 @@ struct StringParser {
 			present = true;
 		}
 		else {
-			throw std::runtime_error(std::format("expected a \"{}\".", c));
+			fail(std::format("expected a \"{}\".", c));
 		}
 		skipSpaces();
 		return present;
 	}
 
-	std::string nextWhere(const std::function<bool(char)>& check) {
-		std::string str = "";
-		while (peek() != 0 && check(peek())) {
-			str += next();
-		}
-		return str;
+	template <typename Check>
+	std::string_view nextWhere(Check&& check) {
+		size_t start = pos;
+		while (peek() != 0 && check(peek())) next();
+		return input.substr(start, pos - start);
 	}
 
-	std::string nextIndentifier() {
-		return nextWhere([](char c) { return isalnum(c) || c == '_' || c == '-'; });
+	static bool isIdentifierChar(char c) {
+		return isalnum(uint8_t(c)) || c == '_' || c == '-';
 	}
 
-	std::string peekIndentifier() {
-		std::string id = nextIndentifier();
-		for (size_t i = id.size(); i-- > 0;) {
-			input.insert(input.begin(), id[i]);
-		}
-		return id;
+	std::string_view nextIndentifier() {
+		return nextWhere(isIdentifierChar);
+	}
+
+	std::string_view peekIndentifier() const {
+		size_t end = pos;
+		while (end < input.size() && isIdentifierChar(input[end])) end++;
+		return input.substr(pos, end - pos);
 	}
 
 	float nextNumber() {
-		if (!isdigit(peek()) && peek() != '-') {
-			throw std::runtime_error("expected a number string.");
+		if (!isdigit(uint8_t(peek())) && peek() != '-') {
+			fail("expected a number.");
 		}
 
-		std::string str = nextWhere([](char c) { return isdigit(c) || c == '.' || c == '-'; });
-		return std::stof(str);
+		auto str = nextWhere([](char c) { return isdigit(uint8_t(c)) || c == '.' || c == '-'; });
+
+		float value = 0.0f;
+		auto [end, error] = std::from_chars(str.data(), str.data() + str.size(), value);
+		if (error != std::errc() || end != str.data() + str.size()) {
+			fail(std::format("invalid number \"{}\".", str));
+		}
+		return value;
 	}
 
 	uint8_t nextHexByte() {
-		if (!isxdigit(peek())) {
-			throw std::runtime_error("expected a hexadecimal string.");
-		}
+		auto digit = [this]() -> uint8_t {
+			char c = peek();
+			if (!isxdigit(uint8_t(c))) fail("expected a hexadecimal digit.");
+			next();
+			if (c >= '0' && c <= '9') return uint8_t(c - '0');
+			return uint8_t(tolower(uint8_t(c)) - 'a' + 10);
+		};
 
-		std::string str = "";
-		str += next();
-		str += next();
-		return (uint8_t)std::stol(str, nullptr, 16);
+		uint8_t hi = digit();
+		return uint8_t(hi << 4) | digit();
+	}
+
+	static bool isColorFunction(std::string_view id) {
+		auto is = [id](std::string_view name) {
+			return id.size() == name.size() && std::equal(id.begin(), id.end(), name.begin(), [](char a, char b) {
+				return tolower(uint8_t(a)) == b;
+			});
+		};
+		return is("rgb") || is("rgba") || is("hsl") || is("hsla");
 	}
 
 	Color nextColor() {
@@ -136,9 +177,9 @@ struct StringParser {
 			ret[3] = 1.0f;
 			return ret;
 		}
-		else if (isalpha(peek())) {
-			auto colFn = nextIndentifier();
-			std::transform(colFn.begin(), colFn.end(), colFn.begin(), tolower);
+		else if (isalpha(uint8_t(peek()))) {
+			std::string colFn(nextIndentifier());
+			std::transform(colFn.begin(), colFn.end(), colFn.begin(), [](char c) { return char(tolower(uint8_t(c))); });
 
 			skipIfPresentAndSpaces('(');
 
@@ -170,22 +211,24 @@ struct StringParser {
 				ret[3] = nextNumber();
 			}
 			else {
-				throw std::runtime_error("invalid color string.");
+				fail(std::format("invalid color function \"{}\".", colFn));
 			}
 
 			skipIfPresentAndSpaces(')');
 
 			return ret;
 		}
+
+		fail("expected a color.");
 	}
 
-	std::string nextString() {
-		if (peek() != '\'' || peek() != '"') {
-			throw std::runtime_error("expected a \" before string.");
+	std::string_view nextString() {
+		if (peek() != '\'' && peek() != '"') {
+			fail("expected a \" before string.");
 		}
 		char quote = next();
 
-		std::string str = nextWhere([quote](char c) { return c != quote; });
+		auto str = nextWhere([quote](char c) { return c != quote; });
 		skipIfPresentAndSpaces(quote);
 
 		return str;
@@ -196,7 +239,7 @@ struct StringParser {
 		ret.type = ParamType::None;
 		ret.value = nullptr;
 
-		if (isdigit(peek())) {
+		if (isdigit(uint8_t(peek()))) {
 			ret.type = ParamType::Number;
 			ret.value = nextNumber();
 			return ret;
@@ -206,29 +249,26 @@ struct StringParser {
 			ret.value = nextColor();
 			return ret;
 		}
-		else if (isalpha(peek())) {
-			auto id = peekIndentifier();
-			std::transform(id.begin(), id.end(), id.begin(), tolower);
-
-			if (id == "rgb" || id == "rgba" || id == "hsl" || id == "hsla") {
+		else if (isalpha(uint8_t(peek()))) {
+			if (isColorFunction(peekIndentifier())) {
 				ret.type = ParamType::Color;
 				ret.value = nextColor();
 				return ret;
 			}
 			else {
-				id = nextIndentifier();
+				auto id = nextIndentifier();
 				skipSpaces();
 
 				ret.type = ParamType::Enum;
-				ret.value = id;
+				ret.value = std::string(id);
 				return ret;
 			}
 		}
-		throw std::runtime_error("invalid param value.");
+		fail("invalid param value.");
 	}
 
 	PropertyValue nextPropertyValue(PropertyType& type) {
-		if (isdigit(peek())) {
+		if (isdigit(uint8_t(peek())) || peek() == '-') {
 			type = PropertyType::Number;
 			return nextNumber();
 		}
@@ -236,29 +276,33 @@ struct StringParser {
 			type = PropertyType::Color;
 			return nextColor();
 		}
-		else if (isalpha(peek())) {
-			auto id = peekIndentifier();
-			std::transform(id.begin(), id.end(), id.begin(), tolower);
-
-			if (id == "rgb" || id == "rgba" || id == "hsl" || id == "hsla") {
+		else if (isalpha(uint8_t(peek()))) {
+			if (isColorFunction(peekIndentifier())) {
 				type = PropertyType::Color;
 				return nextColor();
 			}
 			else {
-				id = nextIndentifier();
+				auto id = nextIndentifier();
 				skipSpaces();
 
 				if (peek() == '(') {
+					auto fn = StyleFunctions.find(std::string(id));
+					if (fn == StyleFunctions.end()) {
+						fail(std::format("unknown function \"{}\".", id));
+					}
+
 					next();
 					skipSpaces();
 
 					type = PropertyType::Function;
 
 					StyleFunction fun{};
-					fun.callback = StyleFunctions.at(id);
+					fun.callback = fn->second;
 
 					size_t i = 0;
-					while (peek() != ')' && !input.empty()) {
+					while (peek() != ')' && !done()) {
+						if (i >= fun.params.size()) fail("too many parameters.");
+
 						auto param = nextParam();
 						skipSpaces();
 						if (peek() != ')') skipIfPresentAndSpaces(',');
@@ -270,84 +314,134 @@ struct StringParser {
 				}
 				else {
 					type = PropertyType::Enum;
-					return id;
+					return std::string(id);
 				}
 			}
 		}
 		else if (peek() == '\'' || peek() == '"') {
 			type = PropertyType::String;
-			return nextString();
-		}
-		else {
-			throw std::runtime_error("invalid property value.");
+			return std::string(nextString());
 		}
+
+		fail("invalid property value.");
 	}
 
 	PropertyPack nextPropertyPack() {
 		PropertyPack ret{};
 
 		size_t i = 0;
-		while (peek() != ';' && i < 4) {
+		while (peek() != ';' && !done()) {
+			if (i >= ret.values.size()) fail("too many values.");
+
 			Property prop;
 			prop.value = nextPropertyValue(prop.type);
 			ret[i++] = prop;
 
-			if (peek() == ' ') {
-				skipSpaces();
-			}
-			else if (peek() == ';') {
-				break;
-			}
+			skipSpaces();
 		}
 
 		return ret;
 	}
 };
 
-void StyleSheet::parse(const std::string& styleSheetData) {
-	StringParser sp{};
-	sp.input = std::vector<char>(styleSheetData.begin(), styleSheetData.end());
+StyleSheetError::StyleSheetError(const std::string& message, int line, int column)
+	: std::runtime_error(std::format("{}:{}: {}", line, column, message)), line(line), column(column)
+{}
 
-	while (!sp.input.empty()) {
-		sp.skipSpaces();
+size_t StyleSheet::parse(std::string_view styleSheetData) {
+	StringParser sp{ .input = styleSheetData };
 
+	// parsed into temporaries first, a broken sheet leaves the current styles untouched
+	std::unordered_map<std::string, Style> styles;
+	std::unordered_map<std::string, uint64_t> signatures;
+
+	sp.skipSpaces();
+	while (!sp.done()) {
 		// Read style name
-		if (isalpha(sp.peek())) {
-			std::string styleName = sp.nextIndentifier();
-			sp.skipIfPresentAndSpaces('{');
-
-			Style style{};
-
-			// parse properties
-			while (sp.peek() != '}') {
-				if (sp.peek() == '@') {
-					// inherit from a style
-					sp.next();
-					auto inherited = sp.nextIndentifier();
-					sp.skipIfPresentAndSpaces(';');
-
-					auto pos = m_styles.find(inherited);
-					if (pos != m_styles.end()) {
-						for (auto [k, v] : pos->second) {
-							style[k] = v;
-						}
-					}
-				}
-				else {
-					std::string propName = sp.nextIndentifier();
-					sp.skipIfPresentAndSpaces(':');
+		if (!isalpha(uint8_t(sp.peek()))) {
+			sp.fail("expected a style name.");
+		}
 
-					auto value = sp.nextPropertyPack();
-					sp.skipIfPresentAndSpaces(';');
+		std::string styleName(sp.nextIndentifier());
+		sp.skipIfPresentAndSpaces('{');
+
+		Style style{};
+		size_t blockStart = sp.pos;
+		// hash of the style's source, chained with the hashes of the styles it inherits from
+		uint64_t signature = widgetkey::FNVOffset;
+
+		// parse properties
+		while (sp.peek() != '}') {
+			if (sp.done()) sp.fail(std::format("unterminated style \"{}\".", styleName));
+
+			if (sp.peek() == '@') {
+				// inherit from a style
+				sp.next();
+				std::string inherited(sp.nextIndentifier());
+				sp.skipIfPresentAndSpaces(';');
+
+				auto pos = styles.find(inherited);
+				if (pos == styles.end()) {
+					sp.fail(std::format("unknown style \"{}\".", inherited));
+				}
 
-					style[propName] = value;
+				for (auto&& [k, v] : pos->second) {
+					style[k] = v;
 				}
+				signature = widgetkey::hash(signatures[inherited], signature);
 			}
-			sp.skipIfPresentAndSpaces('}');
+			else {
+				std::string propName(sp.nextIndentifier());
+				if (propName.empty()) sp.fail("expected a property name.");
+				sp.skipIfPresentAndSpaces(':');
+
+				auto value = sp.nextPropertyPack();
+				sp.skipIfPresentAndSpaces(';');
+
+				style[propName] = value;
+			}
+		}
+
+		signatures[styleName] = widgetkey::hash(styleSheetData.substr(blockStart, sp.pos - blockStart), signature);
+		sp.skipIfPresentAndSpaces('}');
+
+		styles[styleName] = std::move(style);
+	}
+
+	// only styles whose source (or inherited source) changed get recompiled, plus the base
+	// styles of variants that were added or removed
+	std::vector<std::string> changed;
+	for (auto&& [name, signature] : signatures) {
+		auto pos = m_signatures.find(name);
+		if (pos == m_signatures.end() || pos->second != signature) changed.push_back(name);
+	}
+	for (auto&& [name, signature] : m_signatures) {
+		if (!signatures.contains(name)) changed.push_back(name);
+	}
 
-			m_styles[styleName] = style;
+	m_styles = std::move(styles);
+	m_signatures = std::move(signatures);
+
+	size_t count = changed.size();
+	for (size_t i = 0; i < count; i++) {
+		const std::string& name = changed[i];
+		for (size_t state = 1; state < size_t(WidgetState::Count); state++) {
+			std::string_view suffix = StateSuffixes[state];
+			if (name.size() > suffix.size() && name.ends_with(suffix)) {
+				changed.push_back(name.substr(0, name.size() - suffix.size()));
+				break;
+			}
 		}
 	}
+
+	// ids handed out before (even for styles that didn't exist yet) keep pointing at the same name
+	for (auto&& name : changed) {
+		auto pos = m_ids.find(name);
+		if (pos != m_ids.end()) compile(pos->second);
+		else id(name);
+	}
+
+	return count;
 }
 
 #define elementSetter(name) void element_set##name(NVGcontext* ctx, Element& el, const PropertyPack& props)
@@ -452,7 +546,55 @@ static const std::unordered_map<std::string, ElementSetter> ElementSetters = {
 	{ "padding", element_setPadding }
 };
 
-Element StyleSheet::draw(const std::string& style, NVGcontext* ctx, Rect bounds, const std::string& text, size_t icon) {
+StyleId StyleSheet::id(std::string_view name) {
+	std::string key(name);
+	auto pos = m_ids.find(key);
+	if (pos != m_ids.end()) return pos->second;
+
+	StyleId style = StyleId(m_compiled.size());
+	m_ids[key] = style;
+	m_names.push_back(key);
+	m_compiled.emplace_back();
+	compile(style);
+
+	return style;
+}
+
+void StyleSheet::compile(StyleId style) {
+	CompiledStyle compiled{};
+	// copied, resolving the variants below can add names
+	std::string name = m_names[style];
+
+	auto pos = m_styles.find(name);
+	if (pos != m_styles.end()) {
+		compiled.defined = true;
+
+		for (auto&& [k, v] : pos->second) {
+			if (k == "background" && v[0].type == PropertyType::Function) {
+				compiled.background = std::get<StyleFunction>(v[0].value);
+				continue;
+			}
+
+			auto setter = ElementSetters.find(k);
+			if (setter != ElementSetters.end()) {
+				setter->second(nullptr, compiled.element, v);
+			}
+		}
+	}
+
+	compiled.variants.fill(style);
+	for (size_t state = 1; state < size_t(WidgetState::Count); state++) {
+		std::string variantName = name + StateSuffixes[state];
+		if (m_styles.contains(variantName)) {
+			compiled.variants[state] = id(variantName);
+		}
+	}
+
+	m_compiled[style] = std::move(compiled);
+}
+
+Element StyleSheet::draw(StyleId style, NVGcontext* ctx, Rect bounds, std::string_view text, size_t icon) {
+	PROFILE_ZONE("StyleSheet::draw");
 	Rect innerBounds = Rect(0, 0, bounds.width, bounds.height);
 	Element element = getElement(style, ctx, innerBounds);
 
@@ -489,22 +631,14 @@ Element StyleSheet::draw(const std::string& style, NVGcontext* ctx, Rect bounds,
 
 	float offX = 0.0f, offY = 0.0f, iconOffX = 0.0f;
 
-	float tbounds[4];
-	nvgTextBoxBounds(ctx, 0.0f, 0.0f, innerBounds.width, text.c_str(), nullptr, tbounds);
-
-	float textWidth = tbounds[2] - tbounds[0];
-	auto [totalWidth, height] = calculateBounds(style, ctx, text, icon);
-
 	if (icon) {
+		auto [totalWidth, height] = calculateBounds(style, ctx, text, icon);
+
 		nvgSave(ctx);
 		nvgFontSize(ctx, 18.0f);
 
 		auto ico = ICON(icon);
-		float icBounds[4];
-		nvgTextBounds(ctx, 0.0f, 0.0f, ico.c_str(), nullptr, icBounds);
-
-		float iconWidth = icBounds[2] - icBounds[0];
-		float iconHeight = icBounds[3] - icBounds[1];
+		float iconWidth = m_textCache.measure(ctx, ico).width;
 
 		if (element.alignmentX == NVG_ALIGN_LEFT) {
 			offX = iconWidth;
@@ -530,8 +664,8 @@ Element StyleSheet::draw(const std::string& style, NVGcontext* ctx, Rect bounds,
 			ctx,
 			innerBounds.x + iconOffX,
 			iconOffY + 1.5f,
-			ico.c_str(),
-			nullptr
+			ico.data(),
+			ico.data() + ico.size()
 		);
 
 		nvgRestore(ctx);
@@ -554,7 +688,7 @@ Element StyleSheet::draw(const std::string& style, NVGcontext* ctx, Rect bounds,
 			offY = innerBounds.height;
 		}
 
-		nvgTextBox(ctx, innerBounds.x + offX, innerBounds.y + offY, innerBounds.width, text.c_str(), nullptr);
+		nvgTextBox(ctx, innerBounds.x + offX, innerBounds.y + offY, innerBounds.width, text.data(), text.data() + text.size());
 	}
 
 	nvgRestore(ctx);
@@ -562,7 +696,7 @@ Element StyleSheet::draw(const std::string& style, NVGcontext* ctx, Rect bounds,
 	return element;
 }
 
-Element StyleSheet::fontSetup(const std::string& style, NVGcontext* ctx, Rect& bounds) {
+Element StyleSheet::fontSetup(StyleId style, NVGcontext* ctx, Rect& bounds) {
 	auto element = getElement(style, ctx, bounds);
 
 	int alignmentFlags = element.alignmentX | element.alignmentY;
@@ -576,43 +710,45 @@ Element StyleSheet::fontSetup(const std::string& style, NVGcontext* ctx, Rect& b
 	return element;
 }
 
-std::pair<float, float> StyleSheet::calculateBounds(const std::string& style, NVGcontext* ctx, const std::string& text, size_t icon) {
-	Rect bounds = Rect(0, 0, 1000, 1000);
-	fontSetup(style, ctx, bounds);
+std::pair<float, float> StyleSheet::calculateBounds(StyleId style, NVGcontext* ctx, std::string_view text, size_t icon) {
+	// only the font size matters here, no need to build the whole element
+	bool defined = style < m_compiled.size() && m_compiled[style].defined;
+	nvgFontSize(ctx, defined ? m_compiled[style].element.fontSize : Element{}.fontSize);
 
-	float tbounds[4];
-	nvgTextBounds(ctx, 0.0f, 0.0f, text.c_str(), nullptr, tbounds);
-	float textWidth = tbounds[2] - tbounds[0];
-	float totalWidth = textWidth;
-	float height = (tbounds[3] - tbounds[1]);
+	TextMetrics metrics = m_textCache.measure(ctx, text);
+	float totalWidth = metrics.width;
+	float height = metrics.height;
 
 	if (icon) {
 		nvgTextAlign(ctx, NVG_ALIGN_TOP | NVG_ALIGN_LEFT);
 		nvgFontSize(ctx, 18.0f);
 
-		auto ico = ICON(icon);
-		float bounds[4];
-		nvgTextBounds(ctx, 0.0f, 0.0f, ico.c_str(), nullptr, bounds);
-
-		float iconWidth = bounds[2] - bounds[0];
-		float iconHeight = bounds[3] - bounds[1];
+		TextMetrics iconMetrics = m_textCache.measure(ctx, ICON(icon));
 
-		totalWidth += iconWidth + 5.0f; // icon | text spacing
-		height = std::max(height, iconHeight);
+		totalWidth += iconMetrics.width + 5.0f; // icon | text spacing
+		height = std::max(height, iconMetrics.height);
 	}
 
 	return std::make_pair(totalWidth, height);
 }
 
-Element StyleSheet::getElement(const std::string& style, NVGcontext* ctx, Rect& bounds) {
+TextMetrics StyleSheet::measureText(NVGcontext* ctx, std::string_view text) {
+	return m_textCache.measure(ctx, text);
+}
+
+Element StyleSheet::getElement(StyleId style, NVGcontext* ctx, Rect& bounds) const {
 	Rect innerBounds = Rect(0, 0, bounds.width, bounds.height);
-	Element element{ .bounds = innerBounds };
+	if (style >= m_compiled.size() || !m_compiled[style].defined) {
+		return Element{ .bounds = innerBounds };
+	}
 
-	auto stylePos = m_styles.find(style);
-	if (stylePos == m_styles.end()) return element;
+	const CompiledStyle& compiled = m_compiled[style];
+	Element element = compiled.element;
+	element.bounds = innerBounds;
 
-	for (auto [k, v] : stylePos->second) {
-		ElementSetters.at(k)(ctx, element, v);
+	if (compiled.background) {
+		const StyleFunction& fn = compiled.background.value();
+		element.backgroundPaint = std::get<NVGpaint>(fn.callback(ctx, fn.params, innerBounds));
 	}
 
 	bounds.x += element.padding[0];
@@ -8,13 +8,34 @@
 #include <cstdint>
 #include <vector>
 #include <optional>
+#include <stdexcept>
+#include <string_view>
 
 #include "../nanovg/nanovg.h"
 
 #include "Internal.h"
+#include "TextCache.h"
 
 constexpr float iconSpaceWidth = 22.0f;
 
+enum class WidgetState : uint8_t {
+	Normal = 0,
+	Hovered,
+	Active,
+	Focused,
+	Disabled,
+	Count
+};
+
+struct StyleSheetError : std::runtime_error {
+	StyleSheetError(const std::string& message, int line, int column);
+
+	int line, column;
+};
+
+using StyleId = uint32_t;
+constexpr StyleId InvalidStyle = UINT32_MAX;
+
 enum class PropertyType {
 	None = 0,
 	Number,
@@ -76,27 +97,60 @@ using ElementSetter = std::function<void(NVGcontext*, Element&, const PropertyPa
 
 using Style = std::unordered_map<std::string, PropertyPack>;
 
+// a style after parsing, with every property already applied to the element.
+// only function values (e.g. gradients) depend on the bounds and are evaluated at draw time.
+struct CompiledStyle {
+	Element element{};
+	std::optional<StyleFunction> background;
+	// style to use for each widget state, "<name>_hover", "<name>_active", "<name>_focus" and
+	// "<name>_disabled" when they exist, this style otherwise
+	std::array<StyleId, size_t(WidgetState::Count)> variants{};
+	bool defined{ false };
+};
+
 class StyleSheet {
 public:
-	void parse(const std::string& styleSheetData);
+	// parses the sheet and recompiles the styles that changed since the last parse, returning
+	// how many did. throws StyleSheetError and keeps the current styles if the sheet is invalid.
+	size_t parse(std::string_view styleSheetData);
+
+	// id of a style by name. unknown names get an id too (drawing with the default element),
+	// so ids can be resolved once and stay valid.
+	StyleId id(std::string_view name);
+	StyleId variant(StyleId style, WidgetState state) const {
+		return style < m_compiled.size() ? m_compiled[style].variants[size_t(state)] : style;
+	}
 
 	Element getElement(
-		const std::string& style,
+		StyleId style,
 		NVGcontext* ctx,
 		Rect& bounds
-	);
+	) const;
 
 	Element draw(
-		const std::string& style,
+		StyleId style,
 		NVGcontext* ctx,
 		Rect bounds,
-		const std::string& text,
+		std::string_view text,
 		size_t icon
 	);
 
-	Element fontSetup(const std::string& style, NVGcontext* ctx, Rect& bounds);
+	Element fontSetup(StyleId style, NVGcontext* ctx, Rect& bounds);
+
+	std::pair<float, float> calculateBounds(StyleId style, NVGcontext* ctx, std::string_view text, size_t icon);
 
-	std::pair<float, float> calculateBounds(const std::string& style, NVGcontext* ctx, const std::string& text, size_t icon);
+	// size of `text` in the current text style, cached
+	TextMetrics measureText(NVGcontext* ctx, std::string_view text);
+	const TextCache& textCache() const { return m_textCache; }
 private:
+	TextCache m_textCache;
+
 	std::unordered_map<std::string, Style> m_styles;
+	std::unordered_map<std::string, uint64_t> m_signatures;
+
+	std::unordered_map<std::string, StyleId> m_ids;
+	std::vector<std::string> m_names;
+	std::vector<CompiledStyle> m_compiled;
+
+	void compile(StyleId style);
 };
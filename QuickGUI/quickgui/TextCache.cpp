@@ -0,0 +1,66 @@
+#include "TextCache.h"
+
+#include <bit>
+
+TextMetrics TextCache::measure(NVGcontext* ctx, std::string_view text) {
+	int font;
+	float size, letterSpacing;
+	nvgCurrentTextStyle(ctx, &font, &size, &letterSpacing);
+
+	uint64_t key = widgetkey::hash(text);
+	key = widgetkey::hash(uint64_t(uint32_t(font)), key);
+	key = widgetkey::hash(uint64_t(std::bit_cast<uint32_t>(size)) << 32 | std::bit_cast<uint32_t>(letterSpacing), key);
+	if (key == InvalidWidget) key = 1;
+
+	if (auto entry = m_current.find(key); entry && entry->matches(text, font, size, letterSpacing)) {
+		m_stats.hits++;
+		return entry->metrics;
+	}
+
+	// still in use, move it into the current generation so it survives the next rotation
+	if (auto entry = m_previous.find(key); entry && entry->matches(text, font, size, letterSpacing)) {
+		m_stats.hits++;
+		Entry moved = std::move(*entry);
+		m_previous.erase(key);
+		return (m_current[key] = std::move(moved)).metrics;
+	}
+
+	m_stats.misses++;
+
+	float bounds[4];
+	nvgTextBounds(ctx, 0.0f, 0.0f, text.data(), text.data() + text.size(), bounds);
+
+	if (m_current.size() >= generationSize) {
+		m_stats.evictions += m_previous.size();
+		m_previous = std::move(m_current);
+		m_current.clear();
+	}
+
+	// a hash collision simply replaces the other entry
+	Entry& entry = m_current[key];
+	entry.text = text;
+	entry.font = font;
+	entry.size = size;
+	entry.letterSpacing = letterSpacing;
+	entry.metrics = TextMetrics{ bounds[2] - bounds[0], bounds[3] - bounds[1] };
+	return entry.metrics;
+}
+
+size_t TextCache::memoryUsage() const {
+	size_t bytes = m_current.memoryUsage() + m_previous.memoryUsage();
+
+	// texts too long for the small string buffer
+	const size_t inlineCapacity = std::string().capacity();
+	auto countText = [&](WidgetID, const Entry& entry) {
+		if (entry.text.capacity() > inlineCapacity) bytes += entry.text.capacity() + 1;
+	};
+	m_current.forEach(countText);
+	m_previous.forEach(countText);
+
+	return bytes;
+}
+
+void TextCache::clear() {
+	m_current.clear();
+	m_previous.clear();
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "../nanovg/nanovg.h"
+
+#include "FlatMap.h"
+
+struct TextMetrics {
+	float width{ 0.0f }, height{ 0.0f };
+};
+
+// Caches nvgTextBounds results per (font, size, letter spacing, text), so labels that don't
+// change are measured once. Entries live in two generations: when the current one is full it
+// becomes the previous one and whatever wasn't used since is dropped, which bounds the cache
+// to 2 * generationSize entries without tracking recency per entry.
+class TextCache {
+public:
+	struct Stats {
+		uint64_t hits{ 0 }, misses{ 0 }, evictions{ 0 };
+	};
+
+	static constexpr size_t generationSize = 1024;
+
+	// measures `text` with the current text style of ctx (alignment doesn't affect the size)
+	TextMetrics measure(NVGcontext* ctx, std::string_view text);
+
+	void clear();
+
+	const Stats& stats() const { return m_stats; }
+	size_t size() const { return m_current.size() + m_previous.size(); }
+	size_t memoryUsage() const;
+
+private:
+	struct Entry {
+		std::string text;
+		int font{ -1 };
+		float size{ 0.0f }, letterSpacing{ 0.0f };
+		TextMetrics metrics{};
+
+		bool matches(std::string_view text, int font, float size, float letterSpacing) const {
+			return this->font == font && this->size == size && this->letterSpacing == letterSpacing && this->text == text;
+		}
+	};
+
+	FlatMap<Entry> m_current, m_previous;
+	Stats m_stats{};
+};
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <variant>
+#include <vector>
+
+#include "FlatMap.h"
+#include "WidgetKey.h"
+
+struct WidgetHandle {
+	uint32_t index{ UINT32_MAX };
+	uint32_t generation{ 0 };
+
+	bool valid() const { return index != UINT32_MAX; }
+};
+
+// Single store for all per-widget state. Every record holds the common widget data plus
+// (optionally) one of the specialized states, and remembers the last frame it was used in.
+// Records are kept in fixed-size pages so references stay valid while new widgets are added,
+// and reclaimed slots bump their generation so stale handles can be detected.
+template <typename Common, typename... States>
+class WidgetArena {
+public:
+	struct Record {
+		WidgetID id{ InvalidWidget };
+		uint32_t generation{ 0 };
+		uint64_t lastSeen{ 0 };
+		Common common{};
+		std::variant<std::monostate, States...> state{};
+	};
+
+	// finds or creates the record for `id` and marks it as seen in `frame`
+	Record& acquire(WidgetID id, uint64_t frame) {
+		Record* record;
+		if (auto found = m_lookup.find(id)) {
+			record = &at(*found);
+		}
+		else {
+			uint32_t index = allocate();
+			record = &at(index);
+			record->id = id;
+			record->common = Common();
+			record->state = std::monostate{};
+			m_lookup[id] = index;
+		}
+
+		record->lastSeen = frame;
+		return *record;
+	}
+
+	Common& common(WidgetID id, uint64_t frame) {
+		return acquire(id, frame).common;
+	}
+
+	// the record's state as T, replacing whatever it held before
+	template <typename T>
+	T& state(WidgetID id, uint64_t frame) {
+		return stateOf<T>(acquire(id, frame));
+	}
+
+	template <typename T>
+	static T& stateOf(Record& record) {
+		if (!std::holds_alternative<T>(record.state)) record.state.template emplace<T>();
+		return std::get<T>(record.state);
+	}
+
+	Record* find(WidgetID id) {
+		auto index = m_lookup.find(id);
+		return index ? &at(*index) : nullptr;
+	}
+
+	WidgetHandle handle(const Record& record) const {
+		return WidgetHandle{ .index = *m_lookup.find(record.id), .generation = record.generation };
+	}
+
+	// nullptr if the record the handle pointed to was reclaimed in the meantime
+	Record* get(WidgetHandle handle) {
+		if (!handle.valid() || handle.index >= m_size) return nullptr;
+
+		Record& record = at(handle.index);
+		if (record.id == InvalidWidget || record.generation != handle.generation) return nullptr;
+		return &record;
+	}
+
+	// reclaims every record not seen in the last `maxAge` frames, unless `keep(id)` says otherwise
+	template <typename Keep>
+	void collect(uint64_t frame, uint64_t maxAge, Keep&& keep) {
+		for (uint32_t i = 0; i < m_size; i++) {
+			Record& record = at(i);
+			if (record.id == InvalidWidget) continue;
+			if (record.lastSeen + maxAge >= frame || keep(record.id)) continue;
+
+			m_lookup.erase(record.id);
+			record.id = InvalidWidget;
+			record.generation++;
+			record.common = Common();
+			record.state = std::monostate{}; // releases whatever the state owned
+			m_free.push_back(i);
+			m_reclaimed++;
+		}
+	}
+
+	size_t live() const { return m_lookup.size(); }
+	size_t capacity() const { return m_pages.size() * PageSize; }
+	uint64_t reclaimed() const { return m_reclaimed; }
+
+	// bytes of the record pages and the lookup, not counting what the states own themselves
+	size_t memoryUsage() const {
+		return m_pages.size() * sizeof(Page) +
+			m_pages.capacity() * sizeof(std::unique_ptr<Page>) +
+			m_free.capacity() * sizeof(uint32_t) +
+			m_lookup.memoryUsage();
+	}
+
+private:
+	static constexpr uint32_t PageSize = 256;
+	using Page = std::array<Record, PageSize>;
+
+	std::vector<std::unique_ptr<Page>> m_pages;
+	std::vector<uint32_t> m_free;
+	FlatMap<uint32_t> m_lookup;
+	uint32_t m_size{ 0 };
+	uint64_t m_reclaimed{ 0 };
+
+	Record& at(uint32_t index) {
+		return (*m_pages[index / PageSize])[index % PageSize];
+	}
+
+	uint32_t allocate() {
+		if (!m_free.empty()) {
+			uint32_t index = m_free.back();
+			m_free.pop_back();
+			return index;
+		}
+
+		if (m_size == m_pages.size() * PageSize) {
+			m_pages.push_back(std::make_unique<Page>());
+		}
+		return m_size++;
+	}
+};
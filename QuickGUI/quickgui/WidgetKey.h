@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+using WidgetID = uint64_t;
+constexpr WidgetID InvalidWidget = WidgetID(0);
+
+namespace widgetkey {
+	// 64-bit FNV-1a
+	constexpr uint64_t FNVOffset = 14695981039346656037ull;
+	constexpr uint64_t FNVPrime = 1099511628211ull;
+
+	constexpr uint64_t hash(std::string_view str, uint64_t seed = FNVOffset) {
+		for (char c : str) {
+			seed ^= uint8_t(c);
+			seed *= FNVPrime;
+		}
+		return seed;
+	}
+
+	constexpr uint64_t hash(uint64_t value, uint64_t seed) {
+		for (int i = 0; i < 8; i++) {
+			seed ^= (value >> (i * 8)) & 0xFF;
+			seed *= FNVPrime;
+		}
+		return seed;
+	}
+}
+
+// A widget id before it's combined with the current id scope (see QuickGUI::pushID).
+// String literals are hashed at compile time, runtime strings only when passed as such.
+struct WidgetKey {
+	uint64_t hash;
+
+	template <size_t N>
+	consteval WidgetKey(const char (&str)[N]) : hash(widgetkey::hash(std::string_view(str, N - 1))) {}
+
+	constexpr explicit WidgetKey(std::string_view str) : hash(widgetkey::hash(str)) {}
+	WidgetKey(const std::string& str) : hash(widgetkey::hash(std::string_view(str))) {}
+
+	// for widgets created in a loop
+	static constexpr WidgetKey index(uint64_t i) { return WidgetKey(widgetkey::hash(i, widgetkey::FNVOffset), 0); }
+
+private:
+	constexpr WidgetKey(uint64_t h, int) : hash(h) {}
+};
+
+// final id of `key` inside `scope`, never InvalidWidget
+constexpr WidgetID combineID(WidgetID scope, WidgetKey key) {
+	WidgetID id = widgetkey::hash(key.hash, scope);
+	return id == InvalidWidget ? WidgetID(1) : id;
+}
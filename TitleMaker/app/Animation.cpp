@@ -13,73 +13,91 @@ static MenuItem easingsMenu[] = {
 	{ 0, "In/Out Quad", {} },
 	{ 0, "In Elastic", {} },
 	{ 0, "Out Elastic", {} },
-	{ 0, "Bounce", {} }
+	{ 0, "Bounce", {} },
+	{ 0, "Custom Bezier", {} }
 };
 
-void Animation::onGUI(QuickGUI* gui, const std::string& baseID) {
-	gui->number("ani_duration" + baseID, gui->layoutCutTop(24), durationSecs, 0.0f, 30.0f, 0.01f, "{:.2f}s", "Duration:");
+static const EasingType easingsMenuTypes[] = {
+	EasingType::Linear,
+	EasingType::InCubic,
+	EasingType::OutCubic,
+	EasingType::InOutCubic,
+	EasingType::InQuad,
+	EasingType::OutQuad,
+	EasingType::InOutQuad,
+	EasingType::InElastic,
+	EasingType::OutElastic,
+	EasingType::OutBounce,
+	EasingType::Bezier
+};
+
+constexpr size_t easingsMenuCount = sizeof(easingsMenuTypes) / sizeof(EasingType);
+
+void Animation::onGUI(QuickGUI* gui) {
+	gui->number("ani_duration", gui->layoutCutTop(24), durationSecs, 0.0f, 30.0f, 0.01f, "{:.2f}s", "Duration:");
 	gui->layoutCutTop(5);
 
-	gui->number("ani_delay" + baseID, gui->layoutCutTop(24), delaySecs, 0.0f, 30.0f, 0.01f, "{:.2f}s", "Delay:");
+	gui->number("ani_delay", gui->layoutCutTop(24), delaySecs, 0.0f, 30.0f, 0.01f, "{:.2f}s", "Delay:");
 	gui->layoutCutTop(5);
 
-	static size_t selectedEasing = 0;
-	if (gui->button("ani_easing_sel" + baseID, easingsMenu[selectedEasing].text, gui->layoutCutTop(24), IC_LINE_CHART)) {
-		gui->showPopup("ani_easing" + baseID);
+	size_t selectedEasing = std::find(easingsMenuTypes, easingsMenuTypes + easingsMenuCount, easing) - easingsMenuTypes;
+	if (selectedEasing >= easingsMenuCount) selectedEasing = 0;
+
+	if (gui->button("ani_easing_sel", easingsMenu[selectedEasing].text, gui->layoutCutTop(24), IC_LINE_CHART)) {
+		gui->showPopup("ani_easing");
 	}
 
-	if (gui->popup("ani_easing" + baseID, easingsMenu, 10, selectedEasing)) {
-		Easing easingFuncs[] = {
-			easings::Linear,
-			easings::InCubic,
-			easings::OutCubic,
-			easings::InOutCubic,
-			easings::InQuad,
-			easings::OutQuad,
-			easings::InOutQuad,
-			easings::InElastic,
-			easings::OutElastic,
-			easings::OutBounce
-		};
-		easingFunction = easingFuncs[selectedEasing];
+	if (gui->popup("ani_easing", easingsMenu, easingsMenuCount, selectedEasing)) {
+		easing = easingsMenuTypes[selectedEasing];
+	}
+
+	if (easing == EasingType::Bezier) {
+		gui->layoutCutTop(5);
+
+		float p[] = { curve.x1(), curve.y1(), curve.x2(), curve.y2() };
+		auto row0 = gui->layoutSliceHorizontal(24, 2);
+		gui->number("ani_bezier_x1", row0[0], p[0], 0.0f, 1.0f, 0.01f, "{:.2f}", "X1:");
+		gui->number("ani_bezier_y1", row0[1], p[1], -2.0f, 3.0f, 0.01f, "{:.2f}", "Y1:");
+		gui->layoutCutTop(5);
+
+		auto row1 = gui->layoutSliceHorizontal(24, 2);
+		gui->number("ani_bezier_x2", row1[0], p[2], 0.0f, 1.0f, 0.01f, "{:.2f}", "X2:");
+		gui->number("ani_bezier_y2", row1[1], p[3], -2.0f, 3.0f, 0.01f, "{:.2f}", "Y2:");
+
+		// only re-sample the curve when a control point actually moved
+		CubicBezier edited(p[0], p[1], p[2], p[3]);
+		if (edited != curve) curve = edited;
 	}
 
 	gui->layoutCutTop(5);
 }
 
 void Animation::play(Shape* target) {
-	if (m_state == Delaying || m_state == Running) return;
-
-	m_state = Delaying;
 	m_target = target;
 	onSetup();
 }
 
-void Animation::update(NVGcontext* ctx, float globalTime, bool forward) {
-	switch (m_state) {
-		case Delaying: {
-			onRun(ctx, forward ? 0.0f : 1.0f);
-
-			if (globalTime >= delaySecs) {
-				m_state = Running;
-			}
-		} break;
-		case Running: {
-			float t = (globalTime - delaySecs) / durationSecs;
-			float v = forward ? t : (1.0f - t);
-
-			onRun(ctx, easingFunction ? easingFunction(v) : v);
-			if (t >= 1.0f) {
-				onFinish();
-				m_state = Finished;
-			}
-		} break;
-		default: break;
+void Animation::update(NVGcontext* ctx, FrameIndex frame, const Timebase& timebase, bool forward) {
+	FrameIndex delay = timebase.frames(delaySecs);
+	FrameIndex duration = std::max<FrameIndex>(timebase.frames(durationSecs), 1);
+
+	if (frame < delay) {
+		onRun(ctx, forward ? 0.0f : 1.0f);
+		return;
 	}
+
+	float t = std::min(float(frame - delay) / float(duration), 1.0f);
+	float v = forward ? t : (1.0f - t);
+	onRun(ctx, ease(v));
+}
+
+FrameIndex Animation::frameCount(const Timebase& timebase) const {
+	return timebase.frames(delaySecs) + std::max<FrameIndex>(timebase.frames(durationSecs), 1);
 }
 
-void Animation::reset() {
-	m_state = Idle;
+float Animation::ease(float t) const {
+	if (easing == EasingType::Bezier) return curve.evaluate(t);
+	return easings::evaluateFast(easing, t);
 }
 
 void RevealAnimation::onSetup() {
@@ -123,8 +141,8 @@ void RevealAnimation::onRun(NVGcontext* ctx, float t) {
 	);
 }
 
-void RevealAnimation::onGUI(QuickGUI* gui, const std::string& baseID) {
-	Animation::onGUI(gui, baseID);
+void RevealAnimation::onGUI(QuickGUI* gui) {
+	Animation::onGUI(gui);
 
 	MenuItem directions[] = {
 		{ IC_ARROW_RIGHT2, "From Left", {} },
@@ -134,11 +152,11 @@ void RevealAnimation::onGUI(QuickGUI* gui, const std::string& baseID) {
 	};
 
 	static size_t selectedDir = 0;
-	if (gui->button("ani_reveal_direction" + baseID, directions[selectedDir].text, gui->layoutCutTop(24), directions[selectedDir].icon)) {
-		gui->showPopup("ani_reveal_direction_opts" + baseID);
+	if (gui->button("ani_reveal_direction", directions[selectedDir].text, gui->layoutCutTop(24), directions[selectedDir].icon)) {
+		gui->showPopup("ani_reveal_direction_opts");
 	}
 
-	if (gui->popup("ani_reveal_direction_opts" + baseID, directions, 4, selectedDir)) {
+	if (gui->popup("ani_reveal_direction_opts", directions, 4, selectedDir)) {
 		direction = _Direction(selectedDir);
 	}
 }
@@ -156,8 +174,8 @@ void FadeAnimation::onRun(NVGcontext* ctx, float t) {
 	}
 }
 
-void FadeAnimation::onGUI(QuickGUI* gui, const std::string& baseID) {
-	Animation::onGUI(gui, baseID);
+void FadeAnimation::onGUI(QuickGUI* gui) {
+	Animation::onGUI(gui);
 
-	gui->checkBox("ani_fade_zoom" + baseID, "Zoom", gui->layoutCutTop(24), zoom);
+	gui->checkBox("ani_fade_zoom", "Zoom", gui->layoutCutTop(24), zoom);
 }
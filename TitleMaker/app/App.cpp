@@ -1,6 +1,13 @@
 #include "App.h"
+#include "Benchmark.h"
+#include "GoldenTest.h"
 
 #include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <string_view>
 
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "../stb_image_write.h"
@@ -8,6 +15,9 @@
 
 constexpr float hitTestExpand = 4.0f;
 
+// longest the main loop sleeps while nothing happens, in seconds
+constexpr double idleWait = 0.25;
+
 static const int keyTranslationTable[] = {
 	SDLK_a, SDLK_b, SDLK_c, SDLK_d, SDLK_e, SDLK_f,
 	SDLK_g, SDLK_h, SDLK_i, SDLK_j, SDLK_k, SDLK_l,
@@ -38,6 +48,9 @@ static const int keyTranslationTable[] = {
 void QuickGUI_Impl::processEvent(void* e) {
 	SDL_Event* ev = static_cast<SDL_Event*>(e);
 
+	// any event (including window exposure and resizes) may change what the gui shows
+	requestRedraw();
+
 	switch (ev->type) {
 		case SDL_MOUSEBUTTONDOWN: {
 			m_state.mouseDown = true;
@@ -132,18 +145,46 @@ static Point transformMouse(Point mousePosition, Rect bounds, float rotation) {
 	return localMouse.rotated(-rotation) + bounds.size() * 0.5f;
 }
 
+static void drawShapeOutline(NVGcontext* ctx, const Shape& shape, Point scale, Color col) {
+	nvgSave(ctx);
+	nvgTranslate(ctx, shape.bounds.x * scale.x, shape.bounds.y * scale.y);
+	nvgRotate(ctx, nvgDegToRad(shape.rotation));
+
+	float w = shape.bounds.width * scale.x;
+	float h = shape.bounds.height * scale.y;
+	nvgBeginPath(ctx);
+	nvgRect(ctx, -w * 0.5f, -h * 0.5f, w, h);
+	nvgStrokeColor(ctx, nvgColor(col));
+	nvgStrokeWidth(ctx, 1.0f);
+	nvgStroke(ctx);
+	nvgRestore(ctx);
+}
+
 bool QuickGUI_Impl::viewport(
-	const std::string& id, Rect bounds, int virtualWidth, int virtualHeight,
-	const ShapeList& shapes,
+	WidgetKey id, Rect bounds, int virtualWidth, int virtualHeight,
+	const SpatialIndex& index,
 	Shape** selected
 ) {
 	auto ctx = context();
 	auto wid = widget(id, bounds);
 	auto p = wid.relativeMouse;
 
+	Point scale = viewportToGui({ 1.0f, 1.0f }, virtualWidth, virtualHeight, bounds);
+	Point mouseVp = guiToViewport(p, virtualWidth, virtualHeight, bounds);
+	float tolerance = hitTestExpand / scale.x;
+
+	Shape* hovered = nullptr;
+	if (wid.state == WidgetState::Hovered || wid.state == WidgetState::Active) {
+		hovered = index.pick(mouseVp, tolerance);
+	}
+
 	nvgSave(ctx);
 	nvgTranslate(ctx, bounds.x, bounds.y);
 
+	if (hovered && hovered != *selected) {
+		drawShapeOutline(ctx, *hovered, scale, Color{ 0.2f, 0.6f, 1.0f, 1.0f });
+	}
+
 	if (*selected) {
 		rectManipulator(
 			(*selected)->bounds,
@@ -159,35 +200,11 @@ bool QuickGUI_Impl::viewport(
 	nvgRestore(ctx);
 
 	if (wid.clicked && m_state.mouseButton == QuickGUIState::Left) {
-		bool clickedShape = false;
-		for (auto&& shape : shapes) {
-			Rect b = shape->bounds;
-			
-			float rotation = nvgDegToRad(shape->rotation);
-
-			Point minGui = viewportToGui({ b.x, b.y }, virtualWidth, virtualHeight, bounds);
-			Point maxGui = viewportToGui({ b.x + b.width, b.y + b.height }, virtualWidth, virtualHeight, bounds);
-			Rect vpBounds = Rect::fromMinMax(minGui, maxGui);
-			Point vpBoundsOrigin = vpBounds.size() * 0.5f;
-			Point vpBoundsPos = vpBounds.location() + vpBoundsOrigin;
-			Rect vpBoundsLocal = vpBounds - vpBoundsPos;
-
-			Transform xform = (Transform::rotation(rotation) * Transform::translation(vpBoundsPos)).inverted();
-
-			// mouse position
-			Point mousePos = xform * p;
-
-			if (vpBoundsLocal.hasPoint(mousePos)) {
-				*selected = shape.get();
-				clickedShape = true;
-				break;
-			}
-		}
-		if (!clickedShape) {
-			*selected = nullptr;
+		*selected = index.pick(mouseVp, tolerance);
+		if (!*selected) {
 			m_manipulator.state = ManipulatorState::None;
 		}
-		return clickedShape;
+		return *selected != nullptr;
 	}
 
 	return false;
@@ -251,13 +268,13 @@ void QuickGUI_Impl::rectManipulator(
 	Transform xformDraw = Transform::translation(vpBoundsPos) * Transform::rotation(rotation);
 	Transform xform = (Transform::translation(vpBoundsPos) * Transform::rotation(rotation)).inverted();
 	
-	auto matText = std::format(
+	auto matText = m_frameArena.format(
 		"Offset: {:.2f},{:.2f} | X: {:.2f},{:.2f} | Y: {:.2f},{:.2f}",
 		xform.m[4], xform.m[5],
 		xform.m[0], xform.m[1],
 		xform.m[2], xform.m[3]
 	);
-	nvgText(ctx, 20.0f, 60.0f, matText.c_str(), nullptr);
+	nvgText(ctx, 20.0f, 60.0f, matText.data(), matText.data() + matText.size());
 
 	drawVec(ctx, 20.0f, 100.0f, xform.m[0], xform.m[1], Color{ 0.0f, 1.0f, 1.0f, 1.0f });
 	drawVec(ctx, 50.0f, 100.0f, xform.m[2], xform.m[3], Color{ 0.0f, 1.0f, 1.0f, 1.0f });
@@ -438,6 +455,46 @@ Point QuickGUI_Impl::guiToViewport(Point p, int virtualWidth, int virtualHeight,
 }
 
 int App::start(int argc, char** argv) {
+	std::string recordPath, replayPath, reportPath, benchmarkPath, goldenPath;
+	bool software = false, updateGolden = false;
+	for (int i = 1; i < argc; i++) {
+		std::string_view arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--record" && hasValue) recordPath = argv[++i];
+		else if (arg == "--replay" && hasValue) replayPath = argv[++i];
+		else if (arg == "--report" && hasValue) reportPath = argv[++i];
+		else if (arg == "--benchmark" && hasValue) benchmarkPath = argv[++i];
+		else if (arg == "--golden" && hasValue) goldenPath = argv[++i];
+		else if (arg == "--update-golden") updateGolden = true;
+		else if (arg == "--software") software = true;
+		else {
+			fprintf(
+				stderr,
+				"usage: %s [--record <session>] [--replay <session> [--report <frames.csv>]] [--benchmark <results.json>]\n"
+				"       [--golden <dir> [--update-golden]] [--software]\n",
+				argv[0]
+			);
+			return 1;
+		}
+	}
+
+	std::unique_ptr<InputReplay> replay;
+	if (!replayPath.empty()) {
+		replay = std::make_unique<InputReplay>(replayPath);
+		if (!replay->good()) {
+			fprintf(stderr, "can't open %s\n", replayPath.c_str());
+			return 1;
+		}
+		m_replayReport = std::make_unique<ReplayReport>();
+	}
+	else if (!recordPath.empty()) {
+		m_recorder = std::make_unique<InputRecorder>(recordPath);
+		if (!m_recorder->good()) {
+			fprintf(stderr, "can't write %s\n", recordPath.c_str());
+			return 1;
+		}
+	}
+
 	SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS);
 
 	SDL_GL_SetAttribute(SDL_GL_RED_SIZE, 8);
@@ -459,20 +516,39 @@ int App::start(int argc, char** argv) {
 		SDL_WINDOWPOS_CENTERED,
 		SDL_WINDOWPOS_CENTERED,
 		1280, 720,
-		SDL_WINDOW_SHOWN | SDL_WINDOW_OPENGL
+		(replay || !benchmarkPath.empty() || !goldenPath.empty() ? SDL_WINDOW_HIDDEN : SDL_WINDOW_SHOWN) | SDL_WINDOW_OPENGL
 	);
 	m_context = SDL_GL_CreateContext(m_window);
 	gladLoadGL();
 
 	m_gui = std::make_unique<QuickGUI_Impl>();
 	m_renderer = std::make_unique<Renderer>();
-	m_renderer->setup(m_gui->context(), 1920, 1080);
+	m_renderer->setup(m_gui->context(), 1920, 1080, software);
+	if (software && !m_renderer->software()) fprintf(stderr, "can't create the software renderer, drawing on the gpu\n");
+	m_timeline.setTimebase(m_timebase);
 
 	m_gui->window = m_window;
 
 	m_ndiOutput = std::make_unique<NDIOutput>();
-
-	mainLoop();
+	m_profilerMemory = MemoryReporter("profiler", [] { return MemoryUsage{ Profiler::memoryUsage(), 0 }; });
+
+	int result = 0;
+	if (!benchmarkPath.empty()) {
+		Benchmark benchmark(*m_renderer, m_gui->context(), m_timebase);
+		if (!benchmark.run()) result = 1;
+		benchmark.summary(std::cout);
+		if (!benchmark.writeJSON(benchmarkPath)) {
+			fprintf(stderr, "can't write %s\n", benchmarkPath.c_str());
+			result = 1;
+		}
+	}
+	else if (!goldenPath.empty()) {
+		GoldenTest golden(*m_renderer, m_timebase, goldenPath, updateGolden);
+		if (!golden.run()) result = 1;
+		golden.summary(std::cout);
+	}
+	else if (replay) result = replayLoop(*replay, reportPath);
+	else mainLoop();
 
 	m_ndiOutput->stop();
 
@@ -480,7 +556,7 @@ int App::start(int argc, char** argv) {
 	SDL_DestroyWindow(m_window);
 	SDL_Quit();
 
-	return 0;
+	return result;
 }
 
 void App::drawMenu() {
@@ -489,7 +565,7 @@ void App::drawMenu() {
 	m_gui->layoutPushBounds(bounds);
 
 	if (m_gui->button("snap", "Snapshot", m_gui->layoutCutLeft(120), IC_CAMERA)) {
-		auto data = m_renderer->target().readImage();
+		auto& data = m_renderer->lastFrameData();
 		stbi_write_png(
 			"snapshot.png",
 			m_renderer->target().width(),
@@ -501,7 +577,7 @@ void App::drawMenu() {
 
 	if (!m_ndiOutput->started()) {
 		if (m_gui->button("ndi_start", "Start NDI", m_gui->layoutCutLeft(120), IC_WIFI)) {
-			m_ndiOutput->start(m_renderer->target().width(), m_renderer->target().height());
+			m_ndiOutput->start(m_renderer->target().width(), m_renderer->target().height(), m_timebase);
 		}
 	}
 	else {
@@ -511,6 +587,19 @@ void App::drawMenu() {
 	}
 	m_gui->layoutCutLeft(5);
 
+	bool profiling = Profiler::enabled();
+	if (m_gui->button("profiler", profiling ? "Hide Profiler" : "Profiler", m_gui->layoutCutLeft(120), IC_SPEEDOMETER)) {
+		Profiler::setEnabled(!profiling);
+	}
+	m_gui->layoutCutLeft(5);
+
+	if (profiling && m_gui->button("trace", "Save Trace", m_gui->layoutCutLeft(120), IC_SAVE)) {
+		// relative to the working directory, the full path is printed so it can be found
+		std::string tracePath = std::filesystem::absolute("trace.json").string();
+		if (Profiler::writeTrace(tracePath)) printf("wrote %s\n", tracePath.c_str());
+		else fprintf(stderr, "can't write %s\n", tracePath.c_str());
+	}
+
 	m_gui->layoutPopBounds();
 }
 
@@ -554,23 +643,27 @@ void App::drawSideOptionsPanel() {
 
 	MenuItem tabs[] = {
 		{ IC_GEAR, "Options", {} },
-		{ IC_VIDEO, "Animation", {} }
+		{ IC_VIDEO, "Animation", {} },
+		{ IC_DOCUMENTS, "Layers", {} },
+		{ IC_DATABASE, "Memory", {} }
 	};
 
 	static size_t sidePanelSel = 0;
 
-	m_gui->tabs("side_tabs", m_gui->layoutCutTop(26), tabs, 2, sidePanelSel);
+	m_gui->tabs("side_tabs", m_gui->layoutCutTop(26), tabs, 4, sidePanelSel);
 
-	if (sidePanelSel == 0) drawOptionsPanel();
-	else if (sidePanelSel == 1) drawAnimationPanel();
+	if (sidePanelSel == 0) timed("options", [&] { drawOptionsPanel(); });
+	else if (sidePanelSel == 1) timed("animation", [&] { drawAnimationPanel(); });
+	else if (sidePanelSel == 2) timed("layers", [&] { drawLayersPanel(); });
+	else if (sidePanelSel == 3) timed("memory", [&] { drawMemoryPanel(); });
 	
 	m_gui->layoutPopBounds();
 }
 
 void App::drawBody() {
-	drawSideToolbar();
-	drawSideOptionsPanel();
-	drawMainView();
+	timed("toolbar", [&] { drawSideToolbar(); });
+	timed("side_panel", [&] { drawSideOptionsPanel(); });
+	timed("main_view", [&] { drawMainView(); });
 }
 
 void App::drawMainView() {
@@ -589,16 +682,36 @@ void App::drawMainView() {
 
 void App::drawViewport() {
 	auto bounds = m_gui->layoutPeek();
-	Rect imgBounds = m_gui->image(m_renderer->target().textureId(), bounds, ImageFit::Contain);
+	Rect imgBounds = m_gui->image(m_renderer->previewTexture(), bounds, ImageFit::Contain);
+
+	m_shapeIndex.update(m_shapes);
 
 	m_gui->viewport(
 		"vp",
 		imgBounds,
 		m_renderer->target().width(), m_renderer->target().height(),
-		m_shapes, &m_selectedShape
+		m_shapeIndex, &m_selectedShape
 	);
 }
 
+void App::drawLayersPanel() {
+	// top-most shape first, the index keeps each shape's draw order so finding the selected
+	// row doesn't walk the list
+	const size_t count = m_shapes.size();
+	auto rowOf = [count](int64_t order) { return order < 0 ? SIZE_MAX : count - 1 - size_t(order); };
+
+	size_t selected = m_selectedShape ? rowOf(m_shapeIndex.order(m_selectedShape)) : SIZE_MAX;
+
+	bool changed = m_gui->list("layers", m_gui->layoutPeek(), count, selected, [this, count](size_t row) {
+		const Shape* shape = m_shapes[count - 1 - row].get();
+		return MenuItem{ shape->icon(), shape->label(), {} };
+	});
+
+	if (changed && selected < count) {
+		m_selectedShape = m_shapes[count - 1 - selected].get();
+	}
+}
+
 void App::drawOptionsPanel() {
 	m_gui->beginPanel("options_panel", m_gui->layoutPeek());
 	if (m_selectedShape) {
@@ -632,15 +745,90 @@ void App::drawOptionsPanel() {
 	m_gui->endPanel();
 }
 
+void App::drawMemoryPanel() {
+	auto& arena = m_gui->frameArena();
+	auto bytes = [&](size_t n) {
+		if (n < 1024) return arena.format("{} B", n);
+		if (n < 1024 * 1024) return arena.format("{:.1f} KB", double(n) / 1024.0);
+		return arena.format("{:.1f} MB", double(n) / (1024.0 * 1024.0));
+	};
+	auto usageRow = [&](const MemoryUsage& current, const MemoryUsage& peak) {
+		auto cols = m_gui->layoutSliceHorizontal(19, 2);
+		m_gui->text(arena.format("CPU {} ({})", bytes(current.cpu), bytes(peak.cpu)), cols[0]);
+		m_gui->text(arena.format("GPU {} ({})", bytes(current.gpu), bytes(peak.gpu)), cols[1]);
+	};
+
+	m_gui->beginPanel("memory_panel", m_gui->layoutPeek());
+
+	m_gui->text("Total, current (peak)", m_gui->layoutCutTop(19));
+	usageRow(MemoryRegistry::total(), MemoryRegistry::peakTotal());
+	m_gui->layoutCutTop(8);
+
+	MemoryRegistry::entries(m_memoryEntries);
+	for (auto&& entry : m_memoryEntries) {
+		m_gui->text(entry.name, m_gui->layoutCutTop(19));
+		usageRow(entry.current, entry.peak);
+		m_gui->layoutCutTop(4);
+	}
+
+	m_gui->endPanel();
+}
+
 static MenuItem animationTypes[] = {
 	{ 0, "None", {} },
 	{ 0, "Fade", {} },
 	{ 0, "Reveal", {} }
 };
 
+void App::drawTimelineControls() {
+	m_gui->text("Timeline", m_gui->layoutCutTop(19));
+
+	// one frame per step, anything finer rounds back to the current frame in seek()
+	float time = m_timeline.time();
+	m_gui->number("tl_time", m_gui->layoutCutTop(24), time, 0.0f, 3600.0f, float(m_timebase.frameDuration()), "{:.2f}s", "Time:");
+	if (time != m_timeline.time()) {
+		m_timeline.seek(time);
+	}
+	m_gui->layoutCutTop(5);
+
+	{
+		auto cols = m_gui->layoutSliceHorizontal(24, 2);
+		if (!m_timeline.playing()) {
+			if (m_gui->button("tl_play", "Play", cols[0], IC_PLAY)) {
+				m_timeline.play();
+			}
+		}
+		else {
+			if (m_gui->button("tl_pause", "Pause", cols[0], IC_PAUSE)) {
+				m_timeline.pause();
+			}
+		}
+
+		if (m_gui->button("tl_rewind", "Rewind", cols[1], IC_BEGIN)) {
+			m_timeline.seek(0.0f);
+		}
+	}
+	m_gui->layoutCutTop(5);
+
+	if (m_selectedShape) {
+		auto cols = m_gui->layoutSliceHorizontal(24, 2);
+		if (m_gui->button("tl_key_add", "Add Key", cols[0], IC_PLUS)) {
+			m_timeline.keyShape(m_selectedShape, m_timeline.time());
+		}
+		if (m_gui->button("tl_key_remove", "Remove Key", cols[1], IC_MINUS)) {
+			m_timeline.removeKeys(m_selectedShape, m_timeline.time());
+		}
+		m_gui->layoutCutTop(5);
+	}
+
+	m_gui->layoutCutTop(8);
+}
+
 void App::drawAnimationPanel() {
 	m_gui->beginPanel("animation_panel", m_gui->layoutPeek());
 
+	drawTimelineControls();
+
 	if (m_selectedShape) {
 		static size_t selectedAnimTypeEnter = 0;
 		static size_t selectedAnimTypeExit = 0;
@@ -653,7 +841,9 @@ void App::drawAnimationPanel() {
 
 		auto&& enter = m_selectedShape->animations[size_t(ShapeAnimation::Enter)];
 		if (enter) {
-			enter->onGUI(m_gui.get(), "_onenter");
+			m_gui->pushID("onenter");
+			enter->onGUI(m_gui.get());
+			m_gui->popID();
 
 			m_gui->layoutCutTop(5);
 
@@ -672,7 +862,9 @@ void App::drawAnimationPanel() {
 
 		auto&& exit = m_selectedShape->animations[size_t(ShapeAnimation::Exit)];
 		if (exit) {
-			exit->onGUI(m_gui.get(), "_onexit");
+			m_gui->pushID("onexit");
+			exit->onGUI(m_gui.get());
+			m_gui->popID();
 
 			m_gui->layoutCutTop(5);
 
@@ -705,23 +897,33 @@ void App::drawAnimationPanel() {
 	m_gui->endPanel();
 }
 
+bool App::sceneAnimating() const {
+	return std::any_of(m_shapes.begin(), m_shapes.end(), [](auto&& shape) { return shape->animating(); });
+}
+
 void App::mainLoop() {
-	const double timeStep = 1.0 / 30;
+	Profiler::setThreadName("UI");
+
+	const double timeStep = m_timebase.frameDuration();
 	double startTime = double(SDL_GetTicks()) / 1000.0;
 	double accum = 0.0;
 
 	bool running = true;
+	bool hadInput = true;
 
 	while (running) {
-		bool canRender = false;
-		double currentTime = double(SDL_GetTicks()) / 1000.0;
-		double delta = currentTime - startTime;
-		startTime = currentTime;
-
-		accum += delta;
+		// sleep until the next frame is due. when nothing moves, sleep until input arrives or the
+		// gui wants a frame (cursor blink), capped so style.sty changes are still picked up.
+		double wait = timeStep - accum;
+		bool continuous = m_timeline.playing() || m_ndiOutput->started() || sceneAnimating();
+		if (!continuous && !m_gui->needsRedraw()) {
+			wait = std::max(wait, std::min(m_gui->redrawTimeout(), idleWait));
+		}
 
 		SDL_Event e;
-		while (SDL_PollEvent(&e)) {
+		bool gotEvent = SDL_WaitEventTimeout(&e, int(std::ceil(wait * 1000.0)));
+
+		for (; gotEvent; gotEvent = SDL_PollEvent(&e)) {
 			if (
 				e.type == SDL_WINDOWEVENT &&
 				e.window.event == SDL_WINDOWEVENT_CLOSE &&
@@ -729,33 +931,113 @@ void App::mainLoop() {
 			) {
 				running = false;
 			}
+			if (m_recorder) m_recorder->event(e);
 			m_gui->processEvent(&e);
+			hadInput = true;
 		}
 
+		FrameIndex steps = 0;
+		double currentTime = double(SDL_GetTicks()) / 1000.0;
+		double delta = currentTime - startTime;
+		startTime = currentTime;
+
+		accum += delta;
+
+		// wall time only decides how many frames are due, animations see the frame index
 		while (accum >= timeStep) {
 			accum -= timeStep;
-
-			canRender = true;
+			steps++;
 		}
 
-		if (canRender) {
-			m_renderer->render(m_shapes, timeStep);
+		if (steps > 0) {
+			Profiler::newFrame();
+			MemoryRegistry::sample(); // keeps the peaks current while the panel is closed
+			PROFILE_ZONE("App::frame");
+
+			m_frame += steps;
+			m_timeline.advance(steps);
+			if (m_timeline.evaluate()) m_sceneDirty = true;
+
+			if (m_sceneDirty || sceneAnimating()) {
+				m_renderer->render(m_shapes, m_frame, m_timebase);
+				m_sceneDirty = false;
+				m_gui->requestRedraw(); // the viewport shows the new program frame
+			}
+
+			// receivers expect a steady stream, an unchanged program is sent again as is
 			if (m_ndiOutput->started()) {
 				m_ndiOutput->send(m_renderer->lastFrameData());
 			}
 
-			glClearColor(0.14f, 0.14f, 0.14f, 1.0f);
-			glClear(GL_COLOR_BUFFER_BIT);
+			if (m_gui->needsRedraw()) {
+				int w, h;
+				SDL_GetWindowSize(m_window, &w, &h);
+				if (m_recorder) m_recorder->frame(m_frame, w, h);
 
-			int w, h;
-			SDL_GetWindowSize(m_window, &w, &h);
-			m_gui->beginFrame(w, h);
+				drawGUI(w, h);
+				SDL_GL_SwapWindow(m_window);
 
-			drawMenu();
-			drawBody();
-
-			m_gui->endFrame();
-			SDL_GL_SwapWindow(m_window);
+				// the gui edits shapes directly, so a frame that handled input may have changed them
+				if (hadInput) m_sceneDirty = true;
+				hadInput = false;
+			}
 		}
 	}
 }
+
+void App::drawGUI(int width, int height) {
+	glClearColor(0.14f, 0.14f, 0.14f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	timed("gui", [&] {
+		m_gui->beginFrame(width, height);
+
+		timed("menu", [&] { drawMenu(); });
+		drawBody();
+
+		m_gui->profilerHUD(Rect(float(width) - 660.0f, 50.0f, 340.0f, float(height) - 100.0f));
+
+		m_gui->endFrame();
+	});
+}
+
+int App::replayLoop(InputReplay& replay, const std::string& reportPath) {
+	// every recorded gui frame is drawn back to back: the same events reach the gui before the
+	// same frame, with the output clock and window size it had while recording
+	ReplayFrame frame;
+	while (replay.next(frame)) {
+		// the hidden window still gets system events, they aren't part of the session
+		SDL_Event e;
+		while (SDL_PollEvent(&e)) {}
+
+		m_replayReport->beginFrame();
+
+		for (auto&& ev : frame.events) m_gui->processEvent(&ev);
+
+		timed("render", [&] {
+			FrameIndex steps = frame.programFrame - m_frame;
+			if (steps > 0) {
+				m_frame = frame.programFrame;
+				m_timeline.advance(steps);
+				if (m_timeline.evaluate()) m_sceneDirty = true;
+			}
+
+			if (m_sceneDirty || sceneAnimating()) {
+				m_renderer->render(m_shapes, m_frame, m_timebase);
+				m_sceneDirty = false;
+			}
+		});
+
+		drawGUI(frame.width, frame.height);
+		if (!frame.events.empty()) m_sceneDirty = true;
+	}
+
+	if (!replay.good()) return 1;
+
+	m_replayReport->summary(std::cout);
+	if (!reportPath.empty() && !m_replayReport->writeCSV(reportPath)) {
+		fprintf(stderr, "can't write %s\n", reportPath.c_str());
+		return 1;
+	}
+	return 0;
+}
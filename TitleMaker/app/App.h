@@ -3,16 +3,21 @@
 #define SDL_MAIN_HANDLED
 #include <SDL2/SDL.h>
 
+#include <chrono>
 #include <memory>
 #include <vector>
 
 #include "../../QuickGUI/quickgui/QuickGUI.h"
 #include "../../QuickGUI/quickgui/Icons.h"
+#include "../../QuickGUI/quickgui/Profiler.h"
 
 #include "Renderer.h"
 #include "Shape.h"
 #include "Animation.h"
+#include "InputRecording.h"
 #include "NDIOutput.h"
+#include "SpatialIndex.h"
+#include "Timeline.h"
 
 enum class ManipulatorState {
 	None = 0,
@@ -39,9 +44,9 @@ public:
 	void setMousePosition(Point pos);
 
 	bool viewport(
-		const std::string& id, Rect bounds,
+		WidgetKey id, Rect bounds,
 		int virtualWidth, int virtualHeight,
-		const ShapeList& shapes,
+		const SpatialIndex& index,
 		Shape** selected
 	);
 
@@ -79,6 +84,36 @@ private:
 	// App
 	ShapeList m_shapes;
 	Shape* m_selectedShape{ nullptr };
+	SpatialIndex m_shapeIndex;
+	Timeline m_timeline;
+
+	// output clock, m_frame only ever moves in whole frames of m_timebase
+	Timebase m_timebase{ 30, 1 };
+	FrameIndex m_frame{ 0 };
+
+	// the program is only rendered again when something in it may have changed
+	bool m_sceneDirty{ true };
+	bool sceneAnimating() const;
+
+	MemoryReporter m_profilerMemory;
+	std::vector<MemoryEntry> m_memoryEntries; // reused by the memory panel every frame
+
+	// --record writes the gui input to a file, --replay feeds it back and times every frame
+	std::unique_ptr<InputRecorder> m_recorder;
+	std::unique_ptr<ReplayReport> m_replayReport;
+
+	// a profiler zone, and a replay report section while replaying
+	template <typename Fn>
+	void timed(const char* section, Fn&& fn) {
+		PROFILE_ZONE(section);
+		if (!m_replayReport) {
+			fn();
+			return;
+		}
+		auto start = std::chrono::steady_clock::now();
+		fn();
+		m_replayReport->section(section, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+	}
 	//
 
 	void drawMenu();
@@ -92,6 +127,12 @@ private:
 
 	void drawOptionsPanel();
 	void drawAnimationPanel();
+	void drawLayersPanel();
+	void drawMemoryPanel();
+	void drawTimelineControls();
+
+	void drawGUI(int width, int height);
 
 	void mainLoop();
+	int replayLoop(InputReplay& replay, const std::string& reportPath);
 };
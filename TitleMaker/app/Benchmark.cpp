@@ -0,0 +1,257 @@
+#include "Benchmark.h"
+#include "Scenes.h"
+
+#include "../../QuickGUI/glad/glad.h"
+#define NANOVG_GL3
+#include "../../QuickGUI/nanovg/nanovg_gl.h"
+#include "../../QuickGUI/nanovg/nanovg_record.h"
+#include "../../QuickGUI/quickgui/AllocationCounter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+
+using Clock = std::chrono::steady_clock;
+
+// every scene renders at least minFrames, then stops at maxFrames or once minSeconds have passed
+constexpr size_t warmupFrames = 3;
+constexpr size_t minFrames = 30;
+constexpr size_t maxFrames = 500;
+constexpr double minSeconds = 2.0;
+
+constexpr size_t easingSamples = 1 << 20;
+
+Benchmark::Benchmark(Renderer& renderer, NVGcontext* ctx, const Timebase& timebase)
+	: m_renderer(renderer), m_context(ctx), m_timebase(timebase)
+{
+}
+
+bool Benchmark::run() {
+	// names carry the shape count, they key the results when two runs are diffed
+	runScene("rectangles_100", scenes::rectangles(100));
+	runScene("rectangles_1000", scenes::rectangles(1000));
+	runScene("rectangles_10000", scenes::rectangles(10000));
+	runScene("rounded_bordered_1000", scenes::roundedBordered(1000));
+	runScene("gradients_1000", scenes::gradients(1000));
+	runScene("ellipses_1000", scenes::ellipses(1000));
+	runScene("text_100", scenes::paragraphs(100));
+	runScene("text_500", scenes::paragraphs(500));
+
+	// halfway through the default 1.5s enter animation
+	FrameIndex midAnimation = m_timebase.frames(0.75);
+	runScene("fade_1000", scenes::animated<FadeAnimation>(1000, [](FadeAnimation& anim, size_t i) {
+		anim.zoom = i % 2 == 1;
+	}), midAnimation);
+	runScene("reveal_1000", scenes::animated<RevealAnimation>(1000, [](RevealAnimation& anim, size_t i) {
+		anim.direction = RevealAnimation::_Direction(i % 4);
+	}), midAnimation);
+
+	bool tessellationPassed = runTessellation();
+	runEasings();
+	return tessellationPassed;
+}
+
+void Benchmark::runScene(const char* name, ShapeList shapes, FrameIndex frame) {
+	// the first render starts pending animations, the frame after that is the one measured
+	m_renderer.render(shapes, 0, m_timebase);
+	for (size_t i = 0; i < warmupFrames; i++) m_renderer.render(shapes, frame, m_timebase);
+
+	std::vector<double> times;
+	times.reserve(maxFrames);
+
+	uint64_t allocations = allocationCount();
+	auto start = Clock::now();
+	while (times.size() < maxFrames) {
+		auto frameStart = Clock::now();
+		m_renderer.render(shapes, frame, m_timebase);
+		auto frameEnd = Clock::now();
+		times.push_back(std::chrono::duration<double, std::nano>(frameEnd - frameStart).count());
+
+		if (times.size() >= minFrames && std::chrono::duration<double>(frameEnd - start).count() >= minSeconds) break;
+	}
+	allocations = allocationCount() - allocations;
+
+	SceneResult result;
+	result.name = name;
+	result.shapes = shapes.size();
+	result.frames = times.size();
+	result.allocations = double(allocations) / double(times.size());
+	// the software rasterizer doesn't count its calls
+	if (!m_renderer.software()) nvglFlushStatsGL3(m_context, &result.drawCalls, &result.vertices);
+
+	std::sort(times.begin(), times.end());
+	result.medianNs = times[times.size() / 2];
+	result.p95Ns = times[size_t(double(times.size() - 1) * 0.95)];
+
+	m_scenes.push_back(result);
+}
+
+bool Benchmark::runTessellation() {
+	// a recorder tessellates without drawing, the gpu stays out of the measurement
+	NVGcontext* recorder = nvgCreateRecorder(nvgInternalParams(m_context)->edgeAntiAlias);
+	if (!recorder) return false;
+
+	ShapeList shapes = scenes::roundedBordered(1000);
+	for (auto&& shape : scenes::ellipses(1000)) shapes.push_back(std::move(shape));
+
+	int previous = nvgSimdLevel();
+	std::vector<NVGvertex> reference;
+	bool passed = true;
+
+	for (int level = NVG_SIMD_SCALAR; level <= nvgSimdSupported(); level++) {
+		nvgSetSimdLevel(level);
+		recordShapes(recorder, shapes);
+
+		size_t frames = 0;
+		auto start = Clock::now();
+		double seconds = 0.0;
+		while (frames < maxFrames && (frames < minFrames || seconds < minSeconds / 4.0)) {
+			recordShapes(recorder, shapes);
+			frames++;
+			seconds = std::chrono::duration<double>(Clock::now() - start).count();
+		}
+
+		int count = 0;
+		const NVGvertex* verts = nvgrVertices(recorder, &count);
+		if (level == NVG_SIMD_SCALAR) reference.assign(verts, verts + count);
+
+		TessellationResult result{ simdLevelName(level) };
+		result.vertices = size_t(count);
+		result.verticesPerSecond = double(count) * double(frames) / seconds;
+		result.maxError = vertexError(reference, verts, size_t(count));
+		passed = passed && result.passed();
+		m_tessellation.push_back(result);
+	}
+
+	nvgSetSimdLevel(previous);
+	nvgDeleteRecorder(recorder);
+	return passed;
+}
+
+void Benchmark::runEasings() {
+	std::vector<float> t(easingSamples), out(easingSamples);
+	for (size_t i = 0; i < easingSamples; i++) t[i] = float(i) / float(easingSamples - 1);
+
+	// keeps the loops from being optimized away
+	volatile float sink = 0.0f;
+
+	auto measure = [&](auto&& fn) {
+		auto start = Clock::now();
+		fn();
+		return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / double(easingSamples);
+	};
+
+	for (size_t e = 0; e < size_t(EasingType::Bezier); e++) {
+		EasingType type = EasingType(e);
+		easings::table(type); // built on first use, not part of the measurement
+
+		EasingResult result{ easings::name(type) };
+		result.scalarNs = measure([&] {
+			float sum = 0.0f;
+			for (float x : t) sum += easings::evaluate(type, x);
+			sink = sum;
+		});
+		result.fastNs = measure([&] {
+			float sum = 0.0f;
+			for (float x : t) sum += easings::evaluateFast(type, x);
+			sink = sum;
+		});
+		result.batchNs = measure([&] {
+			easings::evaluate(type, t.data(), out.data(), easingSamples);
+			sink = out[easingSamples / 2];
+		});
+
+		m_easings.push_back(result);
+	}
+}
+
+void Benchmark::summary(std::ostream& out) const {
+	out << std::fixed << std::setprecision(1);
+
+	out << std::left << std::setw(24) << "scene" << std::right
+		<< std::setw(8) << "shapes" << std::setw(12) << "median us" << std::setw(12) << "p95 us"
+		<< std::setw(12) << "ns/shape" << std::setw(10) << "fps"
+		<< std::setw(8) << "draws" << std::setw(10) << "vertices" << std::setw(8) << "allocs" << '\n';
+	for (auto&& s : m_scenes) {
+		out << std::left << std::setw(24) << s.name << std::right
+			<< std::setw(8) << s.shapes << std::setw(12) << s.medianNs / 1000.0 << std::setw(12) << s.p95Ns / 1000.0
+			<< std::setw(12) << s.nsPerShape() << std::setw(10) << s.fps()
+			<< std::setw(8) << s.drawCalls << std::setw(10) << s.vertices << std::setw(8) << s.allocations << '\n';
+	}
+
+	out << '\n';
+	out << std::left << std::setw(20) << "tessellation" << std::right
+		<< std::setw(10) << "vertices" << std::setw(12) << "Mverts/s" << std::setw(12) << "max error" << "  result" << '\n';
+	for (auto&& t : m_tessellation) {
+		out << std::left << std::setw(20) << t.name << std::right
+			<< std::setw(10) << t.vertices << std::setw(12) << t.verticesPerSecond / 1e6
+			<< std::setw(12) << std::setprecision(6) << t.maxError << std::setprecision(1)
+			<< "  " << (t.passed() ? "ok" : "DRIFT") << '\n';
+	}
+
+	out << std::setprecision(2) << '\n';
+	out << std::left << std::setw(20) << "easing (ns/sample)" << std::right
+		<< std::setw(10) << "scalar" << std::setw(10) << "fast" << std::setw(10) << "batch" << '\n';
+	for (auto&& e : m_easings) {
+		out << std::left << std::setw(20) << e.name << std::right
+			<< std::setw(10) << e.scalarNs << std::setw(10) << e.fastNs << std::setw(10) << e.batchNs << '\n';
+	}
+}
+
+bool Benchmark::writeJSON(const std::string& path) const {
+	std::ofstream out(path, std::ios::trunc);
+	if (!out) return false;
+
+	auto glString = [](GLenum name) {
+		auto str = reinterpret_cast<const char*>(glGetString(name));
+		return std::string(str ? str : "");
+	};
+
+	out << std::fixed << std::setprecision(3);
+	out << "{\n";
+	out << "  \"version\": 2,\n";
+	out << "  \"gl_renderer\": \"" << glString(GL_RENDERER) << "\",\n";
+	out << "  \"gl_version\": \"" << glString(GL_VERSION) << "\",\n";
+	out << "  \"backend\": \"" << (m_renderer.software() ? "software" : "gl") << "\",\n";
+	out << "  \"scene_size\": [" << scenes::width << ", " << scenes::height << "],\n";
+
+	out << "  \"scenes\": [\n";
+	for (size_t i = 0; i < m_scenes.size(); i++) {
+		auto& s = m_scenes[i];
+		out << "    { \"name\": \"" << s.name << "\", \"shapes\": " << s.shapes << ", \"frames\": " << s.frames
+			<< ", \"median_ns\": " << s.medianNs << ", \"p95_ns\": " << s.p95Ns
+			<< ", \"ns_per_shape\": " << s.nsPerShape() << ", \"fps\": " << s.fps()
+			<< ", \"draw_calls\": " << s.drawCalls << ", \"vertices\": " << s.vertices
+			<< ", \"allocations\": " << s.allocations << " }"
+			<< (i + 1 < m_scenes.size() ? "," : "") << '\n';
+	}
+	out << "  ],\n";
+
+	out << "  \"tessellation\": [\n";
+	for (size_t i = 0; i < m_tessellation.size(); i++) {
+		auto& t = m_tessellation[i];
+		out << "    { \"name\": \"" << t.name << "\", \"vertices\": " << t.vertices
+			<< ", \"vertices_per_second\": " << t.verticesPerSecond << ", \"max_error\": ";
+		// json has no infinity, a vertex count that differs from scalar is written as null
+		if (std::isfinite(t.maxError)) out << t.maxError;
+		else out << "null";
+		out << ", \"passed\": " << (t.passed() ? "true" : "false") << " }"
+			<< (i + 1 < m_tessellation.size() ? "," : "") << '\n';
+	}
+	out << "  ],\n";
+
+	out << "  \"easings\": [\n";
+	for (size_t i = 0; i < m_easings.size(); i++) {
+		auto& e = m_easings[i];
+		out << "    { \"name\": \"" << e.name << "\", \"scalar_ns\": " << e.scalarNs
+			<< ", \"fast_ns\": " << e.fastNs << ", \"batch_ns\": " << e.batchNs << " }"
+			<< (i + 1 < m_easings.size() ? "," : "") << '\n';
+	}
+	out << "  ]\n";
+	out << "}\n";
+
+	return out.good();
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "Renderer.h"
+#include "Shape.h"
+#include "SimdCheck.h"
+#include "Timebase.h"
+
+// --benchmark: renders synthetic scenes through Renderer::render (read back included) and times
+// every frame, then times tessellation alone and the easing evaluators. Results are printed and written as JSON so runs
+// of two versions can be diffed. Run it with LIBGL_ALWAYS_SOFTWARE=1 to measure on llvmpipe, or with --software
+// to measure the cpu rasterizer instead. Exits non-zero when a simd level's tessellation drifts from the scalar one.
+
+struct SceneResult {
+	std::string name;
+	size_t shapes{ 0 };
+	size_t frames{ 0 };
+	double medianNs{ 0.0 }, p95Ns{ 0.0 }; // per frame
+	int drawCalls{ 0 }, vertices{ 0 }; // per frame
+	double allocations{ 0.0 }; // per frame, 0 unless built with QUICKGUI_COUNT_ALLOCATIONS
+
+	double nsPerShape() const { return shapes ? medianNs / double(shapes) : 0.0; }
+	double fps() const { return medianNs > 0.0 ? 1e9 / medianNs : 0.0; }
+};
+
+// one run of the tessellation scene per instruction set the cpu supports, see nvgSetSimdLevel
+struct TessellationResult {
+	const char* name;
+	size_t vertices{ 0 }; // per frame
+	double verticesPerSecond{ 0.0 };
+	double maxError{ 0.0 }; // largest difference to the scalar vertices, infinity if the counts differ
+
+	bool passed() const { return maxError <= maxSimdError; }
+};
+
+struct EasingResult {
+	const char* name;
+	double scalarNs, fastNs, batchNs; // per sample
+};
+
+class Benchmark {
+public:
+	Benchmark(Renderer& renderer, NVGcontext* ctx, const Timebase& timebase);
+
+	// false if a simd level's tessellation differs from the scalar one
+	bool run();
+
+	void summary(std::ostream& out) const;
+	bool writeJSON(const std::string& path) const;
+
+private:
+	Renderer& m_renderer;
+	NVGcontext* m_context;
+	Timebase m_timebase;
+
+	std::vector<SceneResult> m_scenes;
+	std::vector<TessellationResult> m_tessellation;
+	std::vector<EasingResult> m_easings;
+
+	// renders `frame` over and over, animations are started at frame 0 first
+	void runScene(const char* name, ShapeList shapes, FrameIndex frame = 0);
+	bool runTessellation();
+	void runEasings();
+};
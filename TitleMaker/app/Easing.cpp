@@ -0,0 +1,193 @@
+#include "Easing.h"
+
+#include <array>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define EASING_SSE2 1
+#include <emmintrin.h>
+#endif
+
+using EasingTables = std::array<std::array<float, easings::TableResolution + 1>, size_t(EasingType::Count)>;
+
+static EasingTables buildTables() {
+	EasingTables tables{};
+	for (size_t type = 0; type < size_t(EasingType::Count); type++) {
+		for (size_t i = 0; i <= easings::TableResolution; i++) {
+			float t = float(i) / float(easings::TableResolution);
+			tables[type][i] = easings::evaluate(EasingType(type), t);
+		}
+	}
+	return tables;
+}
+
+const float* easings::table(EasingType type) {
+	static const EasingTables tables = buildTables();
+	return tables[size_t(type)].data();
+}
+
+#ifdef EASING_SSE2
+static inline __m128 select(__m128 mask, __m128 a, __m128 b) {
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// t^n for the In* polynomial easings
+static inline __m128 powN(__m128 t, int n) {
+	__m128 r = t;
+	for (int i = 1; i < n; i++) r = _mm_mul_ps(r, t);
+	return r;
+}
+
+// four lanes of the polynomial families, same formulas as the scalar versions
+static bool evaluatePolynomial4(EasingType type, __m128 t, __m128& out) {
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 two = _mm_set1_ps(2.0f);
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128 tm1 = _mm_sub_ps(t, one);
+	const __m128 lower = _mm_cmplt_ps(t, half);
+
+	switch (type) {
+		case EasingType::Linear: out = t; return true;
+		case EasingType::InQuad: out = powN(t, 2); return true;
+		case EasingType::OutQuad: out = _mm_mul_ps(t, _mm_sub_ps(two, t)); return true;
+		case EasingType::InOutQuad: {
+			__m128 a = _mm_mul_ps(two, powN(t, 2));
+			__m128 b = _mm_add_ps(_mm_set1_ps(-1.0f), _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(4.0f), _mm_mul_ps(two, t)), t));
+			out = select(lower, a, b);
+		} return true;
+		case EasingType::InCubic: out = powN(t, 3); return true;
+		case EasingType::OutCubic: out = _mm_add_ps(powN(tm1, 3), one); return true;
+		case EasingType::InOutCubic: {
+			__m128 k = _mm_sub_ps(_mm_mul_ps(two, t), two);
+			__m128 a = _mm_mul_ps(_mm_set1_ps(4.0f), powN(t, 3));
+			__m128 b = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(tm1, k), k), one);
+			out = select(lower, a, b);
+		} return true;
+		case EasingType::InQuart: out = powN(t, 4); return true;
+		case EasingType::OutQuart: out = _mm_sub_ps(one, powN(tm1, 4)); return true;
+		case EasingType::InOutQuart: {
+			__m128 a = _mm_mul_ps(_mm_set1_ps(8.0f), powN(t, 4));
+			__m128 b = _mm_sub_ps(one, _mm_mul_ps(_mm_set1_ps(8.0f), powN(tm1, 4)));
+			out = select(lower, a, b);
+		} return true;
+		case EasingType::InQuint: out = powN(t, 5); return true;
+		case EasingType::OutQuint: out = _mm_add_ps(one, powN(tm1, 5)); return true;
+		case EasingType::InOutQuint: {
+			__m128 a = _mm_mul_ps(_mm_set1_ps(16.0f), powN(t, 5));
+			__m128 b = _mm_add_ps(one, _mm_mul_ps(_mm_set1_ps(16.0f), powN(tm1, 5)));
+			out = select(lower, a, b);
+		} return true;
+		default: return false;
+	}
+}
+
+// table lookup for four lanes, the gathers are scalar but the index math and lerp are not
+static inline __m128 evaluateTable4(const float* samples, __m128 t) {
+	const __m128 res = _mm_set1_ps(float(easings::TableResolution));
+	__m128 x = _mm_mul_ps(_mm_min_ps(_mm_max_ps(t, _mm_setzero_ps()), _mm_set1_ps(1.0f)), res);
+	// clamp the index, not x, so t = 1 lands on the last sample with f = 1
+	__m128i i = _mm_cvttps_epi32(_mm_min_ps(x, _mm_set1_ps(float(easings::TableResolution - 1))));
+	__m128 f = _mm_sub_ps(x, _mm_cvtepi32_ps(i));
+
+	alignas(16) int32_t idx[4];
+	_mm_store_si128((__m128i*)idx, i);
+
+	__m128 a = _mm_setr_ps(samples[idx[0]], samples[idx[1]], samples[idx[2]], samples[idx[3]]);
+	__m128 b = _mm_setr_ps(samples[idx[0] + 1], samples[idx[1] + 1], samples[idx[2] + 1], samples[idx[3] + 1]);
+	return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), f));
+}
+#endif
+
+void easings::evaluate(EasingType type, const float* t, float* out, size_t count) {
+	size_t i = 0;
+	const bool tabled = isTranscendental(type);
+	const float* samples = tabled ? table(type) : nullptr;
+
+#ifdef EASING_SSE2
+	__m128 probe;
+	const bool polynomial = evaluatePolynomial4(type, _mm_setzero_ps(), probe);
+
+	if (polynomial || tabled) {
+		for (; i + 4 <= count; i += 4) {
+			__m128 v = _mm_loadu_ps(t + i);
+			__m128 r;
+			if (polynomial) evaluatePolynomial4(type, v, r);
+			else r = evaluateTable4(samples, v);
+			_mm_storeu_ps(out + i, r);
+		}
+	}
+#endif
+
+	for (; i < count; i++) {
+		out[i] = tabled ? evaluateTable(type, t[i]) : evaluate(type, t[i]);
+	}
+}
+
+const char* easings::name(EasingType type) {
+	switch (type) {
+#define EASING_NAME(name) case EasingType::name: return #name;
+		EASING_TYPES(EASING_NAME)
+#undef EASING_NAME
+		case EasingType::Bezier: return "Bezier";
+		default: return "";
+	}
+}
+
+CubicBezier::CubicBezier(float x1, float y1, float x2, float y2) {
+	// x has to stay monotonic for the curve to be a function of time
+	m_x1 = std::clamp(x1, 0.0f, 1.0f);
+	m_x2 = std::clamp(x2, 0.0f, 1.0f);
+	m_y1 = y1;
+	m_y2 = y2;
+	m_linear = m_x1 == m_y1 && m_x2 == m_y2;
+
+	m_cx = 3.0f * m_x1;
+	m_bx = 3.0f * (m_x2 - m_x1) - m_cx;
+	m_ax = 1.0f - m_cx - m_bx;
+
+	m_cy = 3.0f * m_y1;
+	m_by = 3.0f * (m_y2 - m_y1) - m_cy;
+	m_ay = 1.0f - m_cy - m_by;
+
+	for (size_t i = 0; i < SampleCount; i++) {
+		m_samples[i] = sampleX(float(i) / float(SampleCount - 1));
+	}
+}
+
+float CubicBezier::solveT(float x) const {
+	constexpr float step = 1.0f / float(SampleCount - 1);
+
+	// find the sample interval and guess t by interpolating inside it
+	size_t i = 1;
+	while (i < SampleCount - 1 && m_samples[i] <= x) i++;
+	i--;
+
+	float span = m_samples[i + 1] - m_samples[i];
+	float t = float(i) * step + (span > 0.0f ? (x - m_samples[i]) / span : 0.0f) * step;
+
+	// two Newton steps are enough for most curves, as long as they stay inside the interval
+	float lo = float(i) * step, hi = lo + step;
+	if (slopeX(t) >= 1e-3f) {
+		float n = t;
+		for (int k = 0; k < 2; k++) {
+			n -= (sampleX(n) - x) / slopeX(n);
+		}
+		if (n >= lo && n <= hi && ::fabsf(sampleX(n) - x) < 1e-5f) return n;
+	}
+
+	// too flat (or too curved) for Newton, bisect inside the interval instead
+	for (int k = 0; k < 24; k++) {
+		t = (lo + hi) * 0.5f;
+		float d = sampleX(t) - x;
+		if (::fabsf(d) < 1e-7f) break;
+		if (d > 0.0f) hi = t;
+		else lo = t;
+	}
+	return t;
+}
+
+float CubicBezier::evaluate(float x) const {
+	if (m_linear) return x;
+	if (x <= 0.0f) return 0.0f;
+	if (x >= 1.0f) return 1.0f;
+	return sampleY(solveT(x));
+}
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#define PENNER 1.70158f
+#define PI 3.141592654f
+#define EPSILON 1e-5f
+
+namespace easings {
+	inline float Step(float t) { return t >= 0.5f ? 1.0f : 0.0f; }
+	inline float SmoothStep(float t, float e0 = 0.0f, float e1 = 1.0f) {
+		t = std::clamp((t - e0) / (e1 - e0), 0.0f, 1.0f);
+		return t * t * (3.0f - 2.0f * t);
+	}
+	inline float Linear(float t) { return t; }
+	inline float InQuad(float t) { return t * t; }
+	inline float OutQuad(float t) { return t * (2.0f - t); }
+	inline float InOutQuad(float t) {
+		return t < 0.5f ? 2.0f * t * t : -1.0f + (4.0f - 2.0f * t) * t;
+	}
+	inline float InCubic(float t) { return t * t * t; }
+	inline float OutCubic(float t) { return (--t) * t * t + 1.0f; }
+	inline float InOutCubic(float t) {
+		float k = 2.0f * t - 2.0f;
+		return t < 0.5f ? 4.0f * t * t * t : (t - 1.0f) * k * k + 1.0f;
+	}
+	inline float InQuart(float t) { return t * t * t * t; }
+	inline float OutQuart(float t) { return 1.0f - (--t) * t * t * t; }
+	inline float InOutQuart(float t) {
+		return t < 0.5f ? 8.0f * t * t * t * t : 1.0f - 8.0f * (--t) * t * t * t;
+	}
+	inline float InQuint(float t) { return t * t * t * t * t; }
+	inline float OutQuint(float t) { return 1.0f + (--t) * t * t * t * t; }
+	inline float InOutQuint(float t) {
+		return t < 0.5f ? 16.0f * t * t * t * t * t : 1.0f + 16.0f * (--t) * t * t * t * t;
+	}
+	inline float InSine(float t) { return -1.0f * ::cosf(t / 1.0f * (PI * 0.5f)) + 1.0f; }
+	inline float OutSine(float t) { return ::sinf(t / 1.0f * (PI * 0.5f)); }
+	inline float InOutSine(float t) { return -1.0f / 2.0f * (::cosf(PI * t) - 1.0f); }
+	inline float InExpo(float t) {
+		return (t <= EPSILON) ? 0.0f : ::powf(2.0f, 10.0f * (t - 1.0f));
+	}
+	inline float OutExpo(float t) {
+		return (t >= 1.0f - EPSILON) ? 1.0f : (-::powf(2.0f, -10.0f * t) + 1.0f);
+	}
+	inline float InOutExpo(float t) {
+		if (t <= EPSILON) return 0.0f;
+		if (t >= 1.0f - EPSILON) return 1.0f;
+		if ((t /= 1.0f / 2.0f) < 1.0f) return 1.0f / 2.0f * ::powf(2.0f, 10.0f * (t - 1.0f));
+		return 1.0f / 2.0f * (-::powf(2.0f, -10.0f * --t) + 2.0f);
+	}
+	inline float InCirc(float t) {
+		return -1.0f * (::sqrtf(1.0f - t * t) - 1.0f);
+	}
+	inline float OutCirc(float t) {
+		return ::sqrtf(1.0f - (t -= 1.0f) * t);
+	}
+	inline float InOutCirc(float t) {
+		if ((t /= 0.5f) < 1.0f) return -1.0f / 2.0f * (::sqrtf(1.0f - t * t) - 1.0f);
+		return 1.0f / 2.0f * (::sqrtf(1.0f - (t -= 2.0f) * t) + 1.0f);
+	}
+	inline float InElastic(float t) {
+		float s = PENNER;
+		float p = 0.0f;
+		float a = 1.0f;
+		if (t <= EPSILON) return 0.0f;
+		if (t >= 1.0f - EPSILON) return 1.0f;
+		if (!p) p = 0.3f;
+		if (a < 1.0f) {
+			a = 1.0f;
+			s = p / 4.0f;
+		}
+		else s = p / (2.0f * PI) * ::asinf(1.0f / a);
+		return -(a * ::powf(2.0f, 10.0f * (t -= 1.0f)) * ::sinf((t - s) * (2.0f * PI) / p));
+	}
+	inline float OutElastic(float t) {
+		float s = PENNER;
+		float p = 0.0f, a = 1.0f;
+		if (t <= EPSILON) return 0.0f;
+		if (t >= 1.0f - EPSILON) return 1.0f;
+		if (!p) p = 0.3f;
+		if (a < 1.0f) {
+			a = 1.0f;
+			s = p / 4.0f;
+		}
+		else s = p / (2.0f * PI) * ::asinf(1.0f / a);
+		return a * ::powf(2.0f, -10.0f * t) * ::sinf((t - s) * (2.0f * PI) / p) + 1.0f;
+	}
+	inline float InOutElastic(float t) {
+		float s = PENNER;
+		float p = 0;
+		float a = 1;
+		if (t <= EPSILON) return 0.0f;
+		if ((t /= 0.5f) >= 2.0f - EPSILON) return 1.0f;
+		if (!p) p = (0.3f * 1.5f);
+		if (a < 1.0f) {
+			a = 1.0f;
+			s = p / 4.0f;
+		}
+		else s = p / (2.0f * PI) * ::asinf(1.0f / a);
+		if (t < 1.0f)
+			return -0.5f * (a * ::powf(2.0f, 10.0f * (t -= 1.0f)) * ::sinf((t - s) * (2.0f * PI) / p));
+		return a * ::powf(2.0f, -10.0f * (t -= 1.0f)) * ::sinf((t - s) * (2.0f * PI) / p) * 0.5f + 1.0f;
+	}
+	inline float InBack(float t) {
+		return 1.0f * t * t * ((PENNER + 1.0f) * t - PENNER);
+	}
+	inline float OutBack(float t) {
+		return 1.0f * ((t = t / 1.0f - 1.0f) * t * ((PENNER + 1.0f) * t + PENNER) + 1.0f);
+	}
+	inline float InOutBack(float t) {
+		float s = PENNER;
+		if ((t /= 0.5f) < 1.0f) return 1.0f / 2.0f * (t * t * (((s *= (1.525f)) + 1.0f) * t - s));
+		return 1.0f / 2.0f * ((t -= 2.0f) * t * (((s *= (1.525f)) + 1.0f) * t + s) + 2.0f);
+	}
+	inline float OutBounce(float t) {
+		if ((t /= 1.0f) < (1.0f / 2.75f)) {
+			return (7.5625f * t * t);
+		}
+		else if (t < (2.0f / 2.75f)) {
+			return (7.5625f * (t -= (1.5f / 2.75f)) * t + 0.75f);
+		}
+		else if (t < (2.5f / 2.75f)) {
+			return (7.5625f * (t -= (2.25f / 2.75f)) * t + 0.9375f);
+		}
+		else {
+			return (7.5625f * (t -= (2.625f / 2.75f)) * t + 0.984375f);
+		}
+	}
+	inline float InBounce(float t) {
+		return 1.0f - OutBounce(1.0f - t);
+	}
+	inline float InOutBounce(float t) {
+		if (t < 0.5f) return InBounce(t * 2.0f) * 0.5f;
+		return OutBounce(t * 2.0f - 1.0f) * 0.5f + 0.5f;
+	}
+	inline float Hold(float t) { return t >= 1.0f ? 1.0f : 0.0f; }
+}
+
+#define EASING_TYPES(X) \
+	X(Linear) \
+	X(InQuad) X(OutQuad) X(InOutQuad) \
+	X(InCubic) X(OutCubic) X(InOutCubic) \
+	X(InQuart) X(OutQuart) X(InOutQuart) \
+	X(InQuint) X(OutQuint) X(InOutQuint) \
+	X(InSine) X(OutSine) X(InOutSine) \
+	X(InExpo) X(OutExpo) X(InOutExpo) \
+	X(InCirc) X(OutCirc) X(InOutCirc) \
+	X(InElastic) X(OutElastic) X(InOutElastic) \
+	X(InBack) X(OutBack) X(InOutBack) \
+	X(InBounce) X(OutBounce) X(InOutBounce) \
+	X(Step) X(Hold)
+
+enum class EasingType : uint8_t {
+#define EASING_ENUM(name) name,
+	EASING_TYPES(EASING_ENUM)
+#undef EASING_ENUM
+	// user-defined curve, the control points live in a CubicBezier next to the EasingType
+	Bezier,
+	Count
+};
+
+namespace easings {
+	template <EasingType E> struct Evaluator;
+
+#define EASING_EVALUATOR(name) \
+	template <> struct Evaluator<EasingType::name> { \
+		static float evaluate(float t) { return name(t); } \
+	};
+	EASING_TYPES(EASING_EVALUATOR)
+#undef EASING_EVALUATOR
+
+	template <EasingType E>
+	inline float evaluate(float t) { return Evaluator<E>::evaluate(t); }
+
+	// direct dispatch, the switch compiles to a jump into the inlined evaluators
+	inline float evaluate(EasingType type, float t) {
+		switch (type) {
+#define EASING_CASE(name) case EasingType::name: return evaluate<EasingType::name>(t);
+			EASING_TYPES(EASING_CASE)
+#undef EASING_CASE
+			default: return t;
+		}
+	}
+
+	// easings that call into libm (pow/sin/cos/asin) and are worth a table lookup.
+	// Circ is left out: sqrt is a single instruction and its slope at the ends is too steep for the table.
+	constexpr bool isTranscendental(EasingType type) {
+		switch (type) {
+			case EasingType::InSine: case EasingType::OutSine: case EasingType::InOutSine:
+			case EasingType::InExpo: case EasingType::OutExpo: case EasingType::InOutExpo:
+			case EasingType::InElastic: case EasingType::OutElastic: case EasingType::InOutElastic:
+				return true;
+			default: return false;
+		}
+	}
+
+	constexpr size_t TableResolution = 512;
+
+	// table of TableResolution + 1 samples over [0, 1], built once on first use
+	const float* table(EasingType type);
+
+	// linear interpolation into the precomputed table, t is clamped to [0, 1]
+	inline float evaluateTable(EasingType type, float t) {
+		const float* samples = table(type);
+		float x = std::clamp(t, 0.0f, 1.0f) * float(TableResolution);
+		size_t i = std::min(size_t(x), TableResolution - 1);
+		float f = x - float(i);
+		return samples[i] + (samples[i + 1] - samples[i]) * f;
+	}
+
+	// polynomial easings are evaluated directly, transcendental ones through the table
+	inline float evaluateFast(EasingType type, float t) {
+		return isTranscendental(type) ? evaluateTable(type, t) : evaluate(type, t);
+	}
+
+	// evaluates `count` values at once. polynomial easings go through SSE2 when available,
+	// transcendental ones through the table, the rest one by one.
+	void evaluate(EasingType type, const float* t, float* out, size_t count);
+
+	const char* name(EasingType type);
+}
+
+// CSS-style cubic-bezier(x1, y1, x2, y2) easing, with the end points fixed at (0, 0) and (1, 1).
+// x(t) is sampled on construction so evaluating only needs a table lookup for the initial guess
+// and a couple of Newton steps to invert it.
+class CubicBezier {
+public:
+	CubicBezier(float x1 = 0.25f, float y1 = 0.1f, float x2 = 0.25f, float y2 = 1.0f);
+
+	float evaluate(float x) const;
+
+	float x1() const { return m_x1; }
+	float y1() const { return m_y1; }
+	float x2() const { return m_x2; }
+	float y2() const { return m_y2; }
+
+	bool operator ==(const CubicBezier& o) const {
+		return m_x1 == o.m_x1 && m_y1 == o.m_y1 && m_x2 == o.m_x2 && m_y2 == o.m_y2;
+	}
+
+	static constexpr size_t SampleCount = 11;
+
+private:
+	float m_x1, m_y1, m_x2, m_y2;
+	// polynomial coefficients, x(t) = ((ax * t + bx) * t + cx) * t
+	float m_ax, m_bx, m_cx;
+	float m_ay, m_by, m_cy;
+	float m_samples[SampleCount];
+	bool m_linear;
+
+	float sampleX(float t) const { return ((m_ax * t + m_bx) * t + m_cx) * t; }
+	float sampleY(float t) const { return ((m_ay * t + m_by) * t + m_cy) * t; }
+	float slopeX(float t) const { return (3.0f * m_ax * t + 2.0f * m_bx) * t + m_cx; }
+
+	float solveT(float x) const;
+};
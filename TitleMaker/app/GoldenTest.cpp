@@ -0,0 +1,253 @@
+#include "GoldenTest.h"
+#include "Scenes.h"
+
+#include "../stb_image_write.h"
+#include "../../QuickGUI/nanovg/stb_image.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t warmupFrames = 3;
+constexpr size_t timedFrames = 30;
+
+// pixelmatch's default threshold: two colors closer than this in YIQ look the same
+constexpr float colorThreshold = 0.1f;
+constexpr float maxColorDelta = 35215.0f * colorThreshold * colorThreshold;
+// share of the pixels that may still differ, antialiased edges move a little between drivers
+constexpr double maxMismatchedShare = 0.001;
+// stored budgets sit this far above the median they were recorded with, frame times jitter
+constexpr double budgetHeadroom = 1.5;
+
+// frames are premultiplied, compared as they would look over white
+static void overWhite(const uint8_t* pixel, float* rgb) {
+	for (int c = 0; c < 3; c++) rgb[c] = float(pixel[c]) + 255.0f - float(pixel[3]);
+}
+
+// squared YIQ distance as in pixelmatch, 35215 is the largest possible value
+static float colorDelta(const uint8_t* a, const uint8_t* b) {
+	float ca[3], cb[3];
+	overWhite(a, ca);
+	overWhite(b, cb);
+
+	float r = ca[0] - cb[0], g = ca[1] - cb[1], bl = ca[2] - cb[2];
+	float y = r * 0.29889531f + g * 0.58662247f + bl * 0.11448223f;
+	float i = r * 0.59597799f - g * 0.27417610f - bl * 0.32180189f;
+	float q = r * 0.21147017f - g * 0.52261711f + bl * 0.31114694f;
+	return 0.5053f * y * y + 0.299f * i * i + 0.1957f * q * q;
+}
+
+// png holds straight alpha, frames are premultiplied
+static std::vector<uint8_t> unpremultiplied(const std::vector<uint8_t>& frame) {
+	std::vector<uint8_t> out(frame.size());
+	for (size_t i = 0; i < frame.size(); i += 4) {
+		unsigned a = frame[i + 3];
+		for (size_t c = 0; c < 3; c++) out[i + c] = a == 0 ? 0 : uint8_t(std::min(255u, (frame[i + c] * 255u + a / 2) / a));
+		out[i + 3] = uint8_t(a);
+	}
+	return out;
+}
+
+static void premultiply(uint8_t* pixels, size_t count) {
+	for (size_t i = 0; i < count * 4; i += 4) {
+		unsigned a = pixels[i + 3];
+		for (size_t c = 0; c < 3; c++) pixels[i + c] = uint8_t((pixels[i + c] * a + 127u) / 255u);
+	}
+}
+
+bool GoldenResult::imagePassed() const {
+	return double(mismatched) <= double(pixels) * maxMismatchedShare;
+}
+
+GoldenTest::GoldenTest(Renderer& renderer, const Timebase& timebase, std::string directory, bool update)
+	: m_renderer(renderer), m_timebase(timebase), m_directory(std::move(directory)), m_update(update)
+{
+}
+
+bool GoldenTest::run() {
+	if (m_update) {
+		std::error_code error;
+		std::filesystem::create_directories(m_directory, error);
+	}
+	else loadBudgets();
+
+	runScene("rectangles", scenes::rectangles(200));
+	runScene("rounded_bordered", scenes::roundedBordered(200));
+	runScene("gradients", scenes::gradients(200));
+	runScene("ellipses", scenes::ellipses(200));
+	runScene("text", scenes::paragraphs(20));
+
+	// halfway through the default 1.5s enter animation
+	FrameIndex midAnimation = m_timebase.frames(0.75);
+	runScene("fade", scenes::animated<FadeAnimation>(200, [](FadeAnimation& anim, size_t i) {
+		anim.zoom = i % 2 == 1;
+	}), midAnimation);
+	runScene("reveal", scenes::animated<RevealAnimation>(200, [](RevealAnimation& anim, size_t i) {
+		anim.direction = RevealAnimation::_Direction(i % 4);
+	}), midAnimation);
+
+	// the shape scenes in one frame, text only tessellates on a context with a font atlas
+	ShapeList tessellated = scenes::rectangles(200);
+	for (auto* extra : { scenes::roundedBordered, scenes::gradients, scenes::ellipses }) {
+		for (auto&& shape : extra(200)) tessellated.push_back(std::move(shape));
+	}
+	m_simd = checkSimdLevels(tessellated, nvgInternalParams(m_renderer.context())->edgeAntiAlias);
+	bool simdPassed = !m_simd.empty() && std::all_of(m_simd.begin(), m_simd.end(), [](const SimdLevelResult& level) { return level.passed(); });
+
+	if (m_update) {
+		m_budgets.clear();
+		for (auto&& result : m_results) {
+			result.budgetNs = result.medianNs * budgetHeadroom;
+			m_budgets[result.name] = result.budgetNs;
+		}
+		if (!writeBudgets()) {
+			fprintf(stderr, "can't write %s/budgets.csv\n", m_directory.c_str());
+			return false;
+		}
+	}
+
+	return simdPassed && std::all_of(m_results.begin(), m_results.end(), [](const GoldenResult& result) { return result.passed(); });
+}
+
+void GoldenTest::runScene(const char* name, ShapeList shapes, FrameIndex frame) {
+	// the first render starts pending animations, the frames after that are the ones checked
+	m_renderer.render(shapes, 0, m_timebase);
+	for (size_t i = 0; i < warmupFrames; i++) m_renderer.render(shapes, frame, m_timebase);
+
+	std::vector<double> times;
+	times.reserve(timedFrames);
+	for (size_t i = 0; i < timedFrames; i++) {
+		auto start = Clock::now();
+		m_renderer.render(shapes, frame, m_timebase);
+		times.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+	}
+	std::sort(times.begin(), times.end());
+
+	GoldenResult result;
+	result.name = name;
+	result.medianNs = times[times.size() / 2];
+	// a scene without a budget would pass any frame time, that's a failure like a missing golden
+	if (auto budget = m_budgets.find(result.name); budget != m_budgets.end()) result.budgetNs = budget->second;
+	else if (!m_update) result.error = "no budget in " + m_directory + "/budgets.csv";
+
+	compare(result, m_renderer.lastFrameData());
+	m_results.push_back(result);
+}
+
+void GoldenTest::compare(GoldenResult& result, const std::vector<uint8_t>& frame) {
+	int width = m_renderer.target().width(), height = m_renderer.target().height();
+	std::string path = m_directory + "/" + result.name + ".png";
+	result.pixels = size_t(width) * size_t(height);
+
+	if (m_update) {
+		if (!stbi_write_png(path.c_str(), width, height, 4, unpremultiplied(frame).data(), width * 4)) result.error = "can't write " + path;
+		return;
+	}
+
+	int goldenWidth = 0, goldenHeight = 0, channels = 0;
+	std::unique_ptr<stbi_uc, void (*)(void*)> golden(
+		stbi_load(path.c_str(), &goldenWidth, &goldenHeight, &channels, 4), stbi_image_free
+	);
+	if (!golden) {
+		result.error = "can't read " + path;
+		return;
+	}
+	if (goldenWidth != width || goldenHeight != height) {
+		result.error = std::format("{} is {}x{}, the frame {}x{}", path, goldenWidth, goldenHeight, width, height);
+		return;
+	}
+	premultiply(golden.get(), result.pixels);
+
+	// mismatches in red over a faded copy of the golden
+	std::vector<uint8_t> diff(result.pixels * 4);
+	for (size_t i = 0; i < result.pixels; i++) {
+		const uint8_t* expected = golden.get() + i * 4;
+		uint8_t* out = &diff[i * 4];
+		if (colorDelta(expected, &frame[i * 4]) > maxColorDelta) {
+			result.mismatched++;
+			out[0] = 255; out[1] = 0; out[2] = 0;
+		}
+		else {
+			float rgb[3];
+			overWhite(expected, rgb);
+			float luma = rgb[0] * 0.29889531f + rgb[1] * 0.58662247f + rgb[2] * 0.11448223f;
+			out[0] = out[1] = out[2] = uint8_t(255.0f - (255.0f - luma) * 0.1f);
+		}
+		out[3] = 255;
+	}
+	if (result.imagePassed()) return;
+
+	std::filesystem::path failures = std::filesystem::path(m_directory) / "failures";
+	std::error_code error;
+	std::filesystem::create_directories(failures, error);
+	std::string actualPath = (failures / (result.name + ".png")).string();
+	std::string diffPath = (failures / (result.name + ".diff.png")).string();
+	if (!stbi_write_png(actualPath.c_str(), width, height, 4, unpremultiplied(frame).data(), width * 4) ||
+		!stbi_write_png(diffPath.c_str(), width, height, 4, diff.data(), width * 4)) {
+		result.error = "can't write " + failures.string();
+	}
+}
+
+void GoldenTest::loadBudgets() {
+	std::ifstream in(m_directory + "/budgets.csv");
+	std::string line;
+	while (std::getline(in, line)) {
+		// scene,median_us
+		size_t comma = line.find(',');
+		if (comma == std::string::npos) continue;
+
+		char* end = nullptr;
+		std::string value = line.substr(comma + 1);
+		double us = std::strtod(value.c_str(), &end);
+		if (end == value.c_str()) continue; // the header
+		m_budgets[line.substr(0, comma)] = us * 1000.0;
+	}
+}
+
+bool GoldenTest::writeBudgets() const {
+	std::ofstream out(m_directory + "/budgets.csv", std::ios::trunc);
+	if (!out) return false;
+
+	out << std::fixed << std::setprecision(1);
+	out << "scene,median_us\n";
+	for (auto&& [name, ns] : m_budgets) out << name << ',' << ns / 1000.0 << '\n';
+	return out.good();
+}
+
+void GoldenTest::summary(std::ostream& out) const {
+	out << std::fixed << std::setprecision(1);
+
+	out << std::left << std::setw(20) << "scene" << std::right
+		<< std::setw(12) << "mismatched" << std::setw(12) << "median us" << std::setw(12) << "budget us"
+		<< "  result" << '\n';
+	for (auto&& r : m_results) {
+		const char* status = !r.error.empty() ? "error" : !r.imagePassed() ? "IMAGE DRIFT" : !r.timePassed() ? "OVER BUDGET" : "ok";
+		out << std::left << std::setw(20) << r.name << std::right
+			<< std::setw(12) << r.mismatched << std::setw(12) << r.medianNs / 1000.0 << std::setw(12) << r.budgetNs / 1000.0
+			<< "  " << status << '\n';
+	}
+
+	out << '\n';
+	out << std::left << std::setw(20) << "simd level" << std::right
+		<< std::setw(12) << "vertices" << std::setw(12) << "max error" << "  result" << '\n';
+	if (m_simd.empty()) out << "can't create a recorder, tessellation not checked\n";
+	for (auto&& s : m_simd) {
+		out << std::left << std::setw(20) << s.name << std::right
+			<< std::setw(12) << s.vertices << std::setw(12) << std::setprecision(6) << s.maxError << std::setprecision(1)
+			<< "  " << (s.passed() ? "ok" : "DRIFT") << '\n';
+	}
+
+	for (auto&& r : m_results) {
+		if (!r.error.empty()) out << r.name << ": " << r.error << '\n';
+		else if (!r.imagePassed()) out << r.name << ": see " << m_directory << "/failures/" << r.name << ".diff.png\n";
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Renderer.h"
+#include "Shape.h"
+#include "SimdCheck.h"
+#include "Timebase.h"
+
+// --golden <dir>: renders a fixed corpus of scenes through Renderer::render and checks every frame
+// against <dir>/<scene>.png with a perceptual color tolerance, and its median frame time against
+// the budget in <dir>/budgets.csv. A frame that drifts is written to <dir>/failures together with
+// a diff image. --update-golden writes the images and budgets from this run instead. Every simd
+// level's tessellation of the corpus is checked against the scalar one, in both modes.
+//
+// Meant for headless Mesa, e.g. SDL_VIDEODRIVER=offscreen LIBGL_ALWAYS_SOFTWARE=1. The reference
+// corpus is TitleMaker/golden, see the README for the setup it was recorded on. Budgets only mean
+// something on the machine that recorded them.
+
+struct GoldenResult {
+	std::string name;
+	size_t pixels{ 0 }, mismatched{ 0 };
+	double medianNs{ 0.0 };
+	double budgetNs{ 0.0 }; // 0 until --update-golden records one
+	std::string error; // the golden or budget is missing or unreadable, or the frame can't be written
+
+	bool imagePassed() const;
+	bool timePassed() const { return medianNs <= budgetNs; }
+	bool passed() const { return error.empty() && imagePassed() && timePassed(); }
+};
+
+class GoldenTest {
+public:
+	GoldenTest(Renderer& renderer, const Timebase& timebase, std::string directory, bool update);
+
+	// false if any scene or simd level drifted
+	bool run();
+
+	void summary(std::ostream& out) const;
+
+private:
+	Renderer& m_renderer;
+	Timebase m_timebase;
+	std::string m_directory;
+	bool m_update;
+
+	std::map<std::string, double> m_budgets; // median ns per scene
+	std::vector<GoldenResult> m_results;
+	std::vector<SimdLevelResult> m_simd;
+
+	// renders `frame` until the timing settles, then checks (or stores) the last image
+	void runScene(const char* name, ShapeList shapes, FrameIndex frame = 0);
+	void compare(GoldenResult& result, const std::vector<uint8_t>& frame);
+
+	void loadBudgets();
+	bool writeBudgets() const;
+};
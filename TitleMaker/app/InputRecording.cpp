@@ -0,0 +1,173 @@
+#include "InputRecording.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <format>
+#include <limits>
+#include <ostream>
+#include <sstream>
+
+static constexpr double notRun = std::numeric_limits<double>::quiet_NaN();
+
+InputRecorder::InputRecorder(const std::string& path)
+	: m_out(path, std::ios::trunc)
+{
+}
+
+void InputRecorder::event(const SDL_Event& e) {
+	switch (e.type) {
+		case SDL_MOUSEBUTTONDOWN: m_out << "d " << int(e.button.button) << '\n'; break;
+		case SDL_MOUSEBUTTONUP: m_out << "u " << int(e.button.button) << '\n'; break;
+		case SDL_MOUSEMOTION: m_out << "m " << e.motion.x << ' ' << e.motion.y << '\n'; break;
+		case SDL_MOUSEWHEEL: m_out << "w " << e.wheel.y << '\n'; break;
+		case SDL_KEYDOWN:
+		case SDL_KEYUP:
+			m_out << (e.type == SDL_KEYDOWN ? "k " : "r ")
+				<< e.key.keysym.sym << ' '
+				<< int(e.key.keysym.scancode) << ' '
+				<< e.key.keysym.mod << '\n';
+			break;
+		case SDL_TEXTINPUT: m_out << "t " << e.text.text << '\n'; break;
+	}
+}
+
+void InputRecorder::frame(FrameIndex programFrame, int width, int height) {
+	m_out << "f " << programFrame << ' ' << width << ' ' << height << '\n';
+	// a crash mid-session should still leave a usable recording
+	m_out.flush();
+}
+
+InputReplay::InputReplay(const std::string& path)
+	: m_in(path)
+{
+	m_good = m_in.good();
+}
+
+bool InputReplay::next(ReplayFrame& frame) {
+	frame.events.clear();
+
+	std::string line;
+	while (m_good && std::getline(m_in, line)) {
+		m_line++;
+		if (line.empty()) continue;
+
+		std::istringstream args(line.substr(1));
+		SDL_Event e{};
+
+		switch (line[0]) {
+			case 'f':
+				args >> frame.programFrame >> frame.width >> frame.height;
+				if (!args) break;
+				return true;
+			case 'd':
+			case 'u': {
+				int button = 0;
+				args >> button;
+				e.type = line[0] == 'd' ? SDL_MOUSEBUTTONDOWN : SDL_MOUSEBUTTONUP;
+				e.button.state = line[0] == 'd' ? SDL_PRESSED : SDL_RELEASED;
+				e.button.button = Uint8(button);
+			} break;
+			case 'm':
+				e.type = SDL_MOUSEMOTION;
+				args >> e.motion.x >> e.motion.y;
+				break;
+			case 'w':
+				e.type = SDL_MOUSEWHEEL;
+				args >> e.wheel.y;
+				break;
+			case 'k':
+			case 'r': {
+				int sym = 0, scancode = 0, mod = 0;
+				args >> sym >> scancode >> mod;
+				e.type = line[0] == 'k' ? SDL_KEYDOWN : SDL_KEYUP;
+				e.key.state = line[0] == 'k' ? SDL_PRESSED : SDL_RELEASED;
+				e.key.keysym.sym = SDL_Keycode(sym);
+				e.key.keysym.scancode = SDL_Scancode(scancode);
+				e.key.keysym.mod = Uint16(mod);
+			} break;
+			case 't': {
+				e.type = SDL_TEXTINPUT;
+				std::string_view text = line.size() > 2 ? std::string_view(line).substr(2) : std::string_view();
+				std::memcpy(e.text.text, text.data(), std::min(text.size(), sizeof(e.text.text) - 1));
+			} break;
+			default:
+				args.setstate(std::ios::failbit);
+				break;
+		}
+
+		if (!args && line[0] != 't') {
+			fprintf(stderr, "replay:%zu: malformed entry '%s'\n", m_line, line.c_str());
+			m_good = false;
+			return false;
+		}
+		frame.events.push_back(e);
+	}
+
+	// events after the last drawn frame never reached the gui
+	return false;
+}
+
+void ReplayReport::beginFrame() {
+	m_frames.emplace_back(m_sections.size(), notRun);
+}
+
+void ReplayReport::section(std::string_view name, double seconds) {
+	auto it = std::find(m_sections.begin(), m_sections.end(), name);
+	size_t index = size_t(it - m_sections.begin());
+	if (it == m_sections.end()) m_sections.emplace_back(name);
+
+	auto& row = m_frames.back();
+	if (row.size() <= index) row.resize(index + 1, notRun);
+
+	// a section entered more than once in a frame adds up
+	row[index] = std::isnan(row[index]) ? seconds : row[index] + seconds;
+}
+
+void ReplayReport::summary(std::ostream& out) const {
+	out << std::format("replayed {} frames\n", m_frames.size());
+	out << std::format("{:<16}{:>8}{:>10}{:>10}{:>10}{:>10}\n", "section (ms)", "frames", "mean", "p50", "p95", "max");
+
+	std::vector<double> times;
+	for (size_t i = 0; i < m_sections.size(); i++) {
+		times.clear();
+		for (auto&& row : m_frames) {
+			if (i < row.size() && !std::isnan(row[i])) times.push_back(row[i] * 1000.0);
+		}
+		if (times.empty()) continue;
+
+		std::sort(times.begin(), times.end());
+		double sum = 0.0;
+		for (double t : times) sum += t;
+
+		auto percentile = [&](double p) { return times[size_t(p * double(times.size() - 1))]; };
+		out << std::format(
+			"{:<16}{:>8}{:>10.3f}{:>10.3f}{:>10.3f}{:>10.3f}\n",
+			m_sections[i], times.size(),
+			sum / double(times.size()), percentile(0.5), percentile(0.95), times.back()
+		);
+	}
+}
+
+bool ReplayReport::writeCSV(const std::string& path) const {
+	std::ofstream out(path, std::ios::trunc);
+	if (!out) return false;
+
+	out << "frame";
+	for (auto&& name : m_sections) out << ',' << name << "_ms";
+	out << '\n';
+
+	for (size_t frame = 0; frame < m_frames.size(); frame++) {
+		auto& row = m_frames[frame];
+		out << frame;
+		for (size_t i = 0; i < m_sections.size(); i++) {
+			out << ',';
+			// sections that didn't run that frame (e.g. a hidden tab) stay empty
+			if (i < row.size() && !std::isnan(row[i])) out << row[i] * 1000.0;
+		}
+		out << '\n';
+	}
+
+	return out.good();
+}
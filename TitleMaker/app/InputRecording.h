@@ -0,0 +1,79 @@
+#pragma once
+
+#define SDL_MAIN_HANDLED
+#include <SDL2/SDL.h>
+
+#include <fstream>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Timebase.h"
+
+// Input session files are plain text, one entry per line:
+//   f <program frame> <width> <height>   a gui frame was drawn, the events since the previous
+//                                        f line were processed right before it
+//   d <button>                           mouse button down (SDL button index)
+//   u <button>                           mouse button up
+//   m <x> <y>                            mouse motion
+//   w <y>                                mouse wheel
+//   k <sym> <scancode> <mod>             key down
+//   r <sym> <scancode> <mod>             key up
+//   t <text>                             text input (utf-8, rest of the line)
+// Only what QuickGUI_Impl::processEvent reads is kept, window events are left out since
+// replay draws every recorded frame anyway.
+
+class InputRecorder {
+public:
+	explicit InputRecorder(const std::string& path);
+
+	bool good() const { return m_out.good(); }
+
+	void event(const SDL_Event& e);
+	void frame(FrameIndex programFrame, int width, int height);
+
+private:
+	std::ofstream m_out;
+};
+
+struct ReplayFrame {
+	FrameIndex programFrame{ 0 };
+	int width{ 0 }, height{ 0 };
+	std::vector<SDL_Event> events;
+};
+
+class InputReplay {
+public:
+	explicit InputReplay(const std::string& path);
+
+	bool good() const { return m_good; }
+
+	// the next recorded gui frame and the events to process before drawing it,
+	// false once the session is over
+	bool next(ReplayFrame& frame);
+
+private:
+	std::ifstream m_in;
+	bool m_good{ false };
+	size_t m_line{ 0 };
+};
+
+// CPU time per replayed frame, split into named sections (nested sections are allowed,
+// each one is reported on its own)
+class ReplayReport {
+public:
+	void beginFrame();
+	void section(std::string_view name, double seconds);
+
+	size_t frames() const { return m_frames.size(); }
+
+	// mean / median / 95th percentile / worst per section, in milliseconds
+	void summary(std::ostream& out) const;
+	// one row per frame, one column per section
+	bool writeCSV(const std::string& path) const;
+
+private:
+	std::vector<std::string> m_sections;
+	std::vector<std::vector<double>> m_frames;
+};
@@ -1,6 +1,15 @@
 #include "NDIOutput.h"
 
-void NDIOutput::start(int width, int height) {
+#include "../../QuickGUI/quickgui/Profiler.h"
+
+NDIOutput::NDIOutput()
+	: m_memory("NDI frame buffers", [this] {
+		return MemoryUsage{ m_frameBuffers[0].capacity() + m_frameBuffers[1].capacity(), 0 };
+	})
+{
+}
+
+void NDIOutput::start(int width, int height, const Timebase& timebase) {
 	if (!NDIlib_initialize()) {
 		return;
 	}
@@ -15,6 +24,8 @@ void NDIOutput::start(int width, int height) {
 	m_frameDesc.yres = height;
 	m_frameDesc.FourCC = NDIlib_FourCC_type_RGBA;
 	m_frameDesc.line_stride_in_bytes = width * 4;
+	m_frameDesc.frame_rate_N = int(timebase.num);
+	m_frameDesc.frame_rate_D = int(timebase.den);
 	
 	m_frameBuffers[0].resize(width * height * 4);
 	m_frameBuffers[1].resize(width * height * 4);
@@ -33,6 +44,7 @@ void NDIOutput::stop() {
 
 void NDIOutput::send(const std::vector<uint8_t>& data) {
 	if (m_newFrameReady) return; // already waiting for a frame to be sent
+	PROFILE_ZONE("NDIOutput::send");
 
 	m_sendLock.lock();
 	::memcpy(m_frameBuffers[m_availableFramebuffer].data(), data.data(), data.size());
@@ -41,6 +53,8 @@ void NDIOutput::send(const std::vector<uint8_t>& data) {
 }
 
 void NDIOutput::mainLoop() {
+	Profiler::setThreadName("NDI");
+
 	while (!m_exitLoop) {
 		if (!NDIlib_send_get_no_connections(m_sender, 10000)) {
 			continue;
@@ -52,6 +66,7 @@ void NDIOutput::mainLoop() {
 		}
 		m_frameDesc.p_data = m_frameBuffers[m_availableFramebuffer].data();
 
+		PROFILE_ZONE("NDIlib_send_send_video_v2");
 		NDIlib_send_send_video_v2(m_sender, &m_frameDesc);
 	}
 	m_isStarted = false;
@@ -7,9 +7,15 @@
 #include <thread>
 #include <mutex>
 
+#include "../../QuickGUI/quickgui/MemoryRegistry.h"
+
+#include "Timebase.h"
+
 class NDIOutput {
 public:
-	void start(int width, int height);
+	NDIOutput();
+
+	void start(int width, int height, const Timebase& timebase);
 	void stop();
 	void send(const std::vector<uint8_t>& data);
 	bool started() const { return m_isStarted; }
@@ -28,4 +34,6 @@ private:
 	void mainLoop();
 	std::mutex m_sendLock;
 	std::thread m_ndiThread;
+
+	MemoryReporter m_memory;
 };
@@ -1,5 +1,7 @@
 #include "RenderTarget.h"
 
+#include "../../QuickGUI/quickgui/Profiler.h"
+
 RenderTarget::RenderTarget(int width, int height) {
 	glGenTextures(1, &m_textureId);
 	glBindTexture(GL_TEXTURE_2D, m_textureId);
@@ -9,9 +11,16 @@ RenderTarget::RenderTarget(int width, int height) {
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
 	glBindTexture(GL_TEXTURE_2D, 0);
 
+	// nanovg fills concave paths and strokes through the stencil buffer
+	glGenRenderbuffers(1, &m_stencil);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_stencil);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
 	glGenFramebuffers(1, &m_fbo);
 	glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
 	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_textureId, 0);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_stencil);
 	glDrawBuffer(GL_COLOR_ATTACHMENT0);
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
@@ -24,17 +33,34 @@ RenderTarget::RenderTarget(int width, int height) {
 	m_height = height;
 }
 
+MemoryUsage RenderTarget::memoryUsage() const {
+	if (m_textureId == 0) return {};
+
+	size_t frameBytes = size_t(m_width) * size_t(m_height) * 4;
+	return MemoryUsage{ m_pixels.capacity(), frameBytes * 3 };
+}
+
 void RenderTarget::bind() {
 	glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
 }
 
 void RenderTarget::dispose() {
 	glDeleteTextures(1, &m_textureId);
+	glDeleteRenderbuffers(1, &m_stencil);
 	glDeleteFramebuffers(1, &m_fbo);
 	glDeleteBuffers(1, &m_pbo);
 }
 
+void RenderTarget::upload(const std::vector<uint8_t>& pixels) {
+	PROFILE_ZONE("RenderTarget::upload");
+	glBindTexture(GL_TEXTURE_2D, m_textureId);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
 const std::vector<uint8_t>& RenderTarget::readImage() {
+	PROFILE_ZONE("RenderTarget::readImage");
 	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_fbo);
 	glReadBuffer(GL_COLOR_ATTACHMENT0);
 
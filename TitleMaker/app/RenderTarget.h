@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../../QuickGUI/glad/glad.h"
+#include "../../QuickGUI/quickgui/MemoryRegistry.h"
 
 #include <vector>
 #include <cstdint>
@@ -14,13 +15,18 @@ public:
 	void dispose();
 
 	const std::vector<uint8_t>& readImage();
+	// replaces the texture with pixels drawn on the cpu, in readImage's layout
+	void upload(const std::vector<uint8_t>& pixels);
 
 	GLuint textureId() const { return m_textureId; }
 	int width() const { return m_width; }
 	int height() const { return m_height; }
 
+	// the texture, stencil and pack buffer on the gpu, the read back pixels on the cpu
+	MemoryUsage memoryUsage() const;
+
 private:
 	std::vector<uint8_t> m_pixels;
-	GLuint m_fbo{ 0 }, m_pbo{ 0 }, m_textureId{0};
+	GLuint m_fbo{ 0 }, m_pbo{ 0 }, m_textureId{0}, m_stencil{ 0 };
 	int m_width, m_height;
 };
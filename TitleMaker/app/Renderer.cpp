@@ -1,41 +1,209 @@
 #include "Renderer.h"
 
 #include "../../QuickGUI/glad/glad.h"
+#include "../../QuickGUI/quickgui/Profiler.h"
+#define NANOVG_RECORD_IMPLEMENTATION
+#include "../../QuickGUI/nanovg/nanovg_record.h"
+#define NANOVG_SW_IMPLEMENTATION
+#include "../../QuickGUI/nanovg/nanovg_sw.h"
 
-void Renderer::setup(NVGcontext* ctx, int width, int height) {
+#include <algorithm>
+
+// below this many shapes handing them to the pool costs more than it saves
+constexpr size_t minParallelShapes = 64;
+// a recorded segment holds at least this many shapes, each one costs a replay
+constexpr size_t minSegmentShapes = 16;
+// segments per thread, so one slow segment doesn't keep everybody waiting
+constexpr size_t segmentsPerThread = 4;
+constexpr size_t maxWorkers = 7;
+
+// the software rasterizer's bands go to the same pool as the tessellation, which is idle by then
+static void parallelBands(void* user, int count, void (*job)(void* data, int index), void* data) {
+	static_cast<WorkerPool*>(user)->parallelFor(size_t(count), [&](size_t i) { job(data, int(i)); });
+}
+
+Renderer::~Renderer() {
+	// the pool goes first, nothing may still be recording
+	m_workers.reset();
+	for (auto&& recorder : m_recorders) nvgDeleteRecorder(recorder);
+	if (m_softwareContext) nvgDeleteSW(m_softwareContext);
+}
+
+void Renderer::setup(NVGcontext* ctx, int width, int height, bool software) {
 	m_context = ctx;
 	m_target = RenderTarget(width, height);
+
+	m_targetMemory = MemoryReporter("program render target", [this] { return m_target.memoryUsage(); });
+	m_lastFrameMemory = MemoryReporter("program last frame", [this] {
+		return MemoryUsage{ m_lastFrameData.capacity(), 0 };
+	});
+
+	// the ui thread takes part in every parallelFor, it counts as one of the cores
+	if (!m_workers) {
+		size_t cores = std::thread::hardware_concurrency();
+		m_workers = std::make_unique<WorkerPool>(std::min(cores > 1 ? cores - 1 : 0, maxWorkers), "Tessellation");
+	}
+
+	if (software && !m_softwareContext) {
+		m_softwareContext = nvgCreateSW(NVGSW_ANTIALIAS | NVGSW_STENCIL_STROKES);
+		if (m_softwareContext) {
+			// the ui's fonts in the ui's order, text without a font of its own falls back to "normal"
+			QuickGUI::loadFonts(m_softwareContext);
+			nvgswSetParallel(m_softwareContext, parallelBands, m_workers.get());
+		}
+	}
+	m_software = software && m_softwareContext;
+	if (m_software) m_context = m_softwareContext;
+
+	m_recorderMemory = MemoryReporter("program tessellation", [this] {
+		MemoryUsage usage;
+		for (auto&& recorder : m_recorders) usage.cpu += nvgMemoryUsage(recorder) + nvgrMemoryUsage(recorder);
+		usage.cpu += m_segments.capacity() * sizeof(Segment) + m_recordedSegments.capacity() * sizeof(size_t);
+		return usage;
+	});
+	if (m_software) {
+		m_softwareMemory = MemoryReporter("program software raster", [this] {
+			return MemoryUsage{ nvgMemoryUsage(m_softwareContext) + nvgswMemoryUsage(m_softwareContext), 0 };
+		});
+	}
 }
 
-void Renderer::render(const ShapeList& shapes, float deltaTime) {
-	m_target.bind();
+void Renderer::render(const ShapeList& shapes, FrameIndex frame, const Timebase& timebase) {
+	PROFILE_ZONE("Renderer::render");
+	if (m_software) {
+		renderSoftware(shapes, frame, timebase);
+		return;
+	}
 
-	GLint vp[4];
-	glGetIntegerv(GL_VIEWPORT, vp);
-	glViewport(0, 0, m_target.width(), m_target.height());
+	{
+		PROFILE_GPU_ZONE("Renderer::render");
 
-	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-	glClear(GL_COLOR_BUFFER_BIT);
+		m_target.bind();
 
-	nvgBeginFrame(m_context, m_target.width(), m_target.height(), float(m_target.width()) / float(m_target.height()));
-	nvgSave(m_context);
-	nvgTranslate(m_context, 0.0f, m_target.height());
-	nvgScale(m_context, 1.0f, -1.0f);
-	nvgScissor(m_context, 0, 0, m_target.width(), m_target.height());
+		GLint vp[4];
+		glGetIntegerv(GL_VIEWPORT, vp);
+		glViewport(0, 0, m_target.width(), m_target.height());
+
+		glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+		drawFrame(shapes, frame, timebase);
+
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+		glViewport(vp[0], vp[1], vp[2], vp[3]);
+	}
+
+	// the read back waits for the gpu, keep it out of the gpu zone
+	m_lastFrameData = m_target.readImage();
+}
+
+void Renderer::renderSoftware(const ShapeList& shapes, FrameIndex frame, const Timebase& timebase) {
+	// the frame is drawn straight into the last frame, cleared like the gpu target
+	m_lastFrameData.assign(size_t(m_target.width()) * size_t(m_target.height()) * 4, 0);
+	nvgswSetTarget(m_context, m_lastFrameData.data(), m_target.width(), m_target.height(), m_target.width() * 4);
+
+	drawFrame(shapes, frame, timebase);
 
-	for (auto&& shape : shapes) {
-		//shape->draw(m_context);
-		nvgSave(m_context);
-		shape->drawAnimated(m_context, deltaTime);
-		nvgRestore(m_context);
+	// uploaded for the preview only when it's shown, outputs and --benchmark read the pixels directly
+	m_previewStale = true;
+}
+
+GLuint Renderer::previewTexture() {
+	if (m_previewStale) {
+		m_target.upload(m_lastFrameData);
+		m_previewStale = false;
 	}
+	return m_target.textureId();
+}
+
+void Renderer::drawFrame(const ShapeList& shapes, FrameIndex frame, const Timebase& timebase) {
+	nvgBeginFrame(m_context, m_target.width(), m_target.height(), float(m_target.width()) / float(m_target.height()));
+	beginContent(m_context);
+
+	if (shapes.size() >= minParallelShapes && m_workers->threadCount() > 0) drawParallel(shapes, frame, timebase);
+	else drawShapes(m_context, shapes, 0, shapes.size(), frame, timebase);
 
 	nvgRestore(m_context);
 	nvgEndFrame(m_context);
+}
 
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+void Renderer::beginContent(NVGcontext* ctx) {
+	nvgSave(ctx);
+	// gl reads the target back bottom row first, the software target is written top row first
+	if (!m_software) {
+		nvgTranslate(ctx, 0.0f, m_target.height());
+		nvgScale(ctx, 1.0f, -1.0f);
+	}
+	nvgScissor(ctx, 0, 0, m_target.width(), m_target.height());
+}
+
+void Renderer::drawShapes(NVGcontext* ctx, const ShapeList& shapes, size_t begin, size_t end, FrameIndex frame, const Timebase& timebase) {
+	for (size_t i = begin; i < end; i++) {
+		nvgSave(ctx);
+		shapes[i]->drawAnimated(ctx, frame, timebase);
+		nvgRestore(ctx);
+	}
+}
 
-	glViewport(vp[0], vp[1], vp[2], vp[3]);
+void Renderer::drawParallel(const ShapeList& shapes, FrameIndex frame, const Timebase& timebase) {
+	planSegments(shapes);
 
-	m_lastFrameData = m_target.readImage();
+	// recorders tessellate with the same antialiasing as the context they are replayed into
+	int edgeAntiAlias = nvgInternalParams(m_context)->edgeAntiAlias;
+	while (m_recorders.size() < m_recordedSegments.size()) {
+		NVGcontext* recorder = nvgCreateRecorder(edgeAntiAlias);
+		if (!recorder) {
+			drawShapes(m_context, shapes, 0, shapes.size(), frame, timebase);
+			return;
+		}
+		m_recorders.push_back(recorder);
+	}
+
+	// shapes only touch their own state while drawing, segments never share one
+	m_workers->parallelFor(m_recordedSegments.size(), [&](size_t job) {
+		PROFILE_ZONE("Renderer::tessellate");
+		const Segment& segment = m_segments[m_recordedSegments[job]];
+		NVGcontext* recorder = m_recorders[size_t(segment.recorder)];
+
+		nvgBeginFrame(recorder, m_target.width(), m_target.height(), float(m_target.width()) / float(m_target.height()));
+		beginContent(recorder);
+		drawShapes(recorder, shapes, segment.begin, segment.end, frame, timebase);
+		nvgRestore(recorder);
+		nvgEndFrame(recorder);
+	});
+
+	// back in shape order, text is drawn here since it needs the fonts of m_context
+	PROFILE_ZONE("Renderer::replay");
+	for (auto&& segment : m_segments) {
+		if (segment.recorder >= 0) nvgrReplay(m_recorders[size_t(segment.recorder)], m_context);
+		else drawShapes(m_context, shapes, segment.begin, segment.end, frame, timebase);
+	}
+}
+
+void Renderer::planSegments(const ShapeList& shapes) {
+	m_segments.clear();
+	m_recordedSegments.clear();
+
+	size_t perSegment = std::max(minSegmentShapes, shapes.size() / ((m_workers->threadCount() + 1) * segmentsPerThread) + 1);
+
+	size_t begin = 0;
+	auto record = [&](size_t end) {
+		while (begin < end) {
+			size_t segmentEnd = std::min(end, begin + perSegment);
+			m_recordedSegments.push_back(m_segments.size());
+			m_segments.push_back({ begin, segmentEnd, int(m_recordedSegments.size() - 1) });
+			begin = segmentEnd;
+		}
+	};
+
+	for (size_t i = 0; i < shapes.size(); i++) {
+		if (shapes[i]->recordable()) continue;
+
+		record(i);
+		if (!m_segments.empty() && m_segments.back().recorder < 0) m_segments.back().end = i + 1;
+		else m_segments.push_back({ i, i + 1, -1 });
+		begin = i + 1;
+	}
+	record(shapes.size());
 }
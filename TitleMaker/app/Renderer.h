@@ -3,20 +3,56 @@
 #include "../../QuickGUI/glad/glad.h"
 #include "../../QuickGUI/nanovg/nanovg.h"
 
+#include <memory>
+
 #include "RenderTarget.h"
 #include "Shape.h"
+#include "WorkerPool.h"
 
 class Renderer {
 public:
-	void setup(NVGcontext* ctx, int width, int height);
-	void render(const ShapeList& shapes, float deltaTime);
+	~Renderer();
+
+	// with `software` the program is rasterized on the cpu by a context of its own, ctx is only
+	// used on the gpu path. The target is created either way and needs a current gl context, its
+	// texture backs the preview.
+	void setup(NVGcontext* ctx, int width, int height, bool software = false);
+	void render(const ShapeList& shapes, FrameIndex frame, const Timebase& timebase);
 
+	// the context the program is drawn with, the software one in software mode
+	NVGcontext* context() const { return m_context; }
 	RenderTarget& target() { return m_target; }
+	// the target's texture, holding the last frame in software mode too
+	GLuint previewTexture();
 	const std::vector<uint8_t>& lastFrameData() const { return m_lastFrameData; }
+	bool software() const { return m_software; }
 
 private:
+	// a run of shapes that is either tessellated on the pool into `recorder`, or drawn directly (-1)
+	struct Segment {
+		size_t begin, end;
+		int recorder;
+	};
+
+	void renderSoftware(const ShapeList& shapes, FrameIndex frame, const Timebase& timebase);
+	void drawFrame(const ShapeList& shapes, FrameIndex frame, const Timebase& timebase);
+	void beginContent(NVGcontext* ctx);
+	void drawShapes(NVGcontext* ctx, const ShapeList& shapes, size_t begin, size_t end, FrameIndex frame, const Timebase& timebase);
+	void drawParallel(const ShapeList& shapes, FrameIndex frame, const Timebase& timebase);
+	void planSegments(const ShapeList& shapes);
+
 	NVGcontext* m_context;
 	RenderTarget m_target;
+	bool m_software{ false };
+	NVGcontext* m_softwareContext{ nullptr };
+	bool m_previewStale{ false }; // the software frame isn't in the target's texture yet
 
 	std::vector<uint8_t> m_lastFrameData;
+
+	std::unique_ptr<WorkerPool> m_workers;
+	std::vector<NVGcontext*> m_recorders;
+	std::vector<Segment> m_segments;
+	std::vector<size_t> m_recordedSegments;
+
+	MemoryReporter m_targetMemory, m_lastFrameMemory, m_recorderMemory, m_softwareMemory;
 };
@@ -0,0 +1,61 @@
+#include "Scenes.h"
+
+static const char* loremIpsum =
+	"Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor "
+	"incididunt ut labore et dolore magna aliqua. Ut enim ad minim veniam, quis nostrud "
+	"exercitation ullamco laboris nisi ut aliquip ex ea commodo consequat.";
+
+namespace scenes {
+	ShapeList rectangles(size_t count) {
+		Generator gen;
+		ShapeList shapes;
+		for (size_t i = 0; i < count; i++) shapes.push_back(gen.shape<Rectangle>());
+		return shapes;
+	}
+
+	ShapeList roundedBordered(size_t count) {
+		Generator gen;
+		ShapeList shapes;
+		for (size_t i = 0; i < count; i++) {
+			auto rect = gen.shape<Rectangle>();
+			rect->borderRadius = gen.uniform(4.0f, 30.0f);
+			rect->borderWidth = gen.uniform(1.0f, 6.0f);
+			rect->borderColor = gen.color();
+			shapes.push_back(std::move(rect));
+		}
+		return shapes;
+	}
+
+	ShapeList gradients(size_t count) {
+		Generator gen;
+		ShapeList shapes;
+		for (size_t i = 0; i < count; i++) {
+			auto rect = gen.shape<Rectangle>();
+			rect->fillMode = ColoredShape::Gradient;
+			rect->background.stops[0] = Point{ 0.0f, 0.0f };
+			rect->background.stops[1] = Point{ 1.0f, 1.0f };
+			shapes.push_back(std::move(rect));
+		}
+		return shapes;
+	}
+
+	ShapeList ellipses(size_t count) {
+		Generator gen;
+		ShapeList shapes;
+		for (size_t i = 0; i < count; i++) shapes.push_back(gen.shape<Ellipse>());
+		return shapes;
+	}
+
+	ShapeList paragraphs(size_t count) {
+		Generator gen;
+		ShapeList shapes;
+		for (size_t i = 0; i < count; i++) {
+			auto txt = gen.shape<Text>(200.0f, 400.0f);
+			txt->text = loremIpsum; // wraps over several lines at these widths
+			txt->font = "normal"; // loaded by QuickGUI
+			txt->fontSize = gen.uniform(14.0f, 32.0f);
+			shapes.push_back(std::move(txt));
+		}
+		return shapes;
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <random>
+
+#include "Shape.h"
+
+// Synthetic programs for --benchmark and --golden. The seed is fixed, so every run (and every
+// version) draws the same scenes.
+namespace scenes {
+	constexpr int width = 1920, height = 1080;
+
+	class Generator {
+	public:
+		// mapped by hand, the standard distributions differ between libraries and the goldens must not
+		float uniform(float min, float max) { return float(m_rng() >> 8) * 0x1p-24f * (max - min) + min; }
+
+		Rect rect(float minSize, float maxSize) {
+			float w = uniform(minSize, maxSize), h = uniform(minSize, maxSize);
+			// arguments are evaluated in no fixed order, the draws are sequenced first
+			float x = uniform(0.0f, width - w), y = uniform(0.0f, height - h);
+			return Rect(x, y, w, h);
+		}
+
+		Color color() { return Color{ uniform(0.0f, 1.0f), uniform(0.0f, 1.0f), uniform(0.0f, 1.0f), 1.0f }; }
+
+		template <typename T>
+		std::unique_ptr<T> shape(float minSize = 20.0f, float maxSize = 200.0f) {
+			auto s = std::make_unique<T>();
+			s->bounds = rect(minSize, maxSize);
+			s->background.color[0] = color();
+			s->background.color[1] = color();
+			return s;
+		}
+
+	private:
+		std::mt19937 m_rng{ 1234 };
+	};
+
+	ShapeList rectangles(size_t count);
+	ShapeList roundedBordered(size_t count);
+	ShapeList gradients(size_t count);
+	ShapeList ellipses(size_t count);
+	ShapeList paragraphs(size_t count);
+
+	// rectangles with an enter animation each, already triggered
+	template <typename Anim, typename Setup>
+	ShapeList animated(size_t count, Setup setup) {
+		ShapeList shapes = rectangles(count);
+		for (size_t i = 0; i < shapes.size(); i++) {
+			auto anim = std::make_unique<Anim>();
+			setup(*anim, i);
+			shapes[i]->animations[size_t(ShapeAnimation::Enter)] = std::move(anim);
+			shapes[i]->triggerEnter();
+		}
+		return shapes;
+	}
+}
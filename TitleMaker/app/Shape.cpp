@@ -1,7 +1,9 @@
 #include "Shape.h"
 
 #include "../../QuickGUI/quickgui/Icons.h"
+#include "../../QuickGUI/quickgui/Profiler.h"
 #include "portable-file-dialogs.h"
+#include <cstdio>
 #include <filesystem>
 
 void Rectangle::draw(NVGcontext* ctx) {
@@ -124,7 +126,8 @@ void Shape::draw(NVGcontext* ctx) {
 	xformDraw.toNanoVG(ctx);
 }
 
-void Shape::drawAnimated(NVGcontext* ctx, float deltaTime) {
+void Shape::drawAnimated(NVGcontext* ctx, FrameIndex frame, const Timebase& timebase) {
+	PROFILE_ZONE("Shape::drawAnimated");
 	Animation* anim = nullptr;
 	switch (m_state) {
 		case Entering: anim = animations[size_t(ShapeAnimation::Enter)].get(); break;
@@ -135,19 +138,19 @@ void Shape::drawAnimated(NVGcontext* ctx, float deltaTime) {
 	if (anim) {
 		nvgSave(ctx);
 
-		anim->update(ctx, m_globalTime, m_state == Entering);
-		m_globalTime += deltaTime;
+		FrameIndex local = frame - m_startFrame;
+		anim->update(ctx, local, timebase, m_state == Entering);
 
-		if (anim->finished()) {
-			anim->reset();
+		if (anim->finished(local, timebase)) {
+			anim->onFinish();
 			m_state = Idling;
 			m_nextState = Idling;
-			triggerAnim();
+			triggerAnim(frame);
 		}
 	}
 	else {
 		m_state = m_nextState;
-		triggerAnim();
+		triggerAnim(frame);
 	}
 
 	draw(ctx);
@@ -177,8 +180,18 @@ Rect Shape::rectSpaceBounds() const {
 	);
 }
 
-void Shape::triggerAnim() {
-	m_globalTime = 0.0f;
+bool Shape::animating() const {
+	if (m_nextState != m_state) return true;
+
+	switch (m_state) {
+		case Entering: return animations[size_t(ShapeAnimation::Enter)] != nullptr;
+		case Exiting: return animations[size_t(ShapeAnimation::Exit)] != nullptr;
+		default: return false;
+	}
+}
+
+void Shape::triggerAnim(FrameIndex frame) {
+	m_startFrame = frame;
 
 	Animation* anim = nullptr;
 	switch (m_state) {
@@ -195,9 +208,16 @@ void Shape::triggerAnim() {
 void Text::draw(NVGcontext* ctx) {
 	Shape::draw(ctx);
 
-	if (!m_fontFileName.empty() || nvgFindFont(ctx, font.c_str()) == -1) {
-		m_fontHandle = nvgCreateFont(ctx, font.c_str(), m_fontFileName.c_str());
-		m_fontFileName = "";
+	// handles belong to one context and the program may be drawn by a software one, so the
+	// font is looked up by name and loaded from its file into whichever context lacks it
+	m_fontHandle = nvgFindFont(ctx, font.c_str());
+	if (m_fontHandle == -1 && !m_fontPath.empty()) {
+		m_fontHandle = nvgCreateFont(ctx, font.c_str(), m_fontPath.c_str());
+		// a file that didn't load won't load next frame either, drawn with the default font until another is picked
+		if (m_fontHandle == -1) {
+			fprintf(stderr, "can't load font %s\n", m_fontPath.c_str());
+			m_fontPath.clear();
+		}
 	}
 
 	if (m_fontHandle > 0) nvgFontFaceId(ctx, m_fontHandle);
@@ -223,7 +243,7 @@ void Text::gui(QuickGUI* gui) {
 
 	gui->layoutCutTop(5);
 
-	std::string btnFontText = m_fontHandle <= 0 ? "Select Font" : font;
+	std::string_view btnFontText = m_fontHandle <= 0 ? std::string_view("Select Font") : std::string_view(font);
 	if (gui->button("btn_font_file", btnFontText, gui->layoutCutTop(26), IC_DOCUMENT_TEXT)) {
 		auto fp = pfd::open_file(
 			"Select Font", pfd::path::home(),
@@ -232,8 +252,13 @@ void Text::gui(QuickGUI* gui) {
 		);
 
 		if (!fp.result().empty()) {
-			m_fontFileName = fp.result()[0];
-			font = std::filesystem::path(m_fontFileName).stem().generic_string();
+			m_fontPath = fp.result()[0];
+			font = std::filesystem::path(m_fontPath).stem().generic_string();
 		}
 	}
 }
+
+// same icons as the side toolbar buttons that create them
+size_t Rectangle::icon() const { return IC_RECTANGLE; }
+size_t Ellipse::icon() const { return IC_RECORD; }
+size_t Text::icon() const { return IC_LIST; }
@@ -21,10 +21,22 @@ public:
 	virtual void draw(NVGcontext* ctx);
 	virtual void gui(QuickGUI* gui) {}
 
-	void drawAnimated(NVGcontext* ctx, float deltaTime);
+	// how the shape is listed in the layers panel
+	virtual std::string_view label() const { return "Shape"; }
+	virtual size_t icon() const { return 0; }
+
+	// false when draw() needs the context it ends up on (fonts), the renderer then keeps the
+	// shape off its tessellation threads
+	virtual bool recordable() const { return true; }
+
+	// draws the shape as it looks at `frame`, starting any pending enter/exit animation there
+	void drawAnimated(NVGcontext* ctx, FrameIndex frame, const Timebase& timebase);
 	void triggerEnter();
 	void triggerExit();
 
+	// true while an enter/exit animation runs or is about to start
+	bool animating() const;
+
 	Rect bounds{};
 	float rotation{ 0.0f };
 
@@ -42,9 +54,10 @@ private:
 	_State m_state{ Idling };
 	_State m_nextState{ Idling };
 
-	float m_globalTime{ 0.0f };
+	// frame the running animation started at
+	FrameIndex m_startFrame{ 0 };
 
-	void triggerAnim();
+	void triggerAnim(FrameIndex frame);
 };
 using ShapeList = std::vector<std::unique_ptr<Shape>>;
 
@@ -70,6 +83,8 @@ public:
 class Rectangle : public ColoredShape {
 public:
 	void draw(NVGcontext* ctx);
+	std::string_view label() const { return "Rectangle"; }
+	size_t icon() const;
 
 	float borderRadius{ 0.0f };
 };
@@ -77,18 +92,23 @@ public:
 class Ellipse : public ColoredShape {
 public:
 	void draw(NVGcontext* ctx);
+	std::string_view label() const { return "Ellipse"; }
+	size_t icon() const;
 };
 
 class Text : public ColoredShape {
 public:
 	void draw(NVGcontext* ctx);
 	void gui(QuickGUI* gui);
+	std::string_view label() const { return text.empty() ? "Text" : std::string_view(text); }
+	size_t icon() const;
+	bool recordable() const { return false; }
 
 	float fontSize{ 44.0f };
 	std::string text{ "Text" };
 	std::string font{ "" };
 
 private:
-	std::string m_fontFileName;
-	int m_fontHandle{ -1 };
+	std::string m_fontPath;
+	int m_fontHandle{ -1 }; // in the context drawn last
 };
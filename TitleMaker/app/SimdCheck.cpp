@@ -0,0 +1,64 @@
+#include "SimdCheck.h"
+#include "Scenes.h"
+
+#include "../../QuickGUI/nanovg/nanovg_record.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+const char* simdLevelName(int level) {
+	static const char* names[] = { "scalar", "sse2", "avx2" };
+	return names[level];
+}
+
+void recordShapes(NVGcontext* recorder, const ShapeList& shapes) {
+	nvgBeginFrame(recorder, scenes::width, scenes::height, 1.0f);
+	for (auto&& shape : shapes) {
+		nvgSave(recorder);
+		shape->draw(recorder);
+		nvgRestore(recorder);
+	}
+	nvgEndFrame(recorder);
+}
+
+double vertexError(const std::vector<NVGvertex>& reference, const NVGvertex* verts, size_t count) {
+	if (reference.size() != count) return std::numeric_limits<double>::infinity();
+
+	double maxError = 0.0;
+	for (size_t i = 0; i < count; i++) {
+		auto& a = reference[i];
+		auto& b = verts[i];
+		for (float d : { a.x - b.x, a.y - b.y, a.u - b.u, a.v - b.v, a.s - b.s, a.t - b.t }) {
+			maxError = std::max(maxError, double(std::abs(d)));
+		}
+	}
+	return maxError;
+}
+
+std::vector<SimdLevelResult> checkSimdLevels(const ShapeList& shapes, int edgeAntiAlias) {
+	std::vector<SimdLevelResult> results;
+	NVGcontext* recorder = nvgCreateRecorder(edgeAntiAlias);
+	if (!recorder) return results;
+
+	int previous = nvgSimdLevel();
+	std::vector<NVGvertex> reference;
+
+	for (int level = NVG_SIMD_SCALAR; level <= nvgSimdSupported(); level++) {
+		nvgSetSimdLevel(level);
+		recordShapes(recorder, shapes);
+
+		int count = 0;
+		const NVGvertex* verts = nvgrVertices(recorder, &count);
+		if (level == NVG_SIMD_SCALAR) reference.assign(verts, verts + count);
+
+		SimdLevelResult result{ simdLevelName(level) };
+		result.vertices = size_t(count);
+		result.maxError = vertexError(reference, verts, size_t(count));
+		results.push_back(result);
+	}
+
+	nvgSetSimdLevel(previous);
+	nvgDeleteRecorder(recorder);
+	return results;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "../../QuickGUI/nanovg/nanovg.h"
+
+#include "Shape.h"
+
+// Checks that every instruction set nanovg's tessellation can use here (see nvgSetSimdLevel)
+// produces the vertices of the scalar path. Shared by --benchmark and --golden.
+
+// the levels are meant to match exactly, this leaves room for nothing visible
+constexpr double maxSimdError = 1e-4;
+
+struct SimdLevelResult {
+	const char* name;
+	size_t vertices{ 0 };
+	double maxError{ 0.0 }; // largest difference to the scalar vertices, infinity if the counts differ
+
+	bool passed() const { return maxError <= maxSimdError; }
+};
+
+const char* simdLevelName(int level);
+
+// tessellates `shapes` into `recorder` at the current level, text needs a real context and is left out
+void recordShapes(NVGcontext* recorder, const ShapeList& shapes);
+
+// infinity if the counts differ, a vertex list of another length can't be compared vertex by vertex
+double vertexError(const std::vector<NVGvertex>& reference, const NVGvertex* verts, size_t count);
+
+// records `shapes` at every supported level, scalar first, the level in use is restored after
+std::vector<SimdLevelResult> checkSimdLevels(const ShapeList& shapes, int edgeAntiAlias);
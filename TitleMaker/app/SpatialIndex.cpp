@@ -0,0 +1,227 @@
+#include "SpatialIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+// shapes spanning more cells than this are kept in a separate list that is always tested
+constexpr int maxCellsPerShape = 256;
+
+void SpatialIndex::update(const ShapeList& shapes) {
+	m_stamp++;
+
+	for (size_t i = 0; i < shapes.size(); i++) {
+		Shape* shape = shapes[i].get();
+
+		auto pos = m_lookup.find(shape);
+		if (pos == m_lookup.end()) {
+			uint32_t index;
+			if (!m_freeEntries.empty()) {
+				index = m_freeEntries.back();
+				m_freeEntries.pop_back();
+			}
+			else {
+				index = uint32_t(m_entries.size());
+				m_entries.push_back(Entry());
+			}
+
+			Entry& entry = m_entries[index];
+			entry = Entry();
+			entry.shape = shape;
+			entry.order = i;
+			entry.stamp = m_stamp;
+			m_lookup[shape] = index;
+
+			refresh(index);
+			insert(index);
+			continue;
+		}
+
+		Entry& entry = m_entries[pos->second];
+		entry.order = i;
+		entry.stamp = m_stamp;
+
+		const Rect& b = shape->bounds;
+		if (
+			b.x != entry.bounds.x || b.y != entry.bounds.y ||
+			b.width != entry.bounds.width || b.height != entry.bounds.height ||
+			shape->rotation != entry.rotation
+		) {
+			remove(pos->second);
+			refresh(pos->second);
+			insert(pos->second);
+		}
+	}
+
+	if (m_lookup.size() == shapes.size()) return;
+
+	// some shapes are gone, drop the entries that weren't visited
+	for (auto it = m_lookup.begin(); it != m_lookup.end();) {
+		Entry& entry = m_entries[it->second];
+		if (entry.stamp == m_stamp) {
+			++it;
+			continue;
+		}
+
+		remove(it->second);
+		entry.shape = nullptr;
+		m_freeEntries.push_back(it->second);
+		it = m_lookup.erase(it);
+	}
+}
+
+void SpatialIndex::clear() {
+	m_entries.clear();
+	m_freeEntries.clear();
+	m_oversized.clear();
+	m_lookup.clear();
+	m_cells.clear();
+}
+
+Shape* SpatialIndex::pick(Point p, float tolerance) const {
+	const Entry* best = nullptr;
+
+	auto test = [&](uint32_t index) {
+		const Entry& entry = m_entries[index];
+		if (best && best->order >= entry.order) return;
+		if (containsPoint(*entry.shape, p, tolerance)) {
+			best = &entry;
+		}
+	};
+
+	auto pos = m_cells.find(cellKey(cellCoord(p.x), cellCoord(p.y)));
+	if (pos != m_cells.end()) {
+		for (uint32_t index : pos->second) test(index);
+	}
+
+	// the tolerance can push the hit area over a cell border
+	if (tolerance > 0.0f) {
+		int cx0 = cellCoord(p.x - tolerance), cx1 = cellCoord(p.x + tolerance);
+		int cy0 = cellCoord(p.y - tolerance), cy1 = cellCoord(p.y + tolerance);
+		for (int cy = cy0; cy <= cy1; cy++) {
+			for (int cx = cx0; cx <= cx1; cx++) {
+				if (cx == cellCoord(p.x) && cy == cellCoord(p.y)) continue;
+
+				auto npos = m_cells.find(cellKey(cx, cy));
+				if (npos == m_cells.end()) continue;
+				for (uint32_t index : npos->second) test(index);
+			}
+		}
+	}
+
+	for (uint32_t index : m_oversized) test(index);
+
+	return best ? best->shape : nullptr;
+}
+
+static bool overlaps(Rect a, Rect b) {
+	return a.x <= b.x + b.width && b.x <= a.x + a.width &&
+		a.y <= b.y + b.height && b.y <= a.y + a.height;
+}
+
+void SpatialIndex::query(Rect area, std::vector<Shape*>& out) const {
+	std::vector<const Entry*> found;
+
+	auto test = [&](uint32_t index) {
+		const Entry& entry = m_entries[index];
+		if (overlaps(entry.aabb, area)) found.push_back(&entry);
+	};
+
+	int cx0 = cellCoord(area.x), cx1 = cellCoord(area.x + area.width);
+	int cy0 = cellCoord(area.y), cy1 = cellCoord(area.y + area.height);
+	for (int cy = cy0; cy <= cy1; cy++) {
+		for (int cx = cx0; cx <= cx1; cx++) {
+			auto pos = m_cells.find(cellKey(cx, cy));
+			if (pos == m_cells.end()) continue;
+			for (uint32_t index : pos->second) test(index);
+		}
+	}
+	for (uint32_t index : m_oversized) test(index);
+
+	// shapes spanning several cells show up once per cell
+	std::sort(found.begin(), found.end(), [](const Entry* a, const Entry* b) { return a->order < b->order; });
+	found.erase(std::unique(found.begin(), found.end()), found.end());
+
+	for (auto entry : found) {
+		out.push_back(entry->shape);
+	}
+}
+
+int64_t SpatialIndex::order(const Shape* shape) const {
+	auto pos = m_lookup.find(shape);
+	if (pos == m_lookup.end()) return -1;
+	return int64_t(m_entries[pos->second].order);
+}
+
+bool SpatialIndex::containsPoint(const Shape& shape, Point p, float tolerance) {
+	// shapes are drawn centered on their location and rotated around it (see Shape::draw)
+	Point local = (p - shape.bounds.location()).rotated(-nvgDegToRad(shape.rotation));
+	float hw = shape.bounds.width * 0.5f + tolerance;
+	float hh = shape.bounds.height * 0.5f + tolerance;
+	return local.x >= -hw && local.x <= hw && local.y >= -hh && local.y <= hh;
+}
+
+Rect SpatialIndex::rotatedBounds(const Shape& shape) {
+	float angle = nvgDegToRad(shape.rotation);
+	float c = ::fabsf(::cosf(angle)), s = ::fabsf(::sinf(angle));
+	float hw = shape.bounds.width * 0.5f, hh = shape.bounds.height * 0.5f;
+	float ex = c * hw + s * hh;
+	float ey = s * hw + c * hh;
+	return Rect(shape.bounds.x - ex, shape.bounds.y - ey, ex * 2.0f, ey * 2.0f);
+}
+
+int SpatialIndex::cellCoord(float v) const {
+	return int(::floorf(v / m_cellSize));
+}
+
+void SpatialIndex::refresh(uint32_t index) {
+	Entry& entry = m_entries[index];
+	entry.bounds = entry.shape->bounds;
+	entry.rotation = entry.shape->rotation;
+	entry.aabb = rotatedBounds(*entry.shape);
+	entry.cx0 = cellCoord(entry.aabb.x);
+	entry.cy0 = cellCoord(entry.aabb.y);
+	entry.cx1 = cellCoord(entry.aabb.x + entry.aabb.width);
+	entry.cy1 = cellCoord(entry.aabb.y + entry.aabb.height);
+
+	int64_t cells = int64_t(entry.cx1 - entry.cx0 + 1) * int64_t(entry.cy1 - entry.cy0 + 1);
+	entry.oversized = cells > maxCellsPerShape;
+}
+
+void SpatialIndex::insert(uint32_t index) {
+	const Entry& entry = m_entries[index];
+	if (entry.oversized) {
+		m_oversized.push_back(index);
+		return;
+	}
+
+	for (int cy = entry.cy0; cy <= entry.cy1; cy++) {
+		for (int cx = entry.cx0; cx <= entry.cx1; cx++) {
+			m_cells[cellKey(cx, cy)].push_back(index);
+		}
+	}
+}
+
+static void eraseIndex(std::vector<uint32_t>& list, uint32_t index) {
+	auto pos = std::find(list.begin(), list.end(), index);
+	if (pos == list.end()) return;
+	*pos = list.back();
+	list.pop_back();
+}
+
+void SpatialIndex::remove(uint32_t index) {
+	const Entry& entry = m_entries[index];
+	if (entry.oversized) {
+		eraseIndex(m_oversized, index);
+		return;
+	}
+
+	for (int cy = entry.cy0; cy <= entry.cy1; cy++) {
+		for (int cx = entry.cx0; cx <= entry.cx1; cx++) {
+			auto pos = m_cells.find(cellKey(cx, cy));
+			if (pos == m_cells.end()) continue;
+
+			eraseIndex(pos->second, index);
+			if (pos->second.empty()) m_cells.erase(pos);
+		}
+	}
+}
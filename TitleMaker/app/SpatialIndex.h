@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Shape.h"
+
+// Sparse uniform grid over the rotated bounds of the scene's shapes, in canvas (virtual) space.
+// Entries are only re-binned when a shape's bounds or rotation actually change.
+class SpatialIndex {
+public:
+	SpatialIndex(float cellSize = 128.0f) : m_cellSize(cellSize) {}
+
+	void update(const ShapeList& shapes);
+	void clear();
+
+	// top-most (last drawn) shape under the point, or nullptr
+	Shape* pick(Point p, float tolerance = 0.0f) const;
+
+	// every shape whose rotated bounds intersect the area, in draw order
+	void query(Rect area, std::vector<Shape*>& out) const;
+
+	// draw order of the shape in the last updated list, or -1 if it isn't indexed
+	int64_t order(const Shape* shape) const;
+
+	size_t size() const { return m_lookup.size(); }
+
+	static bool containsPoint(const Shape& shape, Point p, float tolerance = 0.0f);
+	static Rect rotatedBounds(const Shape& shape);
+
+private:
+	using CellKey = uint64_t;
+
+	struct Entry {
+		Shape* shape{ nullptr };
+		Rect bounds{};
+		float rotation{ 0.0f };
+		Rect aabb{};
+		int cx0{ 0 }, cy0{ 0 }, cx1{ 0 }, cy1{ 0 };
+		size_t order{ 0 };
+		uint32_t stamp{ 0 };
+		bool oversized{ false };
+	};
+
+	float m_cellSize;
+	uint32_t m_stamp{ 0 };
+
+	std::vector<Entry> m_entries;
+	std::vector<uint32_t> m_freeEntries;
+	std::vector<uint32_t> m_oversized;
+	std::unordered_map<const Shape*, uint32_t> m_lookup;
+	std::unordered_map<CellKey, std::vector<uint32_t>> m_cells;
+
+	static CellKey cellKey(int cx, int cy) {
+		return (CellKey(uint32_t(cx)) << 32) | CellKey(uint32_t(cy));
+	}
+
+	int cellCoord(float v) const;
+
+	void insert(uint32_t index);
+	void remove(uint32_t index);
+	void refresh(uint32_t index);
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+using FrameIndex = int64_t;
+
+// Rational frame rate (num / den frames per second), e.g. 30/1 or 30000/1001.
+// Animation time is counted in whole frames on this base so frame N always maps to the
+// exact same instant, no matter how many frames were evaluated before it.
+struct Timebase {
+	int64_t num{ 30 };
+	int64_t den{ 1 };
+
+	double rate() const { return double(num) / double(den); }
+	double frameDuration() const { return double(den) / double(num); }
+
+	// the instant frame starts at, computed from the index and never accumulated
+	double seconds(FrameIndex frame) const {
+		return double(frame * den) / double(num);
+	}
+
+	// nearest frame to a duration or instant given in seconds (authoring values)
+	FrameIndex frames(double secs) const {
+		return FrameIndex(::llround(secs * double(num) / double(den)));
+	}
+};
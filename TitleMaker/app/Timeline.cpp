@@ -0,0 +1,282 @@
+#include "Timeline.h"
+
+#include <algorithm>
+
+#include "Animation.h"
+
+constexpr float keyTimeEpsilon = 1e-4f;
+
+template <typename K>
+static void insertKey(std::vector<K>& keys, K key) {
+	auto pos = std::lower_bound(
+		keys.begin(), keys.end(), key.time,
+		[](const K& k, float t) { return k.time < t - keyTimeEpsilon; }
+	);
+
+	if (pos != keys.end() && ::fabsf(pos->time - key.time) <= keyTimeEpsilon) {
+		*pos = std::move(key);
+	}
+	else {
+		keys.insert(pos, std::move(key));
+	}
+}
+
+// Finds the key the segment containing `time` starts at. The cursor of the previous
+// evaluation is tried first (and its successor, for regular playback) before falling
+// back to a binary search, so seeking anywhere is O(log k).
+template <typename K>
+static uint32_t findSegment(const K* keys, uint32_t count, uint32_t cursor, float time) {
+	auto inside = [&](uint32_t i) {
+		return keys[i].time <= time && (i + 1 >= count || time < keys[i + 1].time);
+	};
+
+	if (cursor < count && inside(cursor)) return cursor;
+	if (cursor + 1 < count && inside(cursor + 1)) return cursor + 1;
+
+	auto pos = std::upper_bound(
+		keys, keys + count, time,
+		[](float t, const K& k) { return t < k.time; }
+	);
+	return pos == keys ? 0 : uint32_t(pos - keys) - 1;
+}
+
+static float sample(const Keyframe* keys, uint32_t count, uint32_t& cursor, float time) {
+	if (time <= keys[0].time) {
+		cursor = 0;
+		return keys[0].value;
+	}
+	if (time >= keys[count - 1].time) {
+		cursor = count - 1;
+		return keys[count - 1].value;
+	}
+
+	cursor = findSegment(keys, count, cursor, time);
+
+	const Keyframe& a = keys[cursor];
+	const Keyframe& b = keys[cursor + 1];
+	float t = (time - a.time) / (b.time - a.time);
+
+	t = easings::evaluateFast(a.easing, t);
+	return a.value + (b.value - a.value) * t;
+}
+
+void Timeline::setKey(Shape* target, TrackProperty property, float time, float value, EasingType easing) {
+	if (!supports(target, property)) return;
+
+	insertKey(track(target, property).keys, Keyframe{ time, value, easing });
+	m_keysChanged = true;
+}
+
+void Timeline::setTextKey(Text* target, float time, const std::string& text) {
+	auto pos = std::find_if(m_textTracks.begin(), m_textTracks.end(), [target](const TextTrack& t) { return t.target == target; });
+	if (pos == m_textTracks.end()) {
+		m_textTracks.push_back(TextTrack{ .target = target });
+		pos = m_textTracks.end() - 1;
+	}
+
+	insertKey(pos->keys, TextKeyframe{ time, text });
+	m_keysChanged = true;
+}
+
+void Timeline::keyShape(Shape* target, float time, EasingType easing) {
+	for (size_t i = 0; i < size_t(TrackProperty::Count); i++) {
+		auto property = TrackProperty(i);
+		if (!supports(target, property)) continue;
+		setKey(target, property, time, read(target, property), easing);
+	}
+
+	if (auto text = dynamic_cast<Text*>(target)) {
+		setTextKey(text, time, text->text);
+	}
+}
+
+void Timeline::removeKeys(Shape* target, float time) {
+	auto atTime = [time](const auto& k) { return ::fabsf(k.time - time) <= keyTimeEpsilon; };
+
+	for (auto&& track : m_tracks) {
+		if (track.target != target) continue;
+		std::erase_if(track.keys, atTime);
+	}
+	for (auto&& track : m_textTracks) {
+		if (track.target != target) continue;
+		std::erase_if(track.keys, atTime);
+	}
+
+	std::erase_if(m_tracks, [](const Track& t) { return t.keys.empty(); });
+	std::erase_if(m_textTracks, [](const TextTrack& t) { return t.keys.empty(); });
+	m_keysChanged = true;
+}
+
+void Timeline::removeShape(Shape* target) {
+	std::erase_if(m_tracks, [target](const Track& t) { return t.target == target; });
+	std::erase_if(m_textTracks, [target](const TextTrack& t) { return t.target == target; });
+	m_keysChanged = true;
+}
+
+bool Timeline::hasKeys(const Shape* target) const {
+	return std::any_of(m_tracks.begin(), m_tracks.end(), [target](const Track& t) { return t.target == target; }) ||
+		std::any_of(m_textTracks.begin(), m_textTracks.end(), [target](const TextTrack& t) { return t.target == target; });
+}
+
+void Timeline::setTimebase(const Timebase& timebase) {
+	// keep the play head at the same instant
+	float time = this->time();
+	m_timebase = timebase;
+	seek(time);
+	m_timeChanged = true;
+}
+
+void Timeline::seek(float time) {
+	seekFrame(m_timebase.frames(std::max(time, 0.0f)));
+}
+
+void Timeline::seekFrame(FrameIndex frame) {
+	frame = std::max<FrameIndex>(frame, 0);
+	if (frame == m_frame) return;
+	m_frame = frame;
+	m_timeChanged = true;
+}
+
+void Timeline::advance(FrameIndex frames) {
+	if (!m_playing) return;
+
+	FrameIndex end = m_timebase.frames(duration());
+	seekFrame(m_frame + frames);
+	if (m_frame >= end) {
+		seekFrame(end);
+		m_playing = false;
+	}
+}
+
+void Timeline::play() {
+	if (m_frame >= m_timebase.frames(duration())) seekFrame(0);
+	m_playing = true;
+}
+
+float Timeline::duration() const {
+	float end = 0.0f;
+	for (auto&& track : m_tracks) {
+		end = std::max(end, track.keys.back().time);
+	}
+	for (auto&& track : m_textTracks) {
+		end = std::max(end, track.keys.back().time);
+	}
+	return end;
+}
+
+bool Timeline::evaluate() {
+	if (!m_timeChanged && !m_keysChanged) return false;
+
+	if (m_keysChanged) bake();
+	m_timeChanged = false;
+	m_keysChanged = false;
+
+	const size_t count = m_baked.size();
+	const Keyframe* keys = m_bakedKeys.data();
+	const float time = this->time();
+
+	// sample everything first, then scatter the results into the shapes
+	for (size_t i = 0; i < count; i++) {
+		BakedTrack& track = m_baked[i];
+		m_values[i] = sample(keys + track.first, track.count, track.cursor, time);
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		write(m_baked[i].target, m_baked[i].property, m_values[i]);
+	}
+
+	for (auto&& track : m_textTracks) {
+		if (time < track.keys[0].time) continue;
+
+		track.cursor = findSegment(track.keys.data(), uint32_t(track.keys.size()), track.cursor, time);
+		const auto& text = track.keys[track.cursor].text;
+		if (track.target->text != text) track.target->text = text;
+	}
+
+	return true;
+}
+
+bool Timeline::supports(const Shape* target, TrackProperty property) {
+	if (property < TrackProperty::FillR) return true;
+	if (property == TrackProperty::FontSize) return dynamic_cast<const Text*>(target) != nullptr;
+	return dynamic_cast<const ColoredShape*>(target) != nullptr;
+}
+
+static float* propertyField(Shape* target, TrackProperty property) {
+	switch (property) {
+		case TrackProperty::PositionX: return &target->bounds.x;
+		case TrackProperty::PositionY: return &target->bounds.y;
+		case TrackProperty::Width: return &target->bounds.width;
+		case TrackProperty::Height: return &target->bounds.height;
+		case TrackProperty::Rotation: return &target->rotation;
+		default: break;
+	}
+
+	if (property == TrackProperty::FontSize) {
+		return &static_cast<Text*>(target)->fontSize;
+	}
+
+	auto colored = static_cast<ColoredShape*>(target);
+	size_t index = size_t(property) - size_t(TrackProperty::FillR);
+	switch (property) {
+		case TrackProperty::FillR:
+		case TrackProperty::FillG:
+		case TrackProperty::FillB:
+		case TrackProperty::FillA:
+			return &colored->background.color[0][index];
+		case TrackProperty::Fill2R:
+		case TrackProperty::Fill2G:
+		case TrackProperty::Fill2B:
+		case TrackProperty::Fill2A:
+			return &colored->background.color[1][index - 4];
+		case TrackProperty::BorderR:
+		case TrackProperty::BorderG:
+		case TrackProperty::BorderB:
+		case TrackProperty::BorderA:
+			return &colored->borderColor[index - 8];
+		case TrackProperty::BorderWidth: return &colored->borderWidth;
+		default: return nullptr;
+	}
+}
+
+float Timeline::read(const Shape* target, TrackProperty property) {
+	return *propertyField(const_cast<Shape*>(target), property);
+}
+
+void Timeline::write(Shape* target, TrackProperty property, float value) {
+	*propertyField(target, property) = value;
+}
+
+Timeline::Track& Timeline::track(Shape* target, TrackProperty property) {
+	auto pos = std::find_if(m_tracks.begin(), m_tracks.end(), [=](const Track& t) {
+		return t.target == target && t.property == property;
+	});
+	if (pos != m_tracks.end()) return *pos;
+
+	m_tracks.push_back(Track{ .target = target, .property = property });
+	return m_tracks.back();
+}
+
+void Timeline::bake() {
+	// group the tracks by shape so the write pass touches each shape once, in order
+	std::sort(m_tracks.begin(), m_tracks.end(), [](const Track& a, const Track& b) {
+		if (a.target != b.target) return a.target < b.target;
+		return a.property < b.property;
+	});
+
+	m_baked.clear();
+	m_bakedKeys.clear();
+
+	for (auto&& track : m_tracks) {
+		m_baked.push_back(BakedTrack{
+			.target = track.target,
+			.first = uint32_t(m_bakedKeys.size()),
+			.count = uint32_t(track.keys.size()),
+			.cursor = 0,
+			.property = track.property
+		});
+		m_bakedKeys.insert(m_bakedKeys.end(), track.keys.begin(), track.keys.end());
+	}
+
+	m_values.resize(m_baked.size());
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Easing.h"
+#include "Shape.h"
+#include "Timebase.h"
+
+enum class TrackProperty : uint8_t {
+	PositionX = 0,
+	PositionY,
+	Width,
+	Height,
+	Rotation,
+	// ColoredShape only
+	FillR, FillG, FillB, FillA,
+	Fill2R, Fill2G, Fill2B, Fill2A,
+	BorderR, BorderG, BorderB, BorderA,
+	BorderWidth,
+	// Text only
+	FontSize,
+	Count
+};
+
+struct Keyframe {
+	float time{ 0.0f };
+	float value{ 0.0f };
+	// easing of the segment starting at this key, Hold keeps the value until the next key
+	EasingType easing{ EasingType::Linear };
+};
+
+struct TextKeyframe {
+	float time{ 0.0f };
+	std::string text;
+};
+
+class Timeline {
+public:
+	void setKey(Shape* target, TrackProperty property, float time, float value, EasingType easing = EasingType::Linear);
+	void setTextKey(Text* target, float time, const std::string& text);
+
+	// keys every property the shape supports with its current value
+	void keyShape(Shape* target, float time, EasingType easing = EasingType::Linear);
+	void removeKeys(Shape* target, float time);
+	void removeShape(Shape* target);
+	bool hasKeys(const Shape* target) const;
+
+	// the play head sits on whole frames of the timebase, key times stay in seconds
+	void setTimebase(const Timebase& timebase);
+	const Timebase& timebase() const { return m_timebase; }
+
+	void seek(float time);
+	void seekFrame(FrameIndex frame);
+	void advance(FrameIndex frames = 1);
+
+	void play();
+	void pause() { m_playing = false; }
+	bool playing() const { return m_playing; }
+
+	FrameIndex frame() const { return m_frame; }
+	float time() const { return float(m_timebase.seconds(m_frame)); }
+	float duration() const;
+
+	// samples every track at the current time and writes the values into the shapes.
+	// does nothing (and returns false) when neither the time nor the keys changed.
+	bool evaluate();
+
+	static bool supports(const Shape* target, TrackProperty property);
+	static float read(const Shape* target, TrackProperty property);
+	static void write(Shape* target, TrackProperty property, float value);
+
+private:
+	struct Track {
+		Shape* target{ nullptr };
+		TrackProperty property{ TrackProperty::PositionX };
+		std::vector<Keyframe> keys;
+	};
+
+	struct TextTrack {
+		Text* target{ nullptr };
+		std::vector<TextKeyframe> keys;
+		uint32_t cursor{ 0 };
+	};
+
+	// packed, evaluation-only copy of m_tracks
+	struct BakedTrack {
+		Shape* target;
+		uint32_t first, count, cursor;
+		TrackProperty property;
+	};
+
+	std::vector<Track> m_tracks;
+	std::vector<TextTrack> m_textTracks;
+
+	std::vector<BakedTrack> m_baked;
+	std::vector<Keyframe> m_bakedKeys;
+	std::vector<float> m_values;
+
+	Timebase m_timebase{};
+	FrameIndex m_frame{ 0 };
+	bool m_playing{ false };
+	bool m_timeChanged{ true };
+	bool m_keysChanged{ true };
+
+	Track& track(Shape* target, TrackProperty property);
+	void bake();
+};
@@ -0,0 +1,74 @@
+#include "WorkerPool.h"
+
+#include "../../QuickGUI/quickgui/Profiler.h"
+
+WorkerPool::WorkerPool(size_t threads, std::string name) {
+	// reserved up front, the threads hold on to the c strings
+	m_names.reserve(threads);
+	m_threads.reserve(threads);
+	for (size_t i = 0; i < threads; i++) {
+		m_names.push_back(name + " " + std::to_string(i + 1));
+		m_threads.emplace_back(&WorkerPool::workerLoop, this, i);
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		std::lock_guard lock(m_mutex);
+		m_exit = true;
+	}
+	m_wake.notify_all();
+
+	for (auto&& thread : m_threads) thread.join();
+}
+
+void WorkerPool::parallelFor(size_t count, const std::function<void(size_t)>& job) {
+	if (m_threads.empty() || count <= 1) {
+		for (size_t i = 0; i < count; i++) job(i);
+		return;
+	}
+
+	{
+		std::lock_guard lock(m_mutex);
+		m_job = &job;
+		m_count = count;
+		m_next.store(0, std::memory_order_relaxed);
+		m_busy = m_threads.size();
+		m_generation++;
+	}
+	m_wake.notify_all();
+
+	runJobs();
+
+	// every worker checks in, even the ones that found nothing left to take
+	std::unique_lock lock(m_mutex);
+	m_done.wait(lock, [this] { return m_busy == 0; });
+	m_job = nullptr;
+}
+
+void WorkerPool::workerLoop(size_t index) {
+	Profiler::setThreadName(m_names[index].c_str());
+
+	uint64_t seen = 0;
+	for (;;) {
+		{
+			std::unique_lock lock(m_mutex);
+			m_wake.wait(lock, [&] { return m_exit || m_generation != seen; });
+			if (m_exit) return;
+			seen = m_generation;
+		}
+
+		runJobs();
+
+		std::lock_guard lock(m_mutex);
+		if (--m_busy == 0) m_done.notify_one();
+	}
+}
+
+void WorkerPool::runJobs() {
+	for (;;) {
+		size_t i = m_next.fetch_add(1, std::memory_order_relaxed);
+		if (i >= m_count) break;
+		(*m_job)(i);
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A fixed set of threads that run the jobs of one parallelFor at a time. The calling thread
+// takes jobs too, so a pool without threads simply runs everything inline.
+class WorkerPool {
+public:
+	WorkerPool(size_t threads, std::string name);
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	size_t threadCount() const { return m_threads.size(); }
+
+	// calls job(0) .. job(count - 1) spread over the pool and returns once all of them are done
+	void parallelFor(size_t count, const std::function<void(size_t)>& job);
+
+private:
+	void workerLoop(size_t index);
+	void runJobs();
+
+	std::vector<std::thread> m_threads;
+	std::vector<std::string> m_names; // the profiler keeps the pointers
+
+	std::mutex m_mutex;
+	std::condition_variable m_wake, m_done;
+	uint64_t m_generation{ 0 };
+	size_t m_busy{ 0 };
+	bool m_exit{ false };
+
+	const std::function<void(size_t)>* m_job{ nullptr };
+	size_t m_count{ 0 };
+	std::atomic<size_t> m_next{ 0 };
+};